@@ -109,6 +109,11 @@ public:
   virtual void ClearUsedBankRids() {}
   virtual  void SetMaxInsertTime(const PHTimeStamp &tMax) {}
 
+  // local calibration cache, offline mode never goes to the database
+  virtual int UseCalibrationCache(const std::string &filename, const bool offline = false) {return -1;}
+  // copy all banks of a table valid for the given run into the cache
+  virtual int prefetchBanks(const std::string &bankName, const int runNumber) {return -1;}
+
 protected:
 
   static  PdbBankManager *__instance; 
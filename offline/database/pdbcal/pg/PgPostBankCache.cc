@@ -0,0 +1,263 @@
+#include "PgPostBankCache.h"
+#include "PgPostBankBackupStorage.h"
+#include "PgPostBankWrapper.h"
+#include "PgPostCalBank.h"
+
+#include <pdbcalbase/PdbCalBank.h>
+
+#include <phool/phool.h>
+
+#include <TFile.h>
+#include <TKey.h>
+#include <TList.h>
+#include <TNamed.h>
+
+#include <cstdlib>
+#include <sstream>
+
+using namespace std;
+
+static const string RUNPREFIX = "runbegin_";
+
+PgPostBankCache::PgPostBankCache(const string &fname, const bool offl):
+  filename(fname),
+  offline(offl),
+  cachefile(0),
+  nhits(0),
+  nmisses(0),
+  nstored(0)
+{
+  TDirectory *save = gDirectory;
+  cachefile = TFile::Open(filename.c_str(), (offline ? "READ" : "UPDATE"));
+  if (!cachefile || cachefile->IsZombie())
+    {
+      cout << PHWHERE << " Cannot open calibration cache " << filename
+	   << (offline ? " for reading" : " for update") << endl;
+      delete cachefile;
+      cachefile = 0;
+    }
+  else
+    {
+      BuildIndex();
+    }
+  gDirectory = save;
+}
+
+PgPostBankCache::~PgPostBankCache()
+{
+  if (cachefile)
+    {
+      cachefile->Close();
+      delete cachefile;
+    }
+}
+
+void
+PgPostBankCache::BuildIndex()
+{
+  // everything needed for the lookup is in the key titles, the banks
+  // themselves are only read when they are requested
+  TIter next(cachefile->GetListOfKeys());
+  TKey *key;
+  while ((key = static_cast<TKey *>(next())))
+    {
+      string keyname = key->GetName();
+      if (keyname.compare(0, RUNPREFIX.size(), RUNPREFIX) == 0)
+	{
+	  int runnumber = atoi(keyname.substr(RUNPREFIX.size()).c_str());
+	  runbegin[runnumber] = atol(key->GetTitle());
+	  continue;
+	}
+      if (string(key->GetClassName()) != "PgPostBankBackupStorage")
+	{
+	  continue;
+	}
+      istringstream title(key->GetTitle());
+      string bankName;
+      int bankID;
+      CacheEntry entry;
+      title >> bankName >> bankID >> entry.startValTime >> entry.endValTime
+	    >> entry.insertTime >> entry.rid;
+      if (title.fail())
+	{
+	  cout << PHWHERE << " ignoring malformed cache entry " << keyname
+	       << " in " << filename << endl;
+	  continue;
+	}
+      entry.keyname = keyname;
+      bankindex[make_pair(bankName, bankID)].push_back(entry);
+    }
+  return;
+}
+
+PgPostCalBank *
+PgPostBankCache::fetchBank(const string &bankName, const int bankID,
+			   const PHTimeStamp &searchTime, const PHTimeStamp &tMaxInsert,
+			   int &rid)
+{
+  if (!cachefile)
+    {
+      return 0;
+    }
+  map<pair<string, int>, vector<CacheEntry> >::const_iterator iter = bankindex.find(make_pair(bankName, bankID));
+  if (iter == bankindex.end())
+    {
+      nmisses++;
+      return 0;
+    }
+  // same selection as the database query: valid at the search time, latest
+  // insert time not after the max insert time, highest rid among those
+  time_t sT = searchTime.getTics();
+  time_t maxinsert = tMaxInsert.getTics();
+  const CacheEntry *best = 0;
+  for (vector<CacheEntry>::const_iterator eiter = iter->second.begin(); eiter != iter->second.end(); ++eiter)
+    {
+      if (eiter->startValTime > sT || eiter->endValTime <= sT || eiter->insertTime > maxinsert)
+	{
+	  continue;
+	}
+      if (!best ||
+	  eiter->insertTime > best->insertTime ||
+	  (eiter->insertTime == best->insertTime && eiter->rid > best->rid))
+	{
+	  best = &(*eiter);
+	}
+    }
+  if (!best)
+    {
+      nmisses++;
+      return 0;
+    }
+  PgPostBankBackupStorage *bs = dynamic_cast<PgPostBankBackupStorage *>(cachefile->Get(best->keyname.c_str()));
+  if (!bs)
+    {
+      cout << PHWHERE << " cannot read " << best->keyname << " from " << filename << endl;
+      nmisses++;
+      return 0;
+    }
+  PgPostCalBank *bw = bs->createBank();
+  delete bs;
+  if (bw)
+    {
+      rid = best->rid;
+      nhits++;
+    }
+  else
+    {
+      nmisses++;
+    }
+  return bw;
+}
+
+int
+PgPostBankCache::storeBank(PgPostBankWrapper *bw, const int rid)
+{
+  if (!cachefile || offline)
+    {
+      return -1;
+    }
+  string bankName = bw->getTableName();
+  int bankID = bw->getBankID().getInternalValue();
+  time_t startValTime = bw->getStartValTime().getTics();
+  time_t endValTime = bw->getEndValTime().getTics();
+  time_t insertTime = bw->getInsertTime().getTics();
+
+  // the key is the content address of the database row
+  ostringstream keyname;
+  keyname << bankName << "_" << bankID << "_" << startValTime << "_"
+	  << endValTime << "_" << insertTime << "_" << rid;
+  vector<CacheEntry> &entries = bankindex[make_pair(bankName, bankID)];
+  for (vector<CacheEntry>::const_iterator iter = entries.begin(); iter != entries.end(); ++iter)
+    {
+      if (iter->keyname == keyname.str())
+	{
+	  return 0;
+	}
+    }
+
+  PgPostBankBackupStorage *bs = new PgPostBankBackupStorage(static_cast<PdbCalBank *>(bw->getBank()->Clone()));
+  PgPostBankBackupStorage::BankHeader &header = bs->get_database_header();
+  header.setBankID(bankID);
+  header.setInsertTime(bw->getInsertTime());
+  header.setStartValTime(bw->getStartValTime());
+  header.setEndValTime(bw->getEndValTime());
+  header.setDescription(bw->getDescription());
+  header.setUserName(bw->getUserName());
+  header.setTableName(bankName);
+  header.setRId(rid);
+  bs->set_obj_info(bw);
+
+  ostringstream title;
+  title << bankName << " " << bankID << " " << startValTime << " "
+	<< endValTime << " " << insertTime << " " << rid;
+  bs->SetName(keyname.str().c_str());
+  bs->SetTitle(title.str().c_str());
+  cachefile->WriteTObject(bs, bs->GetName());
+  delete bs;
+
+  CacheEntry entry;
+  entry.startValTime = startValTime;
+  entry.endValTime = endValTime;
+  entry.insertTime = insertTime;
+  entry.rid = rid;
+  entry.keyname = keyname.str();
+  entries.push_back(entry);
+  nstored++;
+  Save();
+  return 1;
+}
+
+bool
+PgPostBankCache::getRunBeginTime(const int runNumber, PHTimeStamp &beginTime) const
+{
+  map<int, time_t>::const_iterator iter = runbegin.find(runNumber);
+  if (iter == runbegin.end())
+    {
+      return false;
+    }
+  beginTime = PHTimeStamp(iter->second);
+  return true;
+}
+
+void
+PgPostBankCache::storeRunBeginTime(const int runNumber, const PHTimeStamp &beginTime)
+{
+  if (!cachefile || offline || runbegin.find(runNumber) != runbegin.end())
+    {
+      return;
+    }
+  ostringstream name;
+  ostringstream tics;
+  name << RUNPREFIX << runNumber;
+  tics << beginTime.getTics();
+  TNamed runentry(name.str().c_str(), tics.str().c_str());
+  cachefile->WriteTObject(&runentry, runentry.GetName());
+  runbegin[runNumber] = beginTime.getTics();
+  Save();
+  return;
+}
+
+void
+PgPostBankCache::Save()
+{
+  // write the key list right away, a job which crashes later on should
+  // not lose what it has fetched so far
+  cachefile->SaveSelf(kTRUE);
+  cachefile->Flush();
+  return;
+}
+
+void
+PgPostBankCache::Print(ostream &os) const
+{
+  unsigned int nbanks = 0;
+  for (map<pair<string, int>, vector<CacheEntry> >::const_iterator iter = bankindex.begin(); iter != bankindex.end(); ++iter)
+    {
+      nbanks += iter->second.size();
+    }
+  os << "Calibration cache " << filename << (offline ? " (offline)" : "")
+     << ": " << nbanks << " banks, " << runbegin.size() << " runs, "
+     << nhits << " hits, " << nmisses << " misses, "
+     << nstored << " banks stored" << endl;
+  return;
+}
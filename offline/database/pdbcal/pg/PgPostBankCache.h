@@ -0,0 +1,73 @@
+#ifndef PGPOSTBANKCACHE_HH__
+#define PGPOSTBANKCACHE_HH__
+
+#include <phool/PHTimeStamp.h>
+
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+class PgPostBankWrapper;
+class PgPostCalBank;
+class TFile;
+
+// local, persistent copy of calibration banks in a root file. Every database
+// row is stored once as PgPostBankBackupStorage under a key built from
+// bank name, bankID, validity range, insert time and rid, so the key list
+// alone is enough to answer a query the same way the database would
+// (startvaltime <= t < endvaltime, latest inserttime <= max insert time,
+// highest rid). Run begin times are cached as well, so in offline mode
+// neither the calibration nor the run tables are touched.
+// The file is updated in place, farm jobs should prefetch into it once and
+// then open it in offline (read only) mode
+class PgPostBankCache
+{
+ public:
+  PgPostBankCache(const std::string &filename, const bool offline = false);
+  virtual ~PgPostBankCache();
+
+  bool isOpen() const {return (cachefile != 0);}
+  bool isOffline() const {return offline;}
+
+  //! returns 0 if no valid bank is cached, the rid of the cached database
+  //! row is returned in rid. User code owns the returned bank
+  PgPostCalBank *fetchBank(const std::string &bankName, const int bankID,
+			   const PHTimeStamp &searchTime, const PHTimeStamp &tMaxInsert,
+			   int &rid);
+
+  //! returns 1 if the bank was written, 0 if it was cached already, -1 on error
+  int storeBank(PgPostBankWrapper *bw, const int rid);
+
+  bool getRunBeginTime(const int runNumber, PHTimeStamp &beginTime) const;
+  void storeRunBeginTime(const int runNumber, const PHTimeStamp &beginTime);
+
+  void Print(std::ostream &os = std::cout) const;
+
+ private:
+  struct CacheEntry
+  {
+    time_t startValTime;
+    time_t endValTime;
+    time_t insertTime;
+    int rid;
+    std::string keyname;
+  };
+
+  void BuildIndex();
+  void Save();
+
+  std::string filename;
+  bool offline;
+  TFile *cachefile;
+  std::map<std::pair<std::string, int>, std::vector<CacheEntry> > bankindex;
+  std::map<int, time_t> runbegin;
+
+  unsigned int nhits;
+  unsigned int nmisses;
+  unsigned int nstored;
+};
+
+#endif /* PGPOSTBANKCACHE_HH__ */
@@ -1,4 +1,5 @@
 #include "PgPostBankManager.h"
+#include "PgPostBankCache.h"
 #include "PgPostCalBankIterator.h"
 #include "PgPostBankWrapper.h"
 #include "PgPostApplication.h"
@@ -63,7 +64,8 @@ int PgPostBankManager::Register()
 
 
 
-PgPostBankManager::PgPostBankManager()
+PgPostBankManager::PgPostBankManager():
+  bankcache(0)
 {
   tMaxInsertTime.setToFarFuture();
 #ifdef DEBUG
@@ -73,6 +75,7 @@ PgPostBankManager::PgPostBankManager()
 
 PgPostBankManager::~PgPostBankManager()
 {
+  delete bankcache;
   mySpecificCopy = 0;
 }
 
@@ -184,9 +187,7 @@ PgPostBankManager::createBank(const string &className, PdbBankID bankID, const s
 PdbCalBank* 
 PgPostBankManager::fetchBank(const string &className, PdbBankID bankID, const string &bankName, const int runNumber)
 {
-  RunToTime *runTime = RunToTime::instance();
-
-  PHTimeStamp *runBeginTime = runTime->getBeginTime(runNumber);
+  PHTimeStamp *runBeginTime = getRunBeginTime(runNumber);
   if (runBeginTime != 0)
     {
       PHTimeStamp searchTime = *(runBeginTime);
@@ -200,9 +201,7 @@ PgPostBankManager::fetchBank(const string &className, PdbBankID bankID, const st
 PdbCalBank* 
 PgPostBankManager::fetchClosestBank(const string &className, PdbBankID bankID, const string &bankName, const int runNumber)
 {
-  RunToTime *runTime = RunToTime::instance();
-
-  PHTimeStamp *runBeginTime = runTime->getBeginTime(runNumber);
+  PHTimeStamp *runBeginTime = getRunBeginTime(runNumber);
   if (runBeginTime != 0)
     {
       PHTimeStamp searchTime = *(runBeginTime);
@@ -248,6 +247,33 @@ PdbCalBank* PgPostBankManager::fetchBank(const string &className, PdbBankID bank
   cout << "Fetching " << className << " from " << bankName << endl;
 #endif
 
+  if (bankcache)
+    {
+      int rid;
+      PdbCalBank *bank = bankcache->fetchBank(bankName, bankID.getInternalValue(), searchTime, tMaxInsertTime, rid);
+      // only offline jobs trust the cache blindly, otherwise a newer bank
+      // may have been inserted since it was stored. The rid of the row the
+      // database would pick is cheap to get, the bank itself is only
+      // transferred if it is not the cached one
+      if (bank && !bankcache->isOffline() && getDatabaseRid(bankName, bankID, searchTime) != rid)
+	{
+	  delete bank;
+	  bank = 0;
+	}
+      if (bank)
+	{
+	  BankRid[bankName].insert(rid);
+	  return bank;
+	}
+      if (bankcache->isOffline())
+	{
+	  std::cerr << PHWHERE << "NO Bank " << bankName << " with bankID "
+		    << bankID.getInternalValue() << " for " << searchTime
+		    << " in offline calibration cache" << std::endl;
+	  return 0;
+	}
+    }
+
   PgPostApplication* ap = PgPostApplication::instance();
   if (!ap)
     {
@@ -263,47 +289,24 @@ PdbCalBank* PgPostBankManager::fetchBank(const string &className, PdbBankID bank
     }
 
   TSQLStatement *stmt = con->CreateStatement();
-  time_t sT = searchTime.getTics();
-  std::ostringstream tem;
-  std::ostringstream t2;
-
-  // cout << bankID.getInternalValue() << endl;
-  t2 << "select * from " << bankName
-     << " where bankID = " << bankID.getInternalValue()
-     << " and startvaltime <= " << sT
-     << " and endvaltime > " << sT;
-
-
-  tem << "select * from ("
-      << t2.str()
-      << ") as foo where inserttime = "
-      << "(select max(inserttime) from ("
-      << t2.str()
-      << " and inserttime <= "
-      << tMaxInsertTime.getTics() 
-      << ") as foobar)"
-      << " order by rid desc";
+  std::string tem = bankQuery("*", bankName, bankID, searchTime);
 
 #ifdef DEBUG
-  cout << "exe : " << tem.str() << endl;
+  cout << "exe : " << tem << endl;
 #endif
 
-  std::auto_ptr<TSQLResultSet> rs(stmt->ExecuteQuery(tem.str().c_str()));  
+  std::auto_ptr<TSQLResultSet> rs(stmt->ExecuteQuery(tem.c_str()));  
   if( (&*rs) && rs->Next())
   {
-    PdbCalBank *bank = (PdbCalBank *)(rs->GetObject(7));
-    PgPostBankWrapper* bw = new PgPostBankWrapper(bank);
-    bw->setBankID(rs->GetInt(1));
-    bw->setInsertTime(rs->GetLong(2));
-    bw->setStartValTime(rs->GetLong(3));
-    bw->setEndValTime(rs->GetLong(4));
-    bw->setDescription(string(rs->GetString(5)));
-    bw->setUserName(string(rs->GetString(6)));
-    bw->setTableName(bankName);
+    PgPostBankWrapper* bw = ResultSetToWrapper(&*rs, bankName);
     #ifdef DEBUG
     bw->printHeader();
     #endif
     int rid = rs->GetInt("rid");
+    if (bankcache)
+      {
+	bankcache->storeBank(bw, rid);
+      }
     
     // insert new id in bank list matching name
     /*
@@ -314,11 +317,64 @@ PdbCalBank* PgPostBankManager::fetchBank(const string &className, PdbBankID bank
     return bw;
     
   } else {
-    std::cerr << PHWHERE << "NO Bank found : " << tem.str() << std::endl;
+    std::cerr << PHWHERE << "NO Bank found : " << tem << std::endl;
     return 0;
   }
 }
 
+//__________________________________________________________________________________
+string
+PgPostBankManager::bankQuery(const string &columns, const string &bankName, PdbBankID bankID, const PHTimeStamp &searchTime) const
+{
+  time_t sT = searchTime.getTics();
+  std::ostringstream tem;
+  std::ostringstream t2;
+
+  t2 << "select * from " << bankName
+     << " where bankID = " << bankID.getInternalValue()
+     << " and startvaltime <= " << sT
+     << " and endvaltime > " << sT;
+
+  tem << "select " << columns << " from ("
+      << t2.str()
+      << ") as foo where inserttime = "
+      << "(select max(inserttime) from ("
+      << t2.str()
+      << " and inserttime <= "
+      << tMaxInsertTime.getTics() 
+      << ") as foobar)"
+      << " order by rid desc";
+  return tem.str();
+}
+
+//__________________________________________________________________________________
+int
+PgPostBankManager::getDatabaseRid(const string &bankName, PdbBankID bankID, const PHTimeStamp &searchTime) const
+{
+  PgPostApplication* ap = PgPostApplication::instance();
+  if (!ap)
+    {
+      cout << PHWHERE << " PgPostApplication instance is NULL, exiting" << endl;
+      exit(1);
+    }
+
+  TSQLConnection *con = ap->getConnection();
+  if (!con)
+    {
+      cout << PHWHERE << " Cannot get TSQLConnection, exiting" << endl;
+      exit(1);
+    }
+
+  TSQLStatement *stmt = con->CreateStatement();
+  std::string tem = bankQuery("rid", bankName, bankID, searchTime) + " limit 1";
+  std::auto_ptr<TSQLResultSet> rs(stmt->ExecuteQuery(tem.c_str()));
+  if ((&*rs) && rs->Next())
+    {
+      return rs->GetInt(1);
+    }
+  return -1;
+}
+
 //__________________________________________________________________________________
 PdbCalBank* 
 PgPostBankManager::fetchClosestBank(const string &className, PdbBankID bankID, const string &bankName, PHTimeStamp &searchTime)
@@ -470,3 +526,132 @@ PgPostBankManager::SetMaxInsertTime(const PHTimeStamp &tMax)
   tMaxInsertTime = tMax;
  return;
 }
+
+PgPostBankWrapper *
+PgPostBankManager::ResultSetToWrapper(TSQLResultSet *rs, const string &bankName) const
+{
+  PdbCalBank *bank = (PdbCalBank *)(rs->GetObject(7));
+  PgPostBankWrapper* bw = new PgPostBankWrapper(bank);
+  bw->setBankID(rs->GetInt(1));
+  bw->setInsertTime(rs->GetLong(2));
+  bw->setStartValTime(rs->GetLong(3));
+  bw->setEndValTime(rs->GetLong(4));
+  bw->setDescription(string(rs->GetString(5)));
+  bw->setUserName(string(rs->GetString(6)));
+  bw->setTableName(bankName);
+  return bw;
+}
+
+PHTimeStamp *
+PgPostBankManager::getRunBeginTime(const int runNumber)
+{
+  PHTimeStamp beginTime;
+  if (bankcache && bankcache->getRunBeginTime(runNumber, beginTime))
+    {
+      return new PHTimeStamp(beginTime);
+    }
+  if (bankcache && bankcache->isOffline())
+    {
+      cout << PHWHERE << " run " << runNumber
+	   << " not in offline calibration cache" << endl;
+      return 0;
+    }
+  PHTimeStamp *runBeginTime = RunToTime::instance()->getBeginTime(runNumber);
+  if (runBeginTime && bankcache)
+    {
+      bankcache->storeRunBeginTime(runNumber, *runBeginTime);
+    }
+  return runBeginTime;
+}
+
+int
+PgPostBankManager::UseCalibrationCache(const string &filename, const bool offline)
+{
+  delete bankcache;
+  bankcache = new PgPostBankCache(filename, offline);
+  if (!bankcache->isOpen())
+    {
+      delete bankcache;
+      bankcache = 0;
+      return -1;
+    }
+  return 0;
+}
+
+int
+PgPostBankManager::prefetchBanks(const string &bankName, const int runNumber)
+{
+  if (!bankcache || bankcache->isOffline())
+    {
+      cout << PHWHERE << " prefetching needs a calibration cache opened for update" << endl;
+      return -1;
+    }
+  PHTimeStamp *runBeginTime = getRunBeginTime(runNumber);
+  if (!runBeginTime)
+    {
+      return -1;
+    }
+  time_t sT = runBeginTime->getTics();
+  delete runBeginTime;
+
+  PgPostApplication* ap = PgPostApplication::instance();
+  if (!ap)
+    {
+      cout << PHWHERE << " PgPostApplication instance is NULL, exiting" << endl;
+      exit(1);
+    }
+
+  TSQLConnection *con = ap->getConnection();
+  if (!con)
+    {
+      cout << PHWHERE << " Cannot get TSQLConnection, exiting" << endl;
+      exit(1);
+    }
+
+  // one query for all bankIDs, the first row of every bankID is the one
+  // fetchBank would pick
+  TSQLStatement *stmt = con->CreateStatement();
+  std::ostringstream tem;
+  tem << "select * from " << bankName
+      << " where startvaltime <= " << sT
+      << " and endvaltime > " << sT
+      << " and inserttime <= " << tMaxInsertTime.getTics()
+      << " order by bankid, inserttime desc, rid desc";
+
+  std::auto_ptr<TSQLResultSet> rs(stmt->ExecuteQuery(tem.str().c_str()));
+  if (!(&*rs))
+    {
+      std::cerr << PHWHERE << "query failed: " << tem.str() << std::endl;
+      return -1;
+    }
+  int nbanks = 0;
+  set<int> bankids;
+  while (rs->Next())
+    {
+      if (! bankids.insert(rs->GetInt(1)).second)
+	{
+	  continue;
+	}
+      PgPostBankWrapper* bw = ResultSetToWrapper(&*rs, bankName);
+      bankcache->storeBank(bw, rs->GetInt("rid"));
+      delete bw;
+      nbanks++;
+    }
+  cout << "Prefetched " << nbanks << " banks of " << bankName
+       << " for run " << runNumber << endl;
+  return nbanks;
+}
+
+void
+PgPostBankManager::PrintCacheStats() const
+{
+  if (bankcache)
+    {
+      bankcache->Print();
+    }
+  else
+    {
+      cout << "No calibration cache in use" << endl;
+    }
+  return;
+}
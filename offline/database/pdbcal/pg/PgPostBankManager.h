@@ -8,6 +8,10 @@
 #include <set>
 #include <string>
 
+class PgPostBankCache;
+class PgPostBankWrapper;
+class TSQLResultSet;
+
 class PgPostBankManager : public PdbBankManager {
 
 public:
@@ -59,11 +63,29 @@ public:
   void ClearUsedBankRids() {BankRid.clear();}
   void SetMaxInsertTime(const PHTimeStamp &tMax);
 
+  // banks (and run begin times) are looked up in this root file first and
+  // every bank fetched from the database is added to it. In offline mode
+  // the file is opened read only and the database is never queried,
+  // otherwise a cached bank is only used if the database still selects
+  // the same row (checked by rid, the bank is not transferred)
+  int UseCalibrationCache(const std::string &filename, const bool offline = false);
+  // store all banks of bankName valid at the begin of runNumber in the
+  // cache, returns the number of banks or -1 on error
+  int prefetchBanks(const std::string &bankName, const int runNumber);
+  void PrintCacheStats() const;
+
 private:
   static PgPostBankManager *mySpecificCopy;
   std::map<std::string,std::set<int> > BankRid;
   std::string getRealName(const std::string &);
+  PHTimeStamp *getRunBeginTime(const int runNumber);
+  PgPostBankWrapper *ResultSetToWrapper(TSQLResultSet *rs, const std::string &bankName) const;
+  // the query of fetchBank for the given columns of the selected rows
+  std::string bankQuery(const std::string &columns, const std::string &bankName, PdbBankID bankID, const PHTimeStamp &searchTime) const;
+  // rid of the row fetchBank would get from the database, -1 if there is none
+  int getDatabaseRid(const std::string &bankName, PdbBankID bankID, const PHTimeStamp &searchTime) const;
   PHTimeStamp tMaxInsertTime;
+  PgPostBankCache *bankcache;
 };
 
 #endif /* __PGPOSTBANKMANAGER_HH__ */
@@ -6,94 +6,328 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <ctime>
+#include <fstream>
 #include <iostream>
+#include <list>
+#include <map>
+#include <sstream>
 
 using namespace std;
 
-extern char **environ;
 static const char sep = ':';
- 
+static const string diskheader = "# GSEARCHPATH=";
+
+namespace
+{
+  // process wide state, FROG objects are created on the fly by every
+  // input manager so the cache cannot live in the object
+  struct FROGCache
+  {
+    FROGCache():
+      maxsize(10000),
+      ttl(86400),
+      hits(0),
+      misses(0),
+      diskhits(0)
+    {}
+    string searchpath; // GSEARCHPATH the cached entries belong to
+    vector<string> pathlist;
+    // most recently used first
+    list<pair<string, string> > lru;
+    map<string, list<pair<string, string> >::iterator> index;
+    unsigned int maxsize;
+    string diskfile;
+    int ttl;
+    // lfn -> (time of lookup, pfn)
+    map<string, pair<time_t, string> > disk;
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long diskhits;
+  };
+
+  FROGCache &frogcache()
+  {
+    static FROGCache cache;
+    return cache;
+  }
+}
+
+static void
+lru_insert(const string &lname, const string &pfn)
+{
+  FROGCache &cache = frogcache();
+  map<string, list<pair<string, string> >::iterator>::iterator iter = cache.index.find(lname);
+  if (iter != cache.index.end())
+    {
+      cache.lru.erase(iter->second);
+      cache.index.erase(iter);
+    }
+  cache.lru.push_front(make_pair(lname, pfn));
+  cache.index[lname] = cache.lru.begin();
+  while (cache.lru.size() > cache.maxsize)
+    {
+      cache.index.erase(cache.lru.back().first);
+      cache.lru.pop_back();
+    }
+  return;
+}
+
+static void
+disk_load()
+{
+  FROGCache &cache = frogcache();
+  cache.disk.clear();
+  if (cache.diskfile.empty())
+    {
+      return;
+    }
+  ifstream infile(cache.diskfile.c_str());
+  string line;
+  if (infile && getline(infile, line) && line == diskheader + cache.searchpath)
+    {
+      time_t now = time(0);
+      while (getline(infile, line))
+	{
+	  istringstream entry(line);
+	  time_t when;
+	  string lname, pfn;
+	  entry >> when >> lname;
+	  getline(entry >> ws, pfn);
+	  if (entry.fail() || pfn.empty() || now - when > cache.ttl)
+	    {
+	      continue;
+	    }
+	  cache.disk[lname] = make_pair(when, pfn);
+	}
+      return;
+    }
+  infile.close();
+  // no cache yet or one for a different search path, start a new one
+  ofstream outfile(cache.diskfile.c_str(), ios_base::trunc);
+  if (!outfile)
+    {
+      cout << "FROG: cannot write disk cache " << cache.diskfile << endl;
+      cache.diskfile.clear();
+      return;
+    }
+  outfile << diskheader << cache.searchpath << endl;
+  return;
+}
+
+static void
+disk_store(const string &lname, const string &pfn)
+{
+  FROGCache &cache = frogcache();
+  if (cache.diskfile.empty())
+    {
+      return;
+    }
+  time_t now = time(0);
+  cache.disk[lname] = make_pair(now, pfn);
+  ofstream outfile(cache.diskfile.c_str(), ios_base::app);
+  outfile << now << " " << lname << " " << pfn << endl;
+  return;
+}
+
+// returns false if GSEARCHPATH is not set. The path is only parsed again
+// if it changed, the cached names are dropped in that case
+static bool
+update_searchpath()
+{
+  const char *env = getenv("GSEARCHPATH");
+  if (!env)
+    {
+      return false;
+    }
+  string en1 = env;
+  if (en1.empty())
+    {
+      cout << "GSEARCHPATH is an empty string" << endl;
+      exit(1);
+    }
+  FROGCache &cache = frogcache();
+  if (en1 == cache.searchpath)
+    {
+      return true;
+    }
+  cache.searchpath = en1;
+  cache.pathlist.clear();
+  cache.lru.clear();
+  cache.index.clear();
+  while (!en1.empty())
+    {
+      string en2;
+      size_t n = en1.find_first_of(sep);
+      if (n != string::npos)
+	{
+	  en2 = en1.substr(0, n);
+	  en1 = en1.substr(n + 1, en1.length());
+	}
+      else
+	{
+	  en2 = en1;
+	  en1 = "";
+	}
+      if (en2.substr(0, 4) == "OBJY")
+	{
+	  cout << "Objy search is deprecated, please remove OBJY from your GSEARCHPATH env" << endl;
+	  continue;
+	}
+      cache.pathlist.push_back(en2);
+    }
+  disk_load();
+  return true;
+}
+
+static bool
+cache_lookup(const string &lname, string &pfn)
+{
+  FROGCache &cache = frogcache();
+  map<string, list<pair<string, string> >::iterator>::iterator iter = cache.index.find(lname);
+  if (iter != cache.index.end())
+    {
+      pfn = iter->second->second;
+      // move to the front
+      cache.lru.splice(cache.lru.begin(), cache.lru, iter->second);
+      cache.hits++;
+      return true;
+    }
+  map<string, pair<time_t, string> >::const_iterator diter = cache.disk.find(lname);
+  if (diter != cache.disk.end() && time(0) - diter->second.first <= cache.ttl)
+    {
+      pfn = diter->second.second;
+      lru_insert(lname, pfn);
+      cache.hits++;
+      cache.diskhits++;
+      return true;
+    }
+  return false;
+}
 
 const char *
 FROG::location(const char * logical_name)
 {
   const char * notfound = "";
-  int n = 0, i = 0, envset = 0;
-  string en, en1, en2;
 
   if (strcmp(logical_name,"") == 0)
     {
       return notfound;
     }
-  
-  if(strncmp(logical_name,"/",1) == 0) 	 
-    { 	 
-      return logical_name; 	 
+
+  if(strncmp(logical_name,"/",1) == 0)
+    {
+      return logical_name;
+    }
+
+  if (!update_searchpath())
+    {
+      return logical_name;
+    }
+  if (cache_lookup(logical_name, pfn))
+    {
+      return pfn.c_str();
+    }
+  vector<string> lnames(1, logical_name);
+  vector<string> pfns;
+  if (location(lnames, pfns) > 0)
+    {
+      pfn = pfns[0];
+      return pfn.c_str();
     }
-  
-  while (envset == 0 && environ[i])
+  return logical_name;
+}
+
+int
+FROG::location(const vector<string> &lnames, vector<string> &pfns)
+{
+  pfns = lnames; // not found names are returned as they are
+  int nfound = 0;
+  bool searchpath = update_searchpath();
+  // names which are not in the cache, with the index of their first use
+  map<string, vector<unsigned int> > todo;
+  for (unsigned int i = 0; i < lnames.size(); i++)
     {
-      en = environ[i];
-      if (en.substr(0, 12) == "GSEARCHPATH=")
+      if (lnames[i].empty())
+	{
+	  continue;
+	}
+      if (lnames[i][0] == '/')
+	{
+	  nfound++;
+	  continue;
+	}
+      if (!searchpath)
 	{
-	  envset = 1;
-	  en1 = en.substr(12,en.length());
-	  if(en1.empty())
+	  continue;
+	}
+      if (cache_lookup(lnames[i], pfns[i]))
+	{
+	  nfound++;
+	  continue;
+	}
+      todo[lnames[i]].push_back(i);
+    }
+  if (todo.empty())
+    {
+      return nfound;
+    }
+
+  FROGCache &cache = frogcache();
+  cache.misses += todo.size();
+  // walk the search path once, every entry only sees the names which
+  // the previous entries did not find
+  for (vector<string>::const_iterator piter = cache.pathlist.begin(); piter != cache.pathlist.end() && !todo.empty(); ++piter)
+    {
+      vector<string> names;
+      for (map<string, vector<unsigned int> >::const_iterator iter = todo.begin(); iter != todo.end(); ++iter)
+	{
+	  names.push_back(iter->first);
+	}
+      vector<string> found;
+      bool connected = true;
+      if (piter->substr(0, 2) == "PG")
+	{
+	  pgsearch PG;
+	  connected = PG.search(names, found);
+	}
+      else if (piter->substr(0, 6) == "DCACHE")
+	{
+	  dCachesearch dC;
+	  connected = dC.search(names, found);
+	}
+      else
+	{
+	  for (vector<string>::const_iterator iter = names.begin(); iter != names.end(); ++iter)
 	    {
-	      cout << "GSEARCHPATH is an empty string" << endl;
-	      exit(1);
+	      string tem = *piter + "/" + *iter;
+	      found.push_back(localSearch(tem));
 	    }
-	  while (!en1.empty())
+	}
+      if (!connected)
+	{
+	  // like a single name lookup the names come back unresolved. They
+	  // are not cached, the next call asks the catalog again
+	  break;
+	}
+      for (unsigned int i = 0; i < names.size(); i++)
+	{
+	  if (found[i].empty())
 	    {
-	      n = en1.find_first_of(sep);
-	      if (n != -1)
-		{
-		  en2 = en1.substr(0,n);
-		  en1 = en1.substr(n+1,en1.length());
-		}
-	      else
-		{
-		  en2 = en1;
-		  en1 = "";
-		}
-	      if(en2.substr(0,4) == "OBJY")
-		{
-		  cout << "Objy search is deprecated, please remove OBJY from your GSEARCHPATH env" << endl;
-		}
-	      else if(en2.substr(0,2) == "PG")
-		{
-                  pfn.erase(); // erase string from previous calls
-		  searchPG(logical_name, pfn);
-		  if (!pfn.empty())
-		    {
-		      return pfn.c_str();
-		    }
-		}
-	      else if(en2.substr(0,6) == "DCACHE")
-		{
-                  pfn.erase(); // erase string from previous calls
-		  searchDC(logical_name, pfn);
-		  if (!pfn.empty())
-		    {
-		      return pfn.c_str();
-		    }
-		}
-	      else 
-		{
-		  string tem = en2+"/"+logical_name;
-		  pfn = localSearch(tem);
-		  if (!pfn.empty())
-		    {
-		      return pfn.c_str();
-		    }
-		}
+	      continue;
 	    }
+	  lru_insert(names[i], found[i]);
+	  disk_store(names[i], found[i]);
+	  const vector<unsigned int> &indices = todo[names[i]];
+	  for (vector<unsigned int>::const_iterator iter = indices.begin(); iter != indices.end(); ++iter)
+	    {
+	      pfns[*iter] = found[i];
+	      nfound++;
+	    }
+	  todo.erase(names[i]);
 	}
-      i++;
     }
-
-  return logical_name; 
-
+  return nfound;
 }
 
 const char *
@@ -114,21 +348,85 @@ FROG::localSearch(const string &logical_name)
 
 void
 FROG::searchPG(const char * logical_name, string &cp)
-{ 
+{
   // Now pgsearches are already known object types...
   pgsearch PG;
   string lname = logical_name;
   //  string cpn = cp;
   PG.search(lname, cp);
-  //   cout << "strlen cp: " << strlen(cp) 
+  //   cout << "strlen cp: " << strlen(cp)
   //        << ", sizeof(cp) " << sizeof(cp) << endl;
   //   sprintf(cp,"%s",cpn.c_str());
 }
 
 void
 FROG::searchDC(const char * logical_name, string &cp)
-{ 
+{
   dCachesearch dC;
   string lname = logical_name;
   dC.search(lname, cp);
 }
+
+void
+FROG::SetCacheSize(const unsigned int n)
+{
+  FROGCache &cache = frogcache();
+  cache.maxsize = n;
+  while (cache.lru.size() > cache.maxsize)
+    {
+      cache.index.erase(cache.lru.back().first);
+      cache.lru.pop_back();
+    }
+  return;
+}
+
+void
+FROG::SetDiskCache(const string &filename, const int ttl)
+{
+  FROGCache &cache = frogcache();
+  cache.diskfile = filename;
+  cache.ttl = ttl;
+  if (!cache.searchpath.empty())
+    {
+      disk_load();
+    }
+  return;
+}
+
+void
+FROG::ClearCache()
+{
+  FROGCache &cache = frogcache();
+  cache.lru.clear();
+  cache.index.clear();
+  cache.disk.clear();
+  return;
+}
+
+void
+FROG::PrintStats(ostream &os)
+{
+  FROGCache &cache = frogcache();
+  os << "FROG cache: " << cache.lru.size() << " names in memory (max "
+     << cache.maxsize << ")";
+  if (!cache.diskfile.empty())
+    {
+      os << ", " << cache.disk.size() << " in " << cache.diskfile
+	 << " (ttl " << cache.ttl << " s)";
+    }
+  os << ", " << cache.hits << " hits (" << cache.diskhits << " from disk), "
+     << cache.misses << " misses" << endl;
+  return;
+}
+
+unsigned long
+FROG::CacheHits()
+{
+  return frogcache().hits;
+}
+
+unsigned long
+FROG::CacheMisses()
+{
+  return frogcache().misses;
+}
@@ -1,9 +1,11 @@
 #ifndef ROOT__FROG
 #define ROOT__FROG
 
+#include <iostream>
 #include <string>
+#include <vector>
 
-class FROG 
+class FROG
 {
 
 private:
@@ -15,9 +17,22 @@ public:
   virtual ~FROG(){}
 
   const char * location(const char * lname);
+  // resolve a whole list in one go (one db connection per search path
+  // entry), pfns[i] belongs to lnames[i]. Returns the number of names
+  // which were found
+  int location(const std::vector<std::string> &lnames, std::vector<std::string> &pfns);
   const char * localSearch(const std::string &lname);
   void searchPG(const char * lname, std::string &cp);
   void searchDC(const char * lname, std::string &cp);
+
+  // resolved names are kept in a process wide LRU cache, optionally backed
+  // by a file whose entries expire after ttl seconds
+  static void SetCacheSize(const unsigned int n);
+  static void SetDiskCache(const std::string &filename, const int ttl = 86400);
+  static void ClearCache();
+  static void PrintStats(std::ostream &os = std::cout);
+  static unsigned long CacheHits();
+  static unsigned long CacheMisses();
 };
 
 #endif
@@ -23,16 +23,10 @@ using namespace odbc;
 using namespace std;
 
 
-void
-dCachesearch::search(const string &lname, string &cp)
+static Connection *
+connect_catalog()
 {
-  struct stat64 stbuf;
   Connection* con = 0;
-  Statement* stmt;
-  ResultSet* rs;
-  const char* dcp;
-  string dc;
-  cp = lname; // if things fail, return input string
   try
     {
       con = DriverManager::getConnection("FileCatalog", "argouser", "Brass_Ring");
@@ -42,10 +36,19 @@ dCachesearch::search(const string &lname, string &cp)
       cout << PHWHERE
            << " Exception caught during DriverManager::getConnection" << endl;
       cout << "Message: " << e.getMessage() << endl;
-      return ;
+      return 0;
     }
+  return con;
+}
 
-
+static void
+search_lfn(Connection *con, const string &lname, string &cp)
+{
+  struct stat64 stbuf;
+  Statement* stmt;
+  ResultSet* rs;
+  const char* dcp;
+  string dc;
   string temp = lname;
   string mys = "SELECT * from files where lfn='" + temp + "' and full_host_name = 'hpss' and full_file_path like '/home/dcphenix/phnxreco/%'";
 
@@ -76,5 +79,34 @@ dCachesearch::search(const string &lname, string &cp)
       cp = "";
     }
   delete rs;
+}
+
+void
+dCachesearch::search(const string &lname, string &cp)
+{
+  cp = lname; // if things fail, return input string
+  Connection *con = connect_catalog();
+  if (!con)
+    {
+      return;
+    }
+  search_lfn(con, lname, cp);
+  delete con;
+}
+
+bool
+dCachesearch::search(const vector<string> &lnames, vector<string> &cp)
+{
+  cp = lnames; // if things fail, return input strings
+  Connection *con = connect_catalog();
+  if (!con)
+    {
+      return false;
+    }
+  for (unsigned int i = 0; i < lnames.size(); i++)
+    {
+      search_lfn(con, lnames[i], cp[i]);
+    }
   delete con;
+  return true;
 }
@@ -20,13 +20,10 @@
 using namespace odbc;
 using namespace std;
 
-void
-pgsearch::search(const string &lname, string &cp)
+static Connection *
+connect_catalog()
 {
   Connection* con = NULL;
-  Statement* stmt;
-  ResultSet* rs;
-  cp = lname; // if things fail, return input string
   try
     {
       con = DriverManager::getConnection("FileCatalog", "argouser", "Brass_Ring");
@@ -36,10 +33,16 @@ pgsearch::search(const string &lname, string &cp)
       cout << PHWHERE
 	   << " Exception caught during DriverManager::getConnection" << endl;
       cout << "Message: " << e.getMessage() << endl;
-      return ;
+      return NULL;
     }
+  return con;
+}
 
-
+static void
+search_lfn(Connection *con, const string &lname, string &cp)
+{
+  Statement* stmt;
+  ResultSet* rs;
   string temp = lname;
   string mys = "SELECT * from files where lfn='" + temp + "' and full_host_name <> 'hpss'";
 
@@ -92,5 +95,34 @@ pgsearch::search(const string &lname, string &cp)
       }
     }
   delete rs;
+}
+
+void
+pgsearch::search(const string &lname, string &cp)
+{
+  cp = lname; // if things fail, return input string
+  Connection *con = connect_catalog();
+  if (!con)
+    {
+      return;
+    }
+  search_lfn(con, lname, cp);
+  delete con;
+}
+
+bool
+pgsearch::search(const vector<string> &lnames, vector<string> &cp)
+{
+  cp = lnames; // if things fail, return input strings
+  Connection *con = connect_catalog();
+  if (!con)
+    {
+      return false;
+    }
+  for (unsigned int i = 0; i < lnames.size(); i++)
+    {
+      search_lfn(con, lnames[i], cp[i]);
+    }
   delete con;
+  return true;
 }
@@ -2,6 +2,7 @@
 #define __PGSEARCH__H
 
 #include <string>
+#include <vector>
 
 class pgsearch
 {
@@ -12,6 +13,9 @@ public:
 
   // Make the search method public for external operators...
   void search(const std::string  &fileName, std::string &cp);
+  // same lookup for many names over a single connection, false if the
+  // catalog cannot be reached (cp holds the input names then)
+  bool search(const std::vector<std::string> &fileNames, std::vector<std::string> &cp);
 
 };
 
@@ -0,0 +1,279 @@
+#include "Fun4AllEmbeddingInputManager.h"
+#include "Fun4AllReturnCodes.h"
+
+#include <frog/FROG.h>
+
+#include <phool/phool.h>
+#include <phool/PHNodeIOManager.h>
+#include <phool/PHRandomService.h>
+
+#include <TTree.h>
+
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+Fun4AllEmbeddingInputManager::Fun4AllEmbeddingInputManager(const string &name,
+							   const string &nodename,
+							   const string &topnodename) :
+  Fun4AllNoSyncDstInputManager(name, nodename, topnodename),
+  reuse(1),
+  nused(0),
+  randomorder(0),
+  cachesize(0),
+  parallelunzip(0),
+  current_entry(-1),
+  current_file(-1),
+  nbackground(0),
+  nfileopen(0)
+{
+  return ;
+}
+
+Fun4AllEmbeddingInputManager::~Fun4AllEmbeddingInputManager()
+{
+  return;
+}
+
+void
+Fun4AllEmbeddingInputManager::RandomOrder(const int i, const unsigned int seed)
+{
+  randomorder = i;
+  if (seed)
+    {
+      PHRandomService::instance()->SetModuleSeed(Name(), seed);
+    }
+  return;
+}
+
+void
+Fun4AllEmbeddingInputManager::Prefetch(const int cachemb, const int unzip)
+{
+  cachesize = (cachemb > 0) ? (long long) cachemb * 1024 * 1024 : 0;
+  parallelunzip = unzip;
+  return;
+}
+
+int
+Fun4AllEmbeddingInputManager::fileopen(const string &filenam)
+{
+  if (!first_entry.empty())
+    {
+      cout << PHWHERE << " " << Name() << ": background index already built, "
+           << filenam << " is not added" << endl;
+      return -1;
+    }
+  return AddFile(filenam);
+}
+
+int
+Fun4AllEmbeddingInputManager::fileclose()
+{
+  // closes the current file but keeps the index
+  if (!isopen)
+    {
+      cout << Name() << ": fileclose: No Input file open" << endl;
+      return -1;
+    }
+  delete IManager;
+  IManager = 0;
+  isopen = 0;
+  current_file = -1;
+  return 0;
+}
+
+int
+Fun4AllEmbeddingInputManager::BuildIndex()
+{
+  indexed_files.clear();
+  first_entry.clear();
+  first_entry.push_back(0);
+  FROG frog;
+  for (list<string>::const_iterator iter = filelist.begin(); iter != filelist.end(); ++iter)
+    {
+      PHNodeIOManager *countmanager = new PHNodeIOManager(frog.location(iter->c_str()), PHReadOnly);
+      size_t nevents = 0;
+      if (countmanager->isFunctional())
+        {
+          nevents = countmanager->GetNumEvents();
+        }
+      delete countmanager;
+      if (nevents == 0)
+        {
+          cout << PHWHERE << " " << Name() << ": could not open or no events in "
+               << *iter << ", skipping it" << endl;
+          continue;
+        }
+      indexed_files.push_back(*iter);
+      first_entry.push_back(first_entry.back() + nevents);
+      if (verbosity > 1)
+        {
+          cout << Name() << ": " << *iter << " with " << nevents << " events" << endl;
+        }
+    }
+  if (indexed_files.empty())
+    {
+      cout << Name() << ": No background events in the input files" << endl;
+      return -1;
+    }
+  if (cachesize > 0 && parallelunzip)
+    {
+      TTree::SetParallelUnzip(kTRUE);
+    }
+  if (verbosity > 0)
+    {
+      cout << Name() << ": indexed " << first_entry.back() << " background events in "
+           << indexed_files.size() << " files" << endl;
+    }
+  return 0;
+}
+
+int
+Fun4AllEmbeddingInputManager::NextEntry()
+{
+  long long nentries = first_entry.back();
+  if (randomorder)
+    {
+      // the input is read before the event is started in the random
+      // service, the count of drawn background events makes the stream unique
+      PHPhiloxRandom rnd = PHRandomService::instance()->GetStream(Name(), nbackground);
+      current_entry = (long long) (rnd.Uniform() * nentries);
+      if (current_entry >= nentries)
+        {
+          current_entry = nentries - 1;
+        }
+      return 0;
+    }
+  current_entry++;
+  if (current_entry >= nentries)
+    {
+      if (!repeat)
+        {
+          return -1;
+        }
+      if (repeat > 0)
+        {
+          repeat--;
+        }
+      current_entry = 0;
+    }
+  return 0;
+}
+
+int
+Fun4AllEmbeddingInputManager::OpenIndexedFile(const unsigned int ifile)
+{
+  if (isopen)
+    {
+      fileclose();
+    }
+  if (Fun4AllDstInputManager::fileopen(indexed_files[ifile]))
+    {
+      return -1;
+    }
+  if (cachesize > 0)
+    {
+      IManager->SetCacheSize(cachesize);
+    }
+  current_file = ifile;
+  nfileopen++;
+  return 0;
+}
+
+int
+Fun4AllEmbeddingInputManager::run(const int /*nevents*/)
+{
+  if (first_entry.empty())
+    {
+      if (BuildIndex())
+        {
+          return -1;
+        }
+    }
+ readagain:
+  if (current_entry < 0 || nused >= reuse)
+    {
+      if (NextEntry())
+        {
+          if (verbosity > 0)
+            {
+              cout << Name() << ": all background events used" << endl;
+            }
+          return -1;
+        }
+      nused = 0;
+      nbackground++;
+    }
+  // file holding the current entry
+  unsigned int ifile = upper_bound(first_entry.begin(), first_entry.end(), current_entry) - first_entry.begin() - 1;
+  if (!isopen || current_file != (int) ifile)
+    {
+      if (OpenIndexedFile(ifile))
+        {
+          cout << PHWHERE << " " << Name() << ": could not open " << indexed_files[ifile] << endl;
+          return -1;
+        }
+    }
+  IManager->setEventNumber(current_entry - first_entry[ifile]);
+  if (!IManager->read(dstNode))
+    {
+      cout << PHWHERE << " " << Name() << ": could not read event "
+           << current_entry - first_entry[ifile] << " of " << indexed_files[ifile] << endl;
+      return -1;
+    }
+  nused++;
+  events_total++;
+  events_thisfile++;
+  // check if the local SubsysReco discards this event, a rejected
+  // background event is not used for the following signal events either
+  if (RejectEvent() != Fun4AllReturnCodes::EVENT_OK)
+    {
+      nused = reuse;
+      goto readagain;
+    }
+  return 0;
+}
+
+int
+Fun4AllEmbeddingInputManager::PushBackEvents(const int i)
+{
+  if (randomorder)
+    {
+      cout << PHWHERE << " " << Name() << ": cannot push back events in random order" << endl;
+      return -1;
+    }
+  current_entry -= i;
+  if (current_entry < -1)
+    {
+      current_entry = -1;
+    }
+  if (!first_entry.empty() && current_entry >= first_entry.back())
+    {
+      current_entry = first_entry.back() - 1;
+    }
+  // the next event is read from the entry after current_entry
+  nused = reuse;
+  return 0;
+}
+
+void
+Fun4AllEmbeddingInputManager::Print(const string &what) const
+{
+  if (what == "ALL" || what == "INDEX")
+    {
+      cout << "--------------------------------------" << endl << endl;
+      cout << "Background index of Fun4AllEmbeddingInputManager " << Name() << ":" << endl;
+      for (unsigned int i = 0; i < indexed_files.size(); i++)
+        {
+          cout << indexed_files[i] << ": events " << first_entry[i]
+               << " to " << first_entry[i + 1] - 1 << endl;
+        }
+      cout << "every background event used for " << reuse << " signal events, "
+           << ((randomorder) ? "random" : "sequential") << " order" << endl;
+      cout << nbackground << " background events read for " << events_total
+           << " signal events, " << nfileopen << " file opens" << endl;
+    }
+  Fun4AllDstInputManager::Print(what);
+  return ;
+}
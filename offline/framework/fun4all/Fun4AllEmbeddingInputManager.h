@@ -0,0 +1,66 @@
+#ifndef FUN4ALLEMBEDDINGINPUTMANAGER_H__
+#define FUN4ALLEMBEDDINGINPUTMANAGER_H__
+
+#include "Fun4AllNoSyncDstInputManager.h"
+
+#include <string>
+#include <vector>
+
+// Input manager for the background DSTs of signal embedding.
+// All files given with AddFile/AddListFile/fileopen are indexed at the
+// first event (number of events of every file), after that any background
+// event is read by its position in the index, switching files as needed.
+// Every background event is used for ReuseBackground(n) signal events,
+// it is read again for each of them since the DST node is reset after
+// every event. The background is read in place into the DST node and
+// the signal simulation adds its hits to these containers, use
+// BranchSelect() to not read nodes which are not needed.
+// With Prefetch() the TTreeCache of the background files is enabled and
+// the baskets of the following events are decompressed in a separate
+// thread (ROOT parallel unzip) while the current event is processed.
+
+class Fun4AllEmbeddingInputManager : public Fun4AllNoSyncDstInputManager
+{
+ public:
+
+  Fun4AllEmbeddingInputManager(const std::string &name = "DUMMY", const std::string &nodename = "DST", const std::string &topnodename = "TOP");
+
+  virtual ~Fun4AllEmbeddingInputManager();
+
+  // files are only added to the index, they are opened when needed
+  int fileopen(const std::string &filenam);
+  int fileclose();
+  int run(const int nevents = 0);
+  void Print(const std::string &what = "ALL") const;
+  // moves the position in the index (sequential order only)
+  int PushBackEvents(const int i);
+
+  // number of signal events embedded into every background event
+  void ReuseBackground(const int nsignal) {reuse = (nsignal > 0) ? nsignal : 1;}
+  // draw the background events randomly from the index instead of
+  // reading them in order. The numbers come from PHRandomService, a seed
+  // != 0 is set as the seed of this input manager there
+  void RandomOrder(const int i = 1, const unsigned int seed = 0);
+  // TTreeCache size in MB, parallel unzip of the cached baskets if unzip != 0
+  void Prefetch(const int cachemb = 30, const int unzip = 1);
+
+ protected:
+  int BuildIndex();
+  int NextEntry();
+  int OpenIndexedFile(const unsigned int ifile);
+
+  int reuse;
+  int nused;
+  int randomorder;
+  long long cachesize;
+  int parallelunzip;
+  // files of the index, events of file i are first_entry[i] to first_entry[i+1]-1
+  std::vector<std::string> indexed_files;
+  std::vector<long long> first_entry;
+  long long current_entry;
+  int current_file;
+  long long nbackground;
+  long long nfileopen;
+};
+
+#endif /* __FUN4ALLEMBEDDINGINPUTMANAGER_H__ */
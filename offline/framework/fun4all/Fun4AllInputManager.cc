@@ -3,6 +3,8 @@
 #include "SubsysReco.h"
 #include <phool/phool.h>
 
+#include <frog/FROG.h>
+
 #include <fstream>
 #include <iostream>
 
@@ -57,12 +59,14 @@ Fun4AllInputManager::AddListFile(const string &filename)
       return -1;
     }
   string FullLine;
+  vector<string> newfiles;
   getline(infile, FullLine);
   while ( !infile.eof())
     {
       if (FullLine.size() && FullLine[0] != '#') // remove comments
         {
           AddFile(FullLine);
+          newfiles.push_back(FullLine);
         }
       else if( FullLine.size() )
         {
@@ -75,6 +79,19 @@ Fun4AllInputManager::AddListFile(const string &filename)
       getline( infile, FullLine );
     }
   infile.close();
+  // resolve the whole list in one go, fileopen() then finds the names
+  // in the FROG cache instead of querying the catalog file by file
+  if (!newfiles.empty())
+    {
+      FROG frog;
+      vector<string> pfns;
+      int nfound = frog.location(newfiles, pfns);
+      if (verbosity > 0)
+        {
+          cout << Name() << ": resolved " << nfound << " of "
+               << newfiles.size() << " files in " << filename << endl;
+        }
+    }
   return 0;
 }
 
@@ -3,6 +3,7 @@
 #pragma link C++ class Fun4AllDstInputManager-!;
 #pragma link C++ class Fun4AllDstOutputManager-!;
 #pragma link C++ class Fun4AllDummyInputManager-!;
+#pragma link C++ class Fun4AllEmbeddingInputManager-!;
 #pragma link C++ class Fun4AllHistoManager-!;
 #pragma link C++ class Fun4AllInputManager-!;
 #pragma link C++ class Fun4AllNoSyncDstInputManager-!;
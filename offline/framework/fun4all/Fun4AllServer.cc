@@ -6,6 +6,8 @@
 #include "Fun4AllReturnCodes.h"
 #include "SubsysReco.h"
 
+#include <ffaobjects/EventHeader.h>
+
 #include <phool/getClass.h>
 #include <phool/phool.h>
 #include <phool/PHObject.h>
@@ -15,6 +17,7 @@
 #include <phool/PHNodeIterator.h>
 #include <phool/PHNodeReset.h>
 #include <phool/PHPointerListIterator.h>
+#include <phool/PHRandomService.h>
 #include <phool/PHTypedNodeIterator.h>
 #include <phool/PHTimeStamp.h>
 #include <phool/recoConsts.h>
@@ -511,6 +514,14 @@ Fun4AllServer::process_event()
   vector<pair<SubsysReco *, PHCompositeNode*> >::iterator iter;
   unsigned icnt = 0;
   int eventbad = 0;
+  // the random streams of the modules are keyed by run and the event number
+  // of the event header if the input brought one, the job counter otherwise
+  PHRandomService::instance()->BeginEvent(runnumber);
+  EventHeader *evthead = findNode::getClass<EventHeader>(TopNode, "EventHeader");
+  if (evthead && evthead->isValid())
+    {
+      PHRandomService::instance()->SetEvent(runnumber, evthead->get_EvtSequence());
+    }
   if (ScreamEveryEvent)
     {
       cout << "*******************************************************************************" << endl;
@@ -41,6 +41,7 @@ PHNodeIOManager::PHNodeIOManager ():
   split(0),
   accessMode(PHReadOnly),
   CompressionLevel(3),
+  CacheSize(0),
   isFunctionalFlag(0)
 {}
 
@@ -49,7 +50,8 @@ PHNodeIOManager::PHNodeIOManager (const string& f,
   file(NULL),
   tree(NULL),
   TreeName("T"),
-  CompressionLevel(3)
+  CompressionLevel(3),
+  CacheSize(0)
 {
   isFunctionalFlag = setFile(f, "titled by PHOOL", a) ? 1 : 0;
 }
@@ -59,7 +61,8 @@ PHNodeIOManager::PHNodeIOManager (const string& f, const string& title,
   file(NULL),
   tree(NULL),
   TreeName("T"),
-  CompressionLevel(3)
+  CompressionLevel(3),
+  CacheSize(0)
 {
   isFunctionalFlag = setFile(f, title , a) ? 1 : 0;
 }
@@ -69,7 +72,8 @@ PHNodeIOManager::PHNodeIOManager (const string& f, const PHAccessType a,
   file(NULL),
   tree(NULL),
   TreeName("T"),
-  CompressionLevel(3)
+  CompressionLevel(3),
+  CacheSize(0)
 {
   if (treeindex != PHEventTree)
     {
@@ -440,6 +444,10 @@ PHNodeIOManager::reconstructNodeTree(PHCompositeNode* topNode)
 				static_cast<bool>(it->second));
 	}
     }
+  if (CacheSize > 0)
+    {
+      tree->SetCacheSize(CacheSize);
+    }
   // The file contains a TTree with a list of the TBranchObjects
   // attached to it.
   TObjArray *branchArray = tree->GetListOfBranches();
@@ -607,6 +615,41 @@ PHNodeIOManager::GetBytesWritten()
   return 0.;
 }
 
+size_t
+PHNodeIOManager::GetNumEvents()
+{
+  if (tree)
+    {
+      return tree->GetEntries();
+    }
+  if (!file)
+    {
+      return 0;
+    }
+  // node tree not read yet, just look up the number of entries
+  TTree *treetmp = static_cast<TTree *>(file->Get(TreeName.c_str()));
+  if (treetmp)
+    {
+      return treetmp->GetEntries();
+    }
+  return 0;
+}
+
+PHBoolean
+PHNodeIOManager::SetCacheSize(const long long size)
+{
+  if (size < 0)
+    {
+      return False;
+    }
+  CacheSize = size;
+  if (tree)
+    {
+      tree->SetCacheSize(CacheSize);
+    }
+  return True;
+}
+
 map<string, TBranch*> *
 PHNodeIOManager::GetBranchMap()
 {
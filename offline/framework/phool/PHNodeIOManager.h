@@ -38,6 +38,8 @@ public:
    PHBoolean SetCompressionLevel(const int level);
    double GetBytesWritten();
    std::map<std::string,TBranch*> *GetBranchMap();
+   size_t GetNumEvents();
+   PHBoolean SetCacheSize(const long long size);
 
 public:
    PHBoolean write(TObject**, const std::string&);
@@ -54,6 +56,7 @@ private:
   int   split;
   int   accessMode;
   int   CompressionLevel;
+  long long CacheSize; // TTreeCache size in bytes, 0 = ROOT default
   std::map<std::string,TBranch*> fBranches ;
   std::map<std::string,PHBoolean> objectToRead ;
 
@@ -0,0 +1,326 @@
+#include "PHPhiloxRandom.h"
+
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+
+static const uint32_t PHILOX_M0 = 0xD2511F53;
+static const uint32_t PHILOX_M1 = 0xCD9E8D57;
+static const uint32_t PHILOX_W0 = 0x9E3779B9;
+static const uint32_t PHILOX_W1 = 0xBB67AE85;
+
+PHPhiloxRandom::PHPhiloxRandom(const uint64_t key, const uint64_t stream):
+  nbuf(0),
+  has_gaus(false),
+  gaus(0)
+{
+  SetKey(key);
+  SetStream(stream);
+}
+
+void
+PHPhiloxRandom::SetKey(const uint64_t key)
+{
+  k[0] = key & 0xFFFFFFFF;
+  k[1] = key >> 32;
+  nbuf = 0;
+  has_gaus = false;
+}
+
+void
+PHPhiloxRandom::SetStream(const uint64_t stream)
+{
+  ctr[0] = 0;
+  ctr[1] = 0;
+  ctr[2] = stream & 0xFFFFFFFF;
+  ctr[3] = stream >> 32;
+  nbuf = 0;
+  has_gaus = false;
+}
+
+void
+PHPhiloxRandom::Block(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4])
+{
+  uint32_t c0 = counter[0];
+  uint32_t c1 = counter[1];
+  uint32_t c2 = counter[2];
+  uint32_t c3 = counter[3];
+  uint32_t k0 = key[0];
+  uint32_t k1 = key[1];
+  for (int round = 0; round < 10; round++)
+    {
+      uint64_t p0 = (uint64_t) PHILOX_M0 * c0;
+      uint64_t p1 = (uint64_t) PHILOX_M1 * c2;
+      uint32_t hi0 = p0 >> 32;
+      uint32_t lo0 = p0;
+      uint32_t hi1 = p1 >> 32;
+      uint32_t lo1 = p1;
+      c0 = hi1 ^ c1 ^ k0;
+      c1 = lo1;
+      c2 = hi0 ^ c3 ^ k1;
+      c3 = lo0;
+      k0 += PHILOX_W0;
+      k1 += PHILOX_W1;
+    }
+  out[0] = c0;
+  out[1] = c1;
+  out[2] = c2;
+  out[3] = c3;
+}
+
+void
+PHPhiloxRandom::refill()
+{
+  Block(ctr, k, buf);
+  nbuf = 4;
+  // next block of this stream, the stream id in ctr[2..3] is not touched
+  if (++ctr[0] == 0)
+    {
+      ++ctr[1];
+    }
+}
+
+uint32_t
+PHPhiloxRandom::Next32()
+{
+  if (nbuf == 0)
+    {
+      refill();
+    }
+  return buf[--nbuf];
+}
+
+double
+PHPhiloxRandom::Uniform()
+{
+  // 53 bits, the half step keeps the result away from 0 and 1
+  uint64_t hi = Next32() >> 5;
+  uint64_t lo = Next32() >> 6;
+  return ((hi << 26 | lo) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+void
+PHPhiloxRandom::FillUniform(double *out, const size_t n)
+{
+  static const unsigned int NLANES = 8;
+  size_t i = 0;
+  // leftover words of the current block first
+  while (i < n && nbuf > 0)
+    {
+      out[i++] = Uniform();
+    }
+  // whole blocks, each gives two numbers from words (3,2) and (1,0) like Uniform()
+  while (n - i >= 2 * NLANES)
+    {
+      uint32_t c0[NLANES], c1[NLANES], c2[NLANES], c3[NLANES];
+      for (unsigned int l = 0; l < NLANES; l++)
+	{
+	  c0[l] = ctr[0] + l;
+	  c1[l] = ctr[1] + ((c0[l] < ctr[0]) ? 1 : 0);
+	  c2[l] = ctr[2];
+	  c3[l] = ctr[3];
+	}
+      uint32_t k0 = k[0];
+      uint32_t k1 = k[1];
+      for (int round = 0; round < 10; round++)
+	{
+	  for (unsigned int l = 0; l < NLANES; l++)
+	    {
+	      uint64_t p0 = (uint64_t) PHILOX_M0 * c0[l];
+	      uint64_t p1 = (uint64_t) PHILOX_M1 * c2[l];
+	      uint32_t n0 = (uint32_t) (p1 >> 32) ^ c1[l] ^ k0;
+	      uint32_t n2 = (uint32_t) (p0 >> 32) ^ c3[l] ^ k1;
+	      c1[l] = (uint32_t) p1;
+	      c3[l] = (uint32_t) p0;
+	      c0[l] = n0;
+	      c2[l] = n2;
+	    }
+	  k0 += PHILOX_W0;
+	  k1 += PHILOX_W1;
+	}
+      for (unsigned int l = 0; l < NLANES; l++)
+	{
+	  uint64_t hi = c3[l] >> 5;
+	  uint64_t lo = c2[l] >> 6;
+	  out[i++] = ((hi << 26 | lo) + 0.5) * (1.0 / 9007199254740992.0);
+	  hi = c1[l] >> 5;
+	  lo = c0[l] >> 6;
+	  out[i++] = ((hi << 26 | lo) + 0.5) * (1.0 / 9007199254740992.0);
+	}
+      uint32_t old = ctr[0];
+      ctr[0] += NLANES;
+      if (ctr[0] < old)
+	{
+	  ++ctr[1];
+	}
+    }
+  while (i < n)
+    {
+      out[i++] = Uniform();
+    }
+}
+
+void
+PHPhiloxRandom::FillGaus(double *out, const size_t n, const double mean, const double sigma)
+{
+  size_t i = 0;
+  if (n > 0 && has_gaus)
+    {
+      out[i++] = Gaus(mean, sigma);
+    }
+  // uniform pairs into the output, then Box-Muller in place
+  size_t npairs = (n - i) / 2;
+  FillUniform(out + i, 2 * npairs);
+  for (size_t j = 0; j < npairs; j++, i += 2)
+    {
+      // same rounding as Gaus(), which keeps r * sin(phi) for the next call
+      double r = sqrt(-2. * log(out[i]));
+      double phi = 2. * M_PI * out[i + 1];
+      out[i] = mean + sigma * r * cos(phi);
+      out[i + 1] = mean + sigma * (r * sin(phi));
+    }
+  if (i < n)
+    {
+      out[i] = Gaus(mean, sigma);
+    }
+}
+
+void
+PHPhiloxRandom::FillPoisson(unsigned int *out, const double *means, const size_t n)
+{
+  for (size_t i = 0; i < n; i++)
+    {
+      out[i] = Poisson(means[i]);
+    }
+}
+
+unsigned int
+PHPhiloxRandom::CheckFill(const uint64_t key, const uint64_t stream)
+{
+  static const size_t NMAX = 1001;
+  static const size_t sizes[] = {1, 2, 15, 16, 17, 100, NMAX};
+  double bulk[NMAX];
+  unsigned int ibulk[NMAX];
+  double means[NMAX];
+  for (size_t i = 0; i < NMAX; i++)
+    {
+      means[i] = 0.5 * (i % 100); // both Poisson methods
+    }
+  unsigned int ndiff = 0;
+  for (unsigned int offset = 0; offset < 3; offset++)
+    {
+      for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+	{
+	  size_t n = sizes[s];
+	  // offset 1 starts inside a block, offset 2 with a kept gaussian
+	  PHPhiloxRandom fill(key, stream);
+	  PHPhiloxRandom single(key, stream);
+	  for (unsigned int i = 0; i < offset; i++)
+	    {
+	      double a = (i == 0) ? fill.Uniform() : fill.Gaus();
+	      double b = (i == 0) ? single.Uniform() : single.Gaus();
+	      if (a != b)
+		{
+		  ++ndiff;
+		}
+	    }
+	  fill.FillUniform(bulk, n);
+	  for (size_t i = 0; i < n; i++)
+	    {
+	      if (bulk[i] != single.Uniform())
+		{
+		  ++ndiff;
+		}
+	    }
+	  fill.FillGaus(bulk, n, 1., 2.);
+	  for (size_t i = 0; i < n; i++)
+	    {
+	      if (bulk[i] != single.Gaus(1., 2.))
+		{
+		  ++ndiff;
+		}
+	    }
+	  fill.FillPoisson(ibulk, means, n);
+	  for (size_t i = 0; i < n; i++)
+	    {
+	      if (ibulk[i] != single.Poisson(means[i]))
+		{
+		  ++ndiff;
+		}
+	    }
+	  if (fill.Next32() != single.Next32())
+	    {
+	      ++ndiff;
+	    }
+	}
+    }
+  if (ndiff > 0)
+    {
+      cout << "PHPhiloxRandom::CheckFill: " << ndiff
+	   << " bulk draws differ from the single draws" << endl;
+    }
+  return ndiff;
+}
+
+double
+PHPhiloxRandom::Gaus(const double mean, const double sigma)
+{
+  if (has_gaus)
+    {
+      has_gaus = false;
+      return mean + sigma * gaus;
+    }
+  // Box-Muller, the second number is kept for the next call
+  double r = sqrt(-2. * log(Uniform()));
+  double phi = 2. * M_PI * Uniform();
+  gaus = r * sin(phi);
+  has_gaus = true;
+  return mean + sigma * r * cos(phi);
+}
+
+unsigned int
+PHPhiloxRandom::Poisson(const double mean)
+{
+  if (!(mean > 0))
+    {
+      return 0;
+    }
+  if (mean < 10)
+    {
+      double limit = exp(-mean);
+      double prod = Uniform();
+      unsigned int n = 0;
+      while (prod > limit)
+	{
+	  prod *= Uniform();
+	  n++;
+	}
+      return n;
+    }
+  double slam = sqrt(mean);
+  double loglam = log(mean);
+  double b = 0.931 + 2.53 * slam;
+  double a = -0.059 + 0.02483 * b;
+  double invalpha = 1.1239 + 1.1328 / (b - 3.4);
+  double vr = 0.9277 - 3.6224 / (b - 2);
+  while (true)
+    {
+      double u = Uniform() - 0.5;
+      double v = Uniform();
+      double us = 0.5 - fabs(u);
+      double kd = floor((2 * a / us + b) * u + mean + 0.43);
+      if (us >= 0.07 && v <= vr)
+	{
+	  return kd;
+	}
+      if (kd < 0 || (us < 0.013 && v > us))
+	{
+	  continue;
+	}
+      if ((log(v) + log(invalpha) - log(a / (us * us) + b)) <= (-mean + kd * loglam - lgamma(kd + 1)))
+	{
+	  return kd;
+	}
+    }
+}
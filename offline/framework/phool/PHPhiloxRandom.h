@@ -0,0 +1,59 @@
+#ifndef PHPHILOXRANDOM_H
+#define PHPHILOXRANDOM_H
+
+#include <cstddef>
+#include <stdint.h>
+
+// Counter based random numbers (Philox4x32-10, Salmon et al., SC11).
+// A number is a pure function of the 64 bit key, the 64 bit stream id and
+// the position in the stream, there is no state carried from one stream to
+// the next. Giving every object its own stream (e.g. the tower key and the
+// event) makes the numbers independent of the order or the thread in which
+// the objects are processed.
+
+class PHPhiloxRandom
+{
+ public:
+  PHPhiloxRandom(const uint64_t key = 0, const uint64_t stream = 0);
+  virtual ~PHPhiloxRandom() {}
+
+  void SetKey(const uint64_t key);
+  uint64_t GetKey() const {return (((uint64_t) k[1]) << 32) | k[0];}
+  //! starts the stream from its beginning
+  void SetStream(const uint64_t stream);
+  uint64_t GetStream() const {return (((uint64_t) ctr[3]) << 32) | ctr[2];}
+
+  //! next 32 random bits
+  uint32_t Next32();
+  //! uniform in (0,1), 53 bit resolution
+  double Uniform();
+  double Gaus(const double mean = 0, const double sigma = 1);
+  //! inversion for small means, transformed rejection (PTRS, Hoermann 1993) above
+  unsigned int Poisson(const double mean);
+
+  // bulk draws, the same numbers as n single calls in a row. The blocks
+  // for the uniforms are computed several at a time in a loop the
+  // compiler can vectorize
+  void FillUniform(double *out, const size_t n);
+  void FillGaus(double *out, const size_t n, const double mean = 0, const double sigma = 1);
+  void FillPoisson(unsigned int *out, const double *means, const size_t n);
+
+  //! draws the same streams with the Fill methods and with single calls,
+  //! also starting inside a block, returns the number of differences
+  static unsigned int CheckFill(const uint64_t key = 0, const uint64_t stream = 0);
+
+  //! one Philox4x32-10 block, exposed for tests against the reference values
+  static void Block(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]);
+
+ protected:
+  void refill();
+
+  uint32_t k[2];
+  uint32_t ctr[4]; // [0],[1]: block number in the stream, [2],[3]: stream id
+  uint32_t buf[4];
+  unsigned int nbuf;
+  bool has_gaus;
+  double gaus;
+};
+
+#endif
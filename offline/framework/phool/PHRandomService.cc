@@ -0,0 +1,103 @@
+#include "PHRandomService.h"
+#include "PHRandomSeed.h"
+
+#include <iostream>
+
+using namespace std;
+
+PHRandomService *PHRandomService::__instance = NULL;
+
+// keys of job counted events, apart from all header numbers
+static const uint64_t COUNTED_EVENT = 1ULL << 63;
+
+PHRandomService::PHRandomService():
+  _seed(PHRandomSeed()),
+  _run(0),
+  _event(0),
+  _nevents(0),
+  _header_event(0),
+  _header_nevents(0),
+  _counting(false)
+{}
+
+void
+PHRandomService::BeginEvent(const int run)
+{
+  if (run != _run)
+    {
+      // header numbers start again with a new run
+      _header_nevents = 0;
+      _counting = false;
+    }
+  _run = run;
+  _event = COUNTED_EVENT | _nevents++;
+}
+
+void
+PHRandomService::SetEvent(const int run, const uint64_t event)
+{
+  if (run != _run)
+    {
+      _header_nevents = 0;
+      _counting = false;
+    }
+  _run = run;
+  // a second call in the same event only replaces the number
+  if (!_counting && _header_nevents > 0 && _header_nevents != _nevents && event <= _header_event)
+    {
+      cout << "PHRandomService::SetEvent - event number " << event
+	   << " follows " << _header_event << " in run " << run
+	   << ", counting the events of this job from now on" << endl;
+      _counting = true;
+    }
+  _header_event = event;
+  _header_nevents = _nevents;
+  if (!_counting)
+    {
+      _event = event;
+    }
+}
+
+unsigned int
+PHRandomService::GetSeed(const std::string &module) const
+{
+  map<string, unsigned int>::const_iterator iter = _module_seeds.find(module);
+  if (iter != _module_seeds.end())
+    {
+      return iter->second;
+    }
+  return _seed;
+}
+
+PHPhiloxRandom
+PHRandomService::GetStream(const std::string &module, const uint64_t stream) const
+{
+  // 64 bit FNV-1a hash of the module name
+  uint64_t hash = 14695981039346656037ULL;
+  for (string::const_iterator c = module.begin(); c != module.end(); ++c)
+    {
+      hash ^= (unsigned char) *c;
+      hash *= 1099511628211ULL;
+    }
+  // one Philox block mixes (event, run, module, seed) into the key of the
+  // generator, the stream of the module is the stream id
+  uint32_t counter[4] = {(uint32_t) _event, (uint32_t) (_event >> 32),
+			 (uint32_t) _run, (uint32_t) hash};
+  uint32_t key[2] = {GetSeed(module), (uint32_t) (hash >> 32)};
+  uint32_t out[4];
+  PHPhiloxRandom::Block(counter, key, out);
+  return PHPhiloxRandom((((uint64_t) out[1]) << 32) | out[0], stream);
+}
+
+void
+PHRandomService::Print() const
+{
+  cout << "PHRandomService: seed " << _seed << ", run " << _run
+       << ", event " << _event << endl;
+  for (map<string, unsigned int>::const_iterator iter = _module_seeds.begin();
+       iter != _module_seeds.end();
+       ++iter)
+    {
+      cout << "  seed of " << iter->first << ": " << iter->second << endl;
+    }
+}
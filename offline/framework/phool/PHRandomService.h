@@ -0,0 +1,74 @@
+#ifndef PHRANDOMSERVICE_H
+#define PHRANDOMSERVICE_H
+
+#include "PHPhiloxRandom.h"
+
+#include <map>
+#include <string>
+
+// Hands out the random number generators of the modules. A generator is
+// keyed by the job seed, the run, the event, the module name and a stream
+// number chosen by the module (e.g. the tower or hit key), its numbers do
+// not depend on how many numbers other modules or other streams used before
+// or on the thread it runs in. The Fun4AllServer calls BeginEvent() before
+// every event, which counts the events within the job. If the event has a
+// header, its event number is set with SetEvent() (by the Fun4AllServer for
+// the header read with the input, by PHG4HeadReco for simulated events) and
+// the streams are keyed by that number. Header numbers have to go up within
+// a run: the first number which does not (a constant HepMC event number or
+// a numbering starting again in the next input file) switches the service
+// back to the job counter for the rest of the run, so no two events of a
+// job get the same numbers. A module gets its generator in process_event() with
+//
+//   PHPhiloxRandom rnd = PHRandomService::instance()->GetStream(Name(), stream);
+//
+// The job seed is PHRandomSeed() (the RANDOMSEED flag if set), a module
+// can be given its own seed with SetModuleSeed().
+
+class PHRandomService
+{
+ public:
+  static PHRandomService *instance()
+  {
+    if (__instance) return __instance;
+    __instance = new PHRandomService();
+    return __instance;
+  }
+
+  virtual ~PHRandomService() {}
+
+  //! next event of this run, keyed by the job counter until SetEvent()
+  void BeginEvent(const int run);
+  //! event number of the event header of this event
+  void SetEvent(const int run, const uint64_t event);
+  int GetRun() const {return _run;}
+  //! key of the streams in this event, job counted events have the top bit set
+  uint64_t GetEvent() const {return _event;}
+
+  void SetSeed(const unsigned int seed) {_seed = seed;}
+  unsigned int GetSeed() const {return _seed;}
+  void SetModuleSeed(const std::string &module, const unsigned int seed) {_module_seeds[module] = seed;}
+  //! seed used for this module, the job seed unless it was set
+  unsigned int GetSeed(const std::string &module) const;
+
+  //! generator for this module and stream in the current event
+  PHPhiloxRandom GetStream(const std::string &module, const uint64_t stream = 0) const;
+
+  void Print() const;
+
+ protected:
+  PHRandomService();
+
+  static PHRandomService *__instance;
+
+  unsigned int _seed;
+  std::map<std::string, unsigned int> _module_seeds;
+  int _run;
+  uint64_t _event;
+  uint64_t _nevents;
+  uint64_t _header_event;   // header number of the previous SetEvent()
+  uint64_t _header_nevents; // job counter at the previous SetEvent()
+  bool _counting;           // header numbers repeated in this run
+};
+
+#endif
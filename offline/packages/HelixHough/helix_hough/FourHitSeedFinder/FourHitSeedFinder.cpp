@@ -5,6 +5,7 @@
 #include <Eigen/LU>
 #include <Eigen/Core>
 #include <Eigen/Dense>
+#include <sys/time.h>
 
 
 using namespace std;
@@ -12,7 +13,7 @@ using namespace Eigen;
 
 
 
-FourHitSeedFinder::FourHitSeedFinder(vector<float>& detrad, unsigned int n_phi, unsigned int n_d, unsigned int n_k, unsigned int n_dzdl, unsigned int n_z0, HelixResolution& min_resolution, HelixResolution& max_resolution, HelixRange& range) : HelixHough(n_phi, n_d, n_k, n_dzdl, n_z0, min_resolution, max_resolution, range), using_vertex(false), vertex_sigma_xy(0.002), vertex_sigma_z(0.005), chi2_cut(3.)
+FourHitSeedFinder::FourHitSeedFinder(vector<float>& detrad, unsigned int n_phi, unsigned int n_d, unsigned int n_k, unsigned int n_dzdl, unsigned int n_z0, HelixResolution& min_resolution, HelixResolution& max_resolution, HelixRange& range) : HelixHough(n_phi, n_d, n_k, n_dzdl, n_z0, min_resolution, max_resolution, range), using_vertex(false), vertex_sigma_xy(0.002), vertex_sigma_z(0.005), chi2_cut(3.), n_combos_tested(0), seed_time(0.)
 {
   for(unsigned int i=0;i<detrad.size();++i)
   {
@@ -36,23 +37,23 @@ void FourHitSeedFinder::findTracks(vector<SimpleHit3D>& hits, vector<SimpleTrack
 //     temp_track.hits[0] = hits[i1];
 //     for(unsigned int i2=(i1+1);i2<hits.size();++i2)
 //     {
-//       if( (hits[i2].layer == hits[i1].layer)){continue;}
+//       if( (hits[i2].get_layer() == hits[i1].get_layer())){continue;}
 //       temp_track.hits[1] = hits[i2];
 //       for(unsigned int i3=(i2+1);i3<hits.size();++i3)
 //       {
-//         if((hits[i3].layer == hits[i2].layer) || (hits[i3].layer == hits[i1].layer)){continue;}
+//         if((hits[i3].get_layer() == hits[i2].get_layer()) || (hits[i3].get_layer() == hits[i1].get_layer())){continue;}
 //         temp_track.hits[2] = hits[i3];
 //         for(unsigned int i4=(i3+1);i4<hits.size();++i4)
 //         {
-//           if( (hits[i4].layer == hits[i3].layer) || (hits[i4].layer == hits[i2].layer) || (hits[i4].layer == hits[i1].layer)){continue;}
+//           if( (hits[i4].get_layer() == hits[i3].get_layer()) || (hits[i4].get_layer() == hits[i2].get_layer()) || (hits[i4].get_layer() == hits[i1].get_layer())){continue;}
 //           temp_track.hits[3] = hits[i4];
 //           
 //           vector<unsigned int> tempcomb;
 //           tempcomb.assign(4,0);
-//           tempcomb[0] = temp_track.hits[0].index;
-//           tempcomb[1] = temp_track.hits[1].index;
-//           tempcomb[2] = temp_track.hits[2].index;
-//           tempcomb[3] = temp_track.hits[3].index;
+//           tempcomb[0] = temp_track.hits[0].get_id();
+//           tempcomb[1] = temp_track.hits[1].get_id();
+//           tempcomb[2] = temp_track.hits[2].get_id();
+//           tempcomb[3] = temp_track.hits[3].get_id();
 //           
 //           sort(tempcomb.begin(), tempcomb.end());
 //           set<vector<unsigned int> >::iterator it = combos.find(tempcomb);
@@ -82,66 +83,63 @@ void FourHitSeedFinder::findTracks(vector<SimpleHit3D>& hits, vector<SimpleTrack
 
 void FourHitSeedFinder::findTracks_6(vector<SimpleHit3D>& hits, vector<SimpleTrack3D>& tracks, const HelixRange& range)
 {
-  vector<double> chi2_hits;
+  if(hits.size() < 6){return;}
+  
+  timeval t1,t2;
+  gettimeofday(&t1, NULL);
+  
+  // one hit from each of 6 different layers
+  hit_index.build(hits);
+  layer_hits.resize(hit_index.nLayers());
+  for(unsigned int l=0;l<layer_hits.size();++l)
+  {
+    layer_hits[l].clear();
+    hit_index.layerHits(l, layer_hits[l]);
+  }
+  
   SimpleTrack3D temp_track;
   temp_track.hits.resize(6, hits[0]);
+  addLayerHit(hits, tracks, temp_track, 0, 0);
   
-  for(unsigned int i1=0;i1<hits.size();++i1)
+  gettimeofday(&t2, NULL);
+  double time1 = ((double)(t1.tv_sec) + (double)(t1.tv_usec)/1000000.);
+  double time2 = ((double)(t2.tv_sec) + (double)(t2.tv_usec)/1000000.);
+  seed_time += (time2 - time1);
+}
+
+
+// picks hit number depth of temp_track from the layers at or after first_layer
+void FourHitSeedFinder::addLayerHit(vector<SimpleHit3D>& hits, vector<SimpleTrack3D>& tracks, SimpleTrack3D& temp_track, unsigned int depth, unsigned int first_layer)
+{
+  vector<double> chi2_hits;
+  unsigned int n = temp_track.hits.size();
+  for(unsigned int l=first_layer;(l + n - depth)<=layer_hits.size();++l)
   {
-    temp_track.hits[0] = hits[i1];
-    for(unsigned int i2=(i1+1);i2<hits.size();++i2)
+    for(unsigned int j=0;j<layer_hits[l].size();++j)
     {
-      if( (hits[i2].layer == hits[i1].layer)){continue;}
-      temp_track.hits[1] = hits[i2];
-      for(unsigned int i3=(i2+1);i3<hits.size();++i3)
+      temp_track.hits[depth] = hits[layer_hits[l][j]];
+      if((depth + 1) < n)
       {
-        if((hits[i3].layer == hits[i2].layer) || (hits[i3].layer == hits[i1].layer)){continue;}
-        temp_track.hits[2] = hits[i3];
-        for(unsigned int i4=(i3+1);i4<hits.size();++i4)
-        {
-          if( (hits[i4].layer == hits[i3].layer) || (hits[i4].layer == hits[i2].layer) || (hits[i4].layer == hits[i1].layer)){continue;}
-          temp_track.hits[3] = hits[i4];
-          for(unsigned int i5=(i4+1);i5<hits.size();++i5)
-          {
-            if( (hits[i5].layer == hits[i4].layer) || (hits[i5].layer == hits[i3].layer) || (hits[i5].layer == hits[i2].layer) || (hits[i5].layer == hits[i1].layer)){continue;}
-            temp_track.hits[4] = hits[i5];
-            for(unsigned int i6=(i5+1);i6<hits.size();++i6)
-            {
-              if( (hits[i6].layer == hits[i5].layer) || (hits[i6].layer == hits[i4].layer) || (hits[i6].layer == hits[i3].layer) || (hits[i6].layer == hits[i2].layer) || (hits[i6].layer == hits[i1].layer)){continue;}
-              temp_track.hits[5] = hits[i6];
-              
-              vector<unsigned int> tempcomb;
-              tempcomb.assign(6,0);
-              tempcomb[0] = temp_track.hits[0].index;
-              tempcomb[1] = temp_track.hits[1].index;
-              tempcomb[2] = temp_track.hits[2].index;
-              tempcomb[3] = temp_track.hits[3].index;
-              tempcomb[4] = temp_track.hits[4].index;
-              tempcomb[5] = temp_track.hits[5].index;
-              
-              sort(tempcomb.begin(), tempcomb.end());
-              set<vector<unsigned int> >::iterator it = combos.find(tempcomb);
-              if(it != combos.end()){continue;}
-              combos.insert(tempcomb);
-              
-              
-//               if( ((tempcomb[5] - tempcomb[4]) == 1) && ((tempcomb[4] - tempcomb[3]) == 1) && ((tempcomb[3] - tempcomb[2]) == 1) && ((tempcomb[2] - tempcomb[1]) == 1) && ((tempcomb[1] - tempcomb[0]) == 1) && (tempcomb[0]%6 == 0) )
-//               {
-//                 tracks.push_back(temp_track);
-//               }
-              
-              
-              
-              double chi2 = fitTrack(temp_track, chi2_hits);
-              //           double chi2_2 = fitTrackLine(temp_track, chi2_hits);
-              //           if(fabs(chi2_2) < fabs(chi2)){chi2 = chi2_2;}
-              
-              if(fabs(chi2) > chi2_cut){continue;}
-              tracks.push_back(temp_track);
-            }
-          }
-        }
+        addLayerHit(hits, tracks, temp_track, depth + 1, l + 1);
+        continue;
       }
+      
+      vector<unsigned int> tempcomb;
+      tempcomb.assign(n,0);
+      for(unsigned int i=0;i<n;++i){tempcomb[i] = temp_track.hits[i].get_id();}
+      
+      sort(tempcomb.begin(), tempcomb.end());
+      set<vector<unsigned int> >::iterator it = combos.find(tempcomb);
+      if(it != combos.end()){continue;}
+      combos.insert(tempcomb);
+      
+      n_combos_tested += 1;
+      double chi2 = fitTrack(temp_track, chi2_hits);
+      //           double chi2_2 = fitTrackLine(temp_track, chi2_hits);
+      //           if(fabs(chi2_2) < fabs(chi2)){chi2 = chi2_2;}
+      
+      if(fabs(chi2) > chi2_cut){continue;}
+      tracks.push_back(temp_track);
     }
   }
 }
@@ -155,6 +153,13 @@ void FourHitSeedFinder::finalize(vector<SimpleTrack3D>& input, vector<SimpleTrac
     output.push_back(input[i]);
   }
   cout<<"# combinations = "<<combos.size()<<endl;
+  if(print_timings == true)
+  {
+    cout << "seed time = " << seed_time << endl;
+    cout << "combinations tested = " << n_combos_tested;
+    if(seed_time > 0.) cout << " (" << ((double)n_combos_tested)/seed_time << " /s)";
+    cout << endl;
+  }
 }
 
 
@@ -162,17 +167,19 @@ double FourHitSeedFinder::fitTrackLine(SimpleTrack3D& track, vector<double>& chi
 {
   if(using_vertex == true)
   {
-    track.hits.push_back(SimpleHit3D(0.,0., 0.,0., 0.,0., 0, 0));
+    SimpleHit3D vertex_hit;
+    vertex_hit.set_layer(0);
+    track.hits.push_back(vertex_hit);
   }
   
   bool swapped = false;
-  if( fabs(track.hits[0].x - track.hits[1].x) < fabs(track.hits[0].y - track.hits[1].y) )
+  if( fabs(track.hits[0].get_x() - track.hits[1].get_x()) < fabs(track.hits[0].get_y() - track.hits[1].get_y()) )
   {
     for(unsigned int i=0;i<track.hits.size();i++)
     {
-      float temp1 = track.hits[i].x;
-      track.hits[i].x = track.hits[i].y;
-      track.hits[i].y = temp1;
+      float temp1 = track.hits[i].get_x();
+      track.hits[i].set_x(track.hits[i].get_y());
+      track.hits[i].set_y(temp1);
     }
     swapped = true;
   }
@@ -184,16 +191,16 @@ double FourHitSeedFinder::fitTrackLine(SimpleTrack3D& track, vector<double>& chi
   MatrixXf y = MatrixXf::Zero(track.hits.size(), 1);
   for(unsigned int i=0;i<track.hits.size();i++)
   {
-    y(i, 0) = track.hits[i].y;
+    y(i, 0) = track.hits[i].get_y();
     if((using_vertex==true ) && (i == (track.hits.size() - 1))){y(i, 0) /= vertex_sigma_xy;}
-    else{y(i, 0) /= layer_xy_resolution[track.hits[i].layer];}
+    else{y(i, 0) /= layer_xy_resolution[track.hits[i].get_layer()];}
   }
   
   MatrixXf X = MatrixXf::Zero(track.hits.size(), 2);
   for(unsigned int i=0;i<track.hits.size();i++)
   {
     X(i, 0) = 1.;
-    X(i, 1) = track.hits[i].x;
+    X(i, 1) = track.hits[i].get_x();
     if((using_vertex==true ) && (i == (track.hits.size() - 1)))
     {
       X(i, 0) /= vertex_sigma_xy;
@@ -201,8 +208,8 @@ double FourHitSeedFinder::fitTrackLine(SimpleTrack3D& track, vector<double>& chi
     }
     else
     {
-      X(i, 0) /= layer_xy_resolution[track.hits[i].layer];
-      X(i, 1) /= layer_xy_resolution[track.hits[i].layer];
+      X(i, 0) /= layer_xy_resolution[track.hits[i].get_layer()];
+      X(i, 1) /= layer_xy_resolution[track.hits[i].get_layer()];
     }
   }
   
@@ -219,13 +226,13 @@ double FourHitSeedFinder::fitTrackLine(SimpleTrack3D& track, vector<double>& chi
   {
     for(unsigned int i=0;i<track.hits.size();i++)
     {
-      float temp1 = track.hits[i].x;
-      track.hits[i].x = track.hits[i].y;
-      track.hits[i].y = temp1;
+      float temp1 = track.hits[i].get_x();
+      track.hits[i].set_x(track.hits[i].get_y());
+      track.hits[i].set_y(temp1);
     }
     phi = 0.5*M_PI - phi;
   }
-  float d = track.hits[0].x*cos(phi) + track.hits[0].y*sin(phi);
+  float d = track.hits[0].get_x()*cos(phi) + track.hits[0].get_y()*sin(phi);
   float k = 0.;
   
   MatrixXf diff = y - (X*beta);
@@ -237,15 +244,15 @@ double FourHitSeedFinder::fitTrackLine(SimpleTrack3D& track, vector<double>& chi
   MatrixXf y2 = MatrixXf::Zero(track.hits.size(), 1);
   for(unsigned int i=0;i<track.hits.size();i++)
   {
-    y2(i,0) = track.hits[i].z;
+    y2(i,0) = track.hits[i].get_z();
     if((using_vertex==true ) && (i == (track.hits.size() - 1))){y2(i, 0) /= vertex_sigma_z;}
-    else{y2(i, 0) /= layer_z_resolution[track.hits[i].layer];}
+    else{y2(i, 0) /= layer_z_resolution[track.hits[i].get_layer()];}
   }
   
   MatrixXf X2 = MatrixXf::Zero(track.hits.size(), 2);
   for(unsigned int i=0;i<track.hits.size();i++)
   {
-    float D = sqrt( pow(dx - track.hits[i].x, 2) + pow(dy - track.hits[i].y,2));
+    float D = sqrt( pow(dx - track.hits[i].get_x(), 2) + pow(dy - track.hits[i].get_y(),2));
     
     X2(i,0) = D;  
     X2(i,1) = 1.0;
@@ -257,8 +264,8 @@ double FourHitSeedFinder::fitTrackLine(SimpleTrack3D& track, vector<double>& chi
     }
     else
     {
-      X2(i, 0) /= layer_z_resolution[track.hits[i].layer];
-      X2(i, 1) /= layer_z_resolution[track.hits[i].layer];
+      X2(i, 0) /= layer_z_resolution[track.hits[i].get_layer()];
+      X2(i, 1) /= layer_z_resolution[track.hits[i].get_layer()];
     }
   }
   
@@ -306,7 +313,9 @@ double FourHitSeedFinder::fitTrack(SimpleTrack3D& track, vector<double>& chi2_hi
 {
   if(using_vertex == true)
   {
-    track.hits.push_back(SimpleHit3D(0.,0., 0.,0., 0.,0., 0, 0));
+    SimpleHit3D vertex_hit;
+    vertex_hit.set_layer(0);
+    track.hits.push_back(vertex_hit);
   }
   
   chi2_hit.clear();
@@ -315,16 +324,16 @@ double FourHitSeedFinder::fitTrack(SimpleTrack3D& track, vector<double>& chi2_hi
   MatrixXf y = MatrixXf::Zero(track.hits.size(), 1);
   for(unsigned int i=0;i<track.hits.size();i++)
   {
-    y(i, 0) = ( pow(track.hits[i].x,2) + pow(track.hits[i].y,2) );
+    y(i, 0) = ( pow(track.hits[i].get_x(),2) + pow(track.hits[i].get_y(),2) );
     if((using_vertex==true ) && (i == (track.hits.size() - 1))){y(i, 0) /= vertex_sigma_xy;}
-    else{y(i, 0) /= layer_xy_resolution[track.hits[i].layer];}
+    else{y(i, 0) /= layer_xy_resolution[track.hits[i].get_layer()];}
   }
   
   MatrixXf X = MatrixXf::Zero(track.hits.size(), 3);
   for(unsigned int i=0;i<track.hits.size();i++)
   {
-    X(i, 0) = track.hits[i].x;
-    X(i, 1) = track.hits[i].y;
+    X(i, 0) = track.hits[i].get_x();
+    X(i, 1) = track.hits[i].get_y();
     X(i, 2) = -1.;
     if((using_vertex==true ) && (i == (track.hits.size() - 1)))
     {
@@ -334,9 +343,9 @@ double FourHitSeedFinder::fitTrack(SimpleTrack3D& track, vector<double>& chi2_hi
     }
     else
     {
-      X(i, 0) /= layer_xy_resolution[track.hits[i].layer];
-      X(i, 1) /= layer_xy_resolution[track.hits[i].layer];
-      X(i, 2) /= layer_xy_resolution[track.hits[i].layer];
+      X(i, 0) /= layer_xy_resolution[track.hits[i].get_layer()];
+      X(i, 1) /= layer_xy_resolution[track.hits[i].get_layer()];
+      X(i, 2) /= layer_xy_resolution[track.hits[i].get_layer()];
     }
   }
   
@@ -364,15 +373,15 @@ double FourHitSeedFinder::fitTrack(SimpleTrack3D& track, vector<double>& chi2_hi
   MatrixXf y2 = MatrixXf::Zero(track.hits.size(), 1);
   for(unsigned int i=0;i<track.hits.size();i++)
   {
-    y2(i,0) = track.hits[i].z;
+    y2(i,0) = track.hits[i].get_z();
     if((using_vertex==true ) && (i == (track.hits.size() - 1))){y2(i, 0) /= vertex_sigma_z;}
-    else{y2(i, 0) /= layer_z_resolution[track.hits[i].layer];}
+    else{y2(i, 0) /= layer_z_resolution[track.hits[i].get_layer()];}
   }
   
   MatrixXf X2 = MatrixXf::Zero(track.hits.size(), 2);
   for(unsigned int i=0;i<track.hits.size();i++)
   {
-    float D = sqrt( pow(dx - track.hits[i].x, 2) + pow(dy - track.hits[i].y,2));
+    float D = sqrt( pow(dx - track.hits[i].get_x(), 2) + pow(dy - track.hits[i].get_y(),2));
     float s = 0.0;
     
     if(0.5*k*D > 0.1)
@@ -404,8 +413,8 @@ double FourHitSeedFinder::fitTrack(SimpleTrack3D& track, vector<double>& chi2_hi
     }
     else
     {
-      X2(i, 0) /= layer_z_resolution[track.hits[i].layer];
-      X2(i, 1) /= layer_z_resolution[track.hits[i].layer];
+      X2(i, 0) /= layer_z_resolution[track.hits[i].get_layer()];
+      X2(i, 1) /= layer_z_resolution[track.hits[i].get_layer()];
     }
   }
   
@@ -443,18 +452,18 @@ double FourHitSeedFinder::fitTrack(SimpleTrack3D& track, vector<double>& chi2_hi
   float chi2_tot = 0.;
   for(unsigned int h=0;h<track.hits.size();h++)
   {
-    float dx1 = track.hits[h].x - cx;
-    float dy1 = track.hits[h].y - cy;
+    float dx1 = track.hits[h].get_x() - cx;
+    float dy1 = track.hits[h].get_y() - cy;
     
-    float dx2 = track.hits[h].x + cx;
-    float dy2 = track.hits[h].y + cy;
+    float dx2 = track.hits[h].get_x() + cx;
+    float dy2 = track.hits[h].get_y() + cy;
     
     float xydiff1 = sqrt(dx1*dx1 + dy1*dy1) - r;
     float xydiff2 = sqrt(dx2*dx2 + dy2*dy2) - r;
     float xydiff = xydiff2;
     if(fabs(xydiff1) < fabs(xydiff2)){ xydiff = xydiff1; }
     
-    float ls_xy = layer_xy_resolution[track.hits[h].layer];
+    float ls_xy = layer_xy_resolution[track.hits[h].get_layer()];
     if((using_vertex == true) && (h == (track.hits.size() - 1)))
     {
       ls_xy = vertex_sigma_xy;
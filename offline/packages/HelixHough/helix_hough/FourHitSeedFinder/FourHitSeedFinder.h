@@ -2,6 +2,7 @@
 #define __FOURHITSEEDFINDER__
 
 #include "HelixHough.h"
+#include "LayerHitIndex.h"
 #include <vector>
 #include <set>
 
@@ -62,7 +63,11 @@ class FourHitSeedFinder : public HelixHough
     float phiError(SimpleHit3D& hit, float min_k, float max_k, float min_dzdl, float max_dzdl);
     float dzdlError(SimpleHit3D& hit, float min_k, float max_k, float min_dzdl, float max_dzdl);
     
+    unsigned long long getNCombosTested(){return n_combos_tested;}
+    
   private:
+    void addLayerHit(std::vector<SimpleHit3D>& hits, std::vector<SimpleTrack3D>& tracks, SimpleTrack3D& temp_track, unsigned int depth, unsigned int first_layer);
+    
     bool using_vertex;
     float Bfield;
     float Bfield_inv;
@@ -77,6 +82,10 @@ class FourHitSeedFinder : public HelixHough
     std::set<std::vector<unsigned int> > combos;
     std::set<std::vector<unsigned int> > combos_3_pass;
     std::set<std::vector<unsigned int> > combos_3_fail;
+    LayerHitIndex hit_index;
+    std::vector<std::vector<unsigned int> > layer_hits;
+    unsigned long long n_combos_tested;
+    double seed_time;
 };
 
 
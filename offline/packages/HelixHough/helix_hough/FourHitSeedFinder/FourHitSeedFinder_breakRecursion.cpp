@@ -24,7 +24,7 @@ float FourHitSeedFinder::phiError(SimpleHit3D& hit, float min_k, float max_k, fl
   
   float p_inv = 3.33333333333333314e+02*max_k*Bfield_inv*sqrt(1. - max_dzdl*max_dzdl);
   float scatter = 0.;
-  for(int l=0;l<hit.layer;++l)
+  for(int l=0;l<hit.get_layer();++l)
   {
     scatter += detector_scatter[l]*detector_scatter[l];
   }
@@ -39,7 +39,7 @@ float FourHitSeedFinder::dzdlError(SimpleHit3D& hit, float min_k, float max_k, f
   
   float p_inv = 3.33333333333333314e+02*max_k*Bfield_inv*sqrt(1. - max_dzdl*max_dzdl);
   float scatter = 0.;
-  for(int l=0;l<hit.layer;++l)
+  for(int l=0;l<hit.get_layer();++l)
   {
     scatter += detector_scatter[l]*detector_scatter[l];
   }
@@ -12,7 +12,7 @@ void FourHitSeedFinder::findTracks_3_4(vector<SimpleHit3D>& hits, vector<SimpleT
   layer_sorted.assign(4, one_vec);
   for(unsigned int i=0;i<hits.size();++i)
   {
-    layer_sorted[hits[i].layer].push_back(hits[i]);
+    layer_sorted[hits[i].get_layer()].push_back(hits[i]);
   }
   
   float k = 0.5*(range.max_k + range.min_k);
@@ -40,9 +40,9 @@ void FourHitSeedFinder::findTracks_3_4(vector<SimpleHit3D>& hits, vector<SimpleT
       for(unsigned int i2=0;i2<l2_size;++i2)
       {
         // have we seen this combo before?
-        tempcomb[0] = layer_sorted[0][i0].index;
-        tempcomb[1] = layer_sorted[1][i1].index;
-        tempcomb[2] = layer_sorted[2][i2].index;
+        tempcomb[0] = layer_sorted[0][i0].get_id();
+        tempcomb[1] = layer_sorted[1][i1].get_id();
+        tempcomb[2] = layer_sorted[2][i2].get_id();
         sort(tempcomb.begin(), tempcomb.end());
         set<vector<unsigned int> >::iterator it = combos_3_fail.find(tempcomb);
         // if we know this combo sucks, ignore it
@@ -93,10 +93,10 @@ void FourHitSeedFinder::findTracks_3_4(vector<SimpleHit3D>& hits, vector<SimpleT
   {
     for(unsigned int i3=0;i3<l3_size;++i3)
     {
-      tempcomb[0] = layer_sorted[0][three_layers[j][0]].index;
-      tempcomb[1] = layer_sorted[1][three_layers[j][1]].index;
-      tempcomb[2] = layer_sorted[2][three_layers[j][2]].index;
-      tempcomb[3] = layer_sorted[3][i3].index;
+      tempcomb[0] = layer_sorted[0][three_layers[j][0]].get_id();
+      tempcomb[1] = layer_sorted[1][three_layers[j][1]].get_id();
+      tempcomb[2] = layer_sorted[2][three_layers[j][2]].get_id();
+      tempcomb[3] = layer_sorted[3][i3].get_id();
       sort(tempcomb.begin(), tempcomb.end());
       set<vector<unsigned int> >::iterator it = combos.find(tempcomb);
       if(it != combos.end()){continue;}
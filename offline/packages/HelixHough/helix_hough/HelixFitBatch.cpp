@@ -0,0 +1,296 @@
+#include "HelixFitBatch.h"
+#include <sys/time.h>
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include <cmath>
+
+using namespace std;
+
+static inline __m128 select_ps(__m128 mask, __m128 a, __m128 b) {
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline __m128 abs_ps(__m128 v) {
+  static const __m128 sign_mask = _mm_set1_ps(-0.f);
+  return _mm_andnot_ps(sign_mask, v);
+}
+
+HelixFitBatch::HelixFitBatch(unsigned int nhits)
+    : n_hits(nhits), n_tracks(0), n_fitted(0), fit_time(0.) {}
+
+void HelixFitBatch::reset(unsigned int nhits) {
+  n_hits = nhits;
+  n_tracks = 0;
+  x.clear();
+  y.clear();
+  z.clear();
+  wxy.clear();
+  wz.clear();
+}
+
+void HelixFitBatch::addTrack(const SimpleTrack3D& track, const float* xyres,
+                             const float* zres) {
+  if ((n_tracks & 3) == 0) {
+    unsigned int n = x.size() + 4 * n_hits;
+    x.resize(n, 0.);
+    y.resize(n, 0.);
+    z.resize(n, 0.);
+    wxy.resize(n, 0.);
+    wz.resize(n, 0.);
+  }
+  for (unsigned int h = 0; h < n_hits; ++h) {
+    unsigned int j = index(n_tracks, h);
+    x[j] = track.hits[h].get_x();
+    y[j] = track.hits[h].get_y();
+    z[j] = track.hits[h].get_z();
+    wxy[j] = 1. / xyres[h];
+    wz[j] = 1. / zres[h];
+  }
+  n_tracks += 1;
+}
+
+void HelixFitBatch::fit() {
+  if (n_tracks == 0) {
+    return;
+  }
+
+  timeval t1, t2;
+  gettimeofday(&t1, NULL);
+
+  unsigned int n_blocks = (n_tracks + 3) / 4;
+
+  // unused lanes of the last block repeat the last candidate
+  for (unsigned int i = n_tracks; i < 4 * n_blocks; ++i) {
+    for (unsigned int h = 0; h < n_hits; ++h) {
+      unsigned int j = index(i, h);
+      unsigned int k = index(n_tracks - 1, h);
+      x[j] = x[k];
+      y[j] = y[k];
+      z[j] = z[k];
+      wxy[j] = wxy[k];
+      wz[j] = wz[k];
+    }
+  }
+
+  s.resize(x.size());
+  phi.resize(4 * n_blocks);
+  d.resize(4 * n_blocks);
+  kappa.resize(4 * n_blocks);
+  dzdl.resize(4 * n_blocks);
+  z0.resize(4 * n_blocks);
+  chi2.resize(4 * n_blocks);
+
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 half = _mm_set1_ps(0.5);
+  const __m128 two = _mm_set1_ps(2.);
+  const __m128 vmax = _mm_set1_ps(0.999999);
+  const __m128 cut = _mm_set1_ps(0.1);
+  const __m128 c3 = _mm_set1_ps(1. / 3.);
+  const __m128 c5 = _mm_set1_ps(3. / 20.);
+  const __m128 c7 = _mm_set1_ps(5. / 56.);
+
+  float sums[9][4] __attribute__((aligned(16)));
+  float lane_dx[4] __attribute__((aligned(16)));
+  float lane_dy[4] __attribute__((aligned(16)));
+  float lane_k[4] __attribute__((aligned(16)));
+  float lane_v[4] __attribute__((aligned(16)));
+  float lane_cx[4] __attribute__((aligned(16)));
+  float lane_cy[4] __attribute__((aligned(16)));
+  float lane_r[4] __attribute__((aligned(16)));
+  float lane_slope[4] __attribute__((aligned(16)));
+  float lane_z0[4] __attribute__((aligned(16)));
+  float lane_chi2[4] __attribute__((aligned(16)));
+
+  for (unsigned int b = 0; b < n_blocks; ++b) {
+    const unsigned int off = b * n_hits * 4;
+
+    // circle fit, weighted sums of the normal equations for
+    // x^2 + y^2 = 2*cx*x + 2*cy*y - (cx^2 + cy^2 - r^2)
+    __m128 sxx = zero, sxy = zero, syy = zero, sx = zero, sy = zero,
+           s1 = zero, sxr = zero, syr = zero, sr = zero;
+    for (unsigned int h = 0; h < n_hits; ++h) {
+      __m128 vx = _mm_loadu_ps(&x[off + 4 * h]);
+      __m128 vy = _mm_loadu_ps(&y[off + 4 * h]);
+      __m128 w = _mm_loadu_ps(&wxy[off + 4 * h]);
+      __m128 w2 = _mm_mul_ps(w, w);
+      __m128 r2 = _mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy));
+      __m128 wx = _mm_mul_ps(w2, vx);
+      __m128 wy = _mm_mul_ps(w2, vy);
+      sxx = _mm_add_ps(sxx, _mm_mul_ps(wx, vx));
+      sxy = _mm_add_ps(sxy, _mm_mul_ps(wx, vy));
+      syy = _mm_add_ps(syy, _mm_mul_ps(wy, vy));
+      sx = _mm_add_ps(sx, wx);
+      sy = _mm_add_ps(sy, wy);
+      s1 = _mm_add_ps(s1, w2);
+      sxr = _mm_add_ps(sxr, _mm_mul_ps(wx, r2));
+      syr = _mm_add_ps(syr, _mm_mul_ps(wy, r2));
+      sr = _mm_add_ps(sr, _mm_mul_ps(w2, r2));
+    }
+    _mm_store_ps(sums[0], sxx);
+    _mm_store_ps(sums[1], sxy);
+    _mm_store_ps(sums[2], syy);
+    _mm_store_ps(sums[3], sx);
+    _mm_store_ps(sums[4], sy);
+    _mm_store_ps(sums[5], s1);
+    _mm_store_ps(sums[6], sxr);
+    _mm_store_ps(sums[7], syr);
+    _mm_store_ps(sums[8], sr);
+
+    // the 3x3 solves are per lane, in double
+    for (unsigned int l = 0; l < 4; ++l) {
+      double a00 = sums[0][l], a01 = sums[1][l], a02 = -sums[3][l];
+      double a11 = sums[2][l], a12 = -sums[4][l], a22 = sums[5][l];
+      double r0 = sums[6][l], r1 = sums[7][l], r2 = -sums[8][l];
+      double c00 = a11 * a22 - a12 * a12;
+      double c01 = a02 * a12 - a01 * a22;
+      double c02 = a01 * a12 - a02 * a11;
+      double c11 = a00 * a22 - a02 * a02;
+      double c12 = a01 * a02 - a00 * a12;
+      double c22 = a00 * a11 - a01 * a01;
+      double det = a00 * c00 + a01 * c01 + a02 * c02;
+      double b0 = (c00 * r0 + c01 * r1 + c02 * r2) / det;
+      double b1 = (c01 * r0 + c11 * r1 + c12 * r2) / det;
+      double b2 = (c02 * r0 + c12 * r1 + c22 * r2) / det;
+
+      float cx = b0 * 0.5;
+      float cy = b1 * 0.5;
+      float r = sqrt(cx * cx + cy * cy - b2);
+      float p = atan2(cy, cx);
+      float dd = sqrt(cx * cx + cy * cy) - r;
+      float k = 1. / r;
+
+      unsigned int i = 4 * b + l;
+      phi[i] = p;
+      d[i] = dd;
+      kappa[i] = k;
+      lane_dx[l] = dd * cos(p);
+      lane_dy[l] = dd * sin(p);
+      lane_k[l] = k;
+    }
+
+    // path length of every hit from the point of closest approach, and
+    // the weighted sums of the z = z0 + s*dz/ds fit
+    __m128 vdx = _mm_load_ps(lane_dx);
+    __m128 vdy = _mm_load_ps(lane_dy);
+    __m128 vk = _mm_load_ps(lane_k);
+    __m128 sss = zero, ss = zero, sz1 = zero, ssz = zero, sz = zero;
+    for (unsigned int h = 0; h < n_hits; ++h) {
+      __m128 vx = _mm_loadu_ps(&x[off + 4 * h]);
+      __m128 vy = _mm_loadu_ps(&y[off + 4 * h]);
+      __m128 vz = _mm_loadu_ps(&z[off + 4 * h]);
+      __m128 ex = _mm_sub_ps(vdx, vx);
+      __m128 ey = _mm_sub_ps(vdy, vy);
+      __m128 D = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey)));
+      __m128 hk = _mm_mul_ps(_mm_mul_ps(half, vk), D);
+
+      // short arcs from the series of 2*asin(k*D/2)/k
+      __m128 t1 = _mm_mul_ps(hk, hk);
+      __m128 t2 = _mm_mul_ps(D, half);
+      __m128 vs = _mm_mul_ps(two, t2);
+      t2 = _mm_mul_ps(t2, t1);
+      vs = _mm_add_ps(vs, _mm_mul_ps(t2, c3));
+      t2 = _mm_mul_ps(t2, t1);
+      vs = _mm_add_ps(vs, _mm_mul_ps(t2, c5));
+      t2 = _mm_mul_ps(t2, t1);
+      vs = _mm_add_ps(vs, _mm_mul_ps(t2, c7));
+
+      // long arcs need the asin, only for the lanes which have one
+      __m128 big = _mm_cmpgt_ps(hk, cut);
+      if (_mm_movemask_ps(big)) {
+        _mm_store_ps(lane_v, _mm_min_ps(hk, vmax));
+        for (unsigned int l = 0; l < 4; ++l) {
+          lane_v[l] = 2. * asin(lane_v[l]) / lane_k[l];
+        }
+        vs = select_ps(big, _mm_load_ps(lane_v), vs);
+      }
+      _mm_storeu_ps(&s[off + 4 * h], vs);
+
+      __m128 w = _mm_loadu_ps(&wz[off + 4 * h]);
+      __m128 w2 = _mm_mul_ps(w, w);
+      __m128 ws = _mm_mul_ps(w2, vs);
+      sss = _mm_add_ps(sss, _mm_mul_ps(ws, vs));
+      ss = _mm_add_ps(ss, ws);
+      sz1 = _mm_add_ps(sz1, w2);
+      ssz = _mm_add_ps(ssz, _mm_mul_ps(ws, vz));
+      sz = _mm_add_ps(sz, _mm_mul_ps(w2, vz));
+    }
+    _mm_store_ps(sums[0], sss);
+    _mm_store_ps(sums[1], ss);
+    _mm_store_ps(sums[2], sz1);
+    _mm_store_ps(sums[3], ssz);
+    _mm_store_ps(sums[4], sz);
+
+    for (unsigned int l = 0; l < 4; ++l) {
+      double det = (double)sums[0][l] * sums[2][l] - (double)sums[1][l] * sums[1][l];
+      double slope = ((double)sums[3][l] * sums[2][l] - (double)sums[1][l] * sums[4][l]) / det;
+      double zz = ((double)sums[0][l] * sums[4][l] - (double)sums[1][l] * sums[3][l]) / det;
+
+      unsigned int i = 4 * b + l;
+      z0[i] = zz;
+      dzdl[i] = slope / sqrt(1. + slope * slope);
+      lane_slope[l] = slope;
+      lane_z0[l] = zz;
+
+      float r = 1.0e10;
+      if (kappa[i] != 0.) {
+        r = 1. / kappa[i];
+      }
+      lane_r[l] = r;
+      lane_cx[l] = (d[i] + r) * cos(phi[i]);
+      lane_cy[l] = (d[i] + r) * sin(phi[i]);
+    }
+
+    // chi2, distance to the circle (or its mirror for the other helicity)
+    // and the z residual
+    __m128 vcx = _mm_load_ps(lane_cx);
+    __m128 vcy = _mm_load_ps(lane_cy);
+    __m128 vr = _mm_load_ps(lane_r);
+    __m128 vslope = _mm_load_ps(lane_slope);
+    __m128 vz0 = _mm_load_ps(lane_z0);
+    __m128 vchi2 = zero;
+    for (unsigned int h = 0; h < n_hits; ++h) {
+      __m128 vx = _mm_loadu_ps(&x[off + 4 * h]);
+      __m128 vy = _mm_loadu_ps(&y[off + 4 * h]);
+      __m128 vz = _mm_loadu_ps(&z[off + 4 * h]);
+      __m128 vs = _mm_loadu_ps(&s[off + 4 * h]);
+      __m128 w = _mm_loadu_ps(&wxy[off + 4 * h]);
+      __m128 wzz = _mm_loadu_ps(&wz[off + 4 * h]);
+
+      __m128 dx1 = _mm_sub_ps(vx, vcx);
+      __m128 dy1 = _mm_sub_ps(vy, vcy);
+      __m128 dx2 = _mm_add_ps(vx, vcx);
+      __m128 dy2 = _mm_add_ps(vy, vcy);
+      __m128 xydiff1 = _mm_sub_ps(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx1, dx1), _mm_mul_ps(dy1, dy1))), vr);
+      __m128 xydiff2 = _mm_sub_ps(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx2, dx2), _mm_mul_ps(dy2, dy2))), vr);
+      __m128 xydiff = select_ps(_mm_cmplt_ps(abs_ps(xydiff1), abs_ps(xydiff2)), xydiff1, xydiff2);
+      xydiff = _mm_mul_ps(xydiff, w);
+
+      __m128 zdiff = _mm_sub_ps(vz, _mm_add_ps(_mm_mul_ps(vslope, vs), vz0));
+      zdiff = _mm_mul_ps(zdiff, wzz);
+
+      vchi2 = _mm_add_ps(vchi2, _mm_mul_ps(xydiff, xydiff));
+      vchi2 = _mm_add_ps(vchi2, _mm_mul_ps(zdiff, zdiff));
+    }
+    _mm_store_ps(lane_chi2, vchi2);
+
+    float ndf = 2. * ((float)n_hits) - 5.;
+    for (unsigned int l = 0; l < 4; ++l) {
+      chi2[4 * b + l] = lane_chi2[l] / ndf;
+    }
+  }
+
+  n_fitted += n_tracks;
+
+  gettimeofday(&t2, NULL);
+  fit_time += ((double)(t2.tv_sec) + (double)(t2.tv_usec) / 1000000.) -
+              ((double)(t1.tv_sec) + (double)(t1.tv_usec) / 1000000.);
+}
+
+float HelixFitBatch::getTrack(unsigned int i, SimpleTrack3D& track) const {
+  track.phi = phi[i];
+  track.d = d[i];
+  track.kappa = kappa[i];
+  track.dzdl = dzdl[i];
+  track.z0 = z0[i];
+  return chi2[i];
+}
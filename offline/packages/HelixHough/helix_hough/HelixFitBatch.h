@@ -0,0 +1,61 @@
+#ifndef __HELIXFITBATCH_H__
+#define __HELIXFITBATCH_H__
+
+#include "SimpleTrack3D.h"
+#include <vector>
+
+// Least squares helix fit of many track candidates with the same number
+// of hits, same model as sPHENIXTracker::fitTrack (circle fit in xy, then
+// a line fit of z against the path length). The hits are stored in
+// structure of arrays blocks of 4 candidates, so the SSE lanes run over
+// candidates instead of over the rows of a small matrix.
+//
+// usage: reset(nhits), addTrack() for every candidate, fit(), then
+// getTrack()/getChi2() per candidate
+
+class HelixFitBatch {
+ public:
+  HelixFitBatch(unsigned int nhits = 0);
+  ~HelixFitBatch() {}
+
+  // drops all candidates, keeps the memory
+  void reset(unsigned int nhits);
+
+  unsigned int nHits() const { return n_hits; }
+  unsigned int size() const { return n_tracks; }
+
+  // xyres and zres are the resolutions of the nhits hits of the track
+  void addTrack(const SimpleTrack3D& track, const float* xyres,
+                const float* zres);
+
+  void fit();
+
+  // writes phi, d, kappa, dzdl, z0 into track and returns chi2/ndf
+  float getTrack(unsigned int i, SimpleTrack3D& track) const;
+  float getChi2(unsigned int i) const { return chi2[i]; }
+
+  // totals over all fit() calls
+  unsigned long long getNFitted() const { return n_fitted; }
+  double getFitTime() const { return fit_time; }
+
+ private:
+  // index of hit h of track i
+  unsigned int index(unsigned int i, unsigned int h) const {
+    return (i >> 2) * n_hits * 4 + h * 4 + (i & 3);
+  }
+
+  unsigned int n_hits;
+  unsigned int n_tracks;
+
+  std::vector<float> x, y, z;
+  std::vector<float> wxy;  // 1/xyres
+  std::vector<float> wz;   // 1/zres
+  std::vector<float> s;    // path length, filled by fit()
+
+  std::vector<float> phi, d, kappa, dzdl, z0, chi2;
+
+  unsigned long long n_fitted;
+  double fit_time;
+};
+
+#endif  // __HELIXFITBATCH_H__
@@ -0,0 +1,228 @@
+#include "LayerHitIndex.h"
+#include <cmath>
+
+using namespace std;
+
+LayerHitIndex::LayerHitIndex(unsigned int nphi, unsigned int nz)
+    : n_phi(nphi),
+      n_z(nz),
+      n_layers(0),
+      phi_scale(((float)nphi) / (2. * M_PI)) {
+  if (n_phi == 0) {
+    n_phi = 1;
+  }
+  if (n_z == 0) {
+    n_z = 1;
+  }
+  phi_scale = ((float)n_phi) / (2. * M_PI);
+}
+
+void LayerHitIndex::clear() {
+  n_layers = 0;
+  z_min.clear();
+  z_scale.clear();
+  hit_phi.clear();
+  hit_cell.clear();
+  offsets.clear();
+  binned_index.clear();
+  binned_phi.clear();
+  binned_z.clear();
+}
+
+float LayerHitIndex::absDiff(float phi1, float phi2) {
+  float diff = fabs(phi1 - phi2);
+  while (diff > 2. * M_PI) {
+    diff -= 2. * M_PI;
+  }
+  if (diff > M_PI) {
+    diff = 2. * M_PI - diff;
+  }
+  return diff;
+}
+
+void LayerHitIndex::build(const vector<SimpleHit3D>& hits) {
+  clear();
+
+  unsigned int nhits = hits.size();
+  for (unsigned int i = 0; i < nhits; ++i) {
+    if (hits[i].get_layer() >= (int)n_layers) {
+      n_layers = hits[i].get_layer() + 1;
+    }
+  }
+
+  // z range of every layer
+  z_min.assign(n_layers, 0.);
+  vector<float> z_max(n_layers, 0.);
+  vector<bool> seen(n_layers, false);
+  for (unsigned int i = 0; i < nhits; ++i) {
+    int layer = hits[i].get_layer();
+    if (layer < 0) {
+      continue;
+    }
+    float z = hits[i].get_z();
+    if (seen[layer] == false) {
+      z_min[layer] = z;
+      z_max[layer] = z;
+      seen[layer] = true;
+    } else if (z < z_min[layer]) {
+      z_min[layer] = z;
+    } else if (z > z_max[layer]) {
+      z_max[layer] = z;
+    }
+  }
+  z_scale.assign(n_layers, 0.);
+  for (unsigned int l = 0; l < n_layers; ++l) {
+    if (z_max[l] > z_min[l]) {
+      // the largest z goes into the last bin
+      z_scale[l] = ((float)n_z) / ((z_max[l] - z_min[l]) * 1.0001);
+    }
+  }
+
+  // cell of every hit, and the cell populations
+  unsigned int ncells = n_layers * n_z * n_phi;
+  offsets.assign(ncells + 1, 0);
+  hit_phi.resize(nhits);
+  hit_cell.resize(nhits);
+  for (unsigned int i = 0; i < nhits; ++i) {
+    hit_phi[i] = atan2(hits[i].get_y(), hits[i].get_x());
+    int layer = hits[i].get_layer();
+    if (layer < 0) {
+      hit_cell[i] = ncells;
+      continue;
+    }
+    int iphi = (int)((hit_phi[i] + M_PI) * phi_scale);
+    if (iphi < 0) {
+      iphi = 0;
+    }
+    if (iphi >= (int)n_phi) {
+      iphi = n_phi - 1;
+    }
+    int iz = (int)((hits[i].get_z() - z_min[layer]) * z_scale[layer]);
+    if (iz < 0) {
+      iz = 0;
+    }
+    if (iz >= (int)n_z) {
+      iz = n_z - 1;
+    }
+    hit_cell[i] = cell(layer, iz, iphi);
+    offsets[hit_cell[i] + 1] += 1;
+  }
+  for (unsigned int c = 0; c < ncells; ++c) {
+    offsets[c + 1] += offsets[c];
+  }
+
+  // counting sort into the binned arrays
+  unsigned int nbinned = offsets[ncells];
+  binned_index.resize(nbinned);
+  binned_phi.resize(nbinned);
+  binned_z.resize(nbinned);
+  vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+  for (unsigned int i = 0; i < nhits; ++i) {
+    if (hit_cell[i] == ncells) {
+      continue;
+    }
+    unsigned int pos = fill[hit_cell[i]]++;
+    binned_index[pos] = i;
+    binned_phi[pos] = hit_phi[i];
+    binned_z[pos] = hits[i].get_z();
+  }
+}
+
+unsigned int LayerHitIndex::nHits(int layer) const {
+  if (layer < 0 || layer >= (int)n_layers) {
+    return 0;
+  }
+  return offsets[cell(layer + 1, 0, 0)] - offsets[cell(layer, 0, 0)];
+}
+
+void LayerHitIndex::layerHits(int layer, vector<unsigned int>& result) const {
+  if (layer < 0 || layer >= (int)n_layers) {
+    return;
+  }
+  result.insert(result.end(), binned_index.begin() + offsets[cell(layer, 0, 0)],
+                binned_index.begin() + offsets[cell(layer + 1, 0, 0)]);
+}
+
+void LayerHitIndex::scan(unsigned int begin, unsigned int end, float phi0,
+                         float dphi, float zlo, float zhi,
+                         vector<unsigned int>& result) const {
+  for (unsigned int j = begin; j < end; ++j) {
+    if (binned_z[j] < zlo || binned_z[j] > zhi) {
+      continue;
+    }
+    if (absDiff(binned_phi[j], phi0) > dphi) {
+      continue;
+    }
+    result.push_back(binned_index[j]);
+  }
+}
+
+void LayerHitIndex::query(int layer, float phi0, float dphi, float zlo,
+                          float zhi, vector<unsigned int>& result) const {
+  if (layer < 0 || layer >= (int)n_layers || zhi < zlo) {
+    return;
+  }
+
+  // z rows touched by the window
+  int izlo = 0;
+  int izhi = n_z - 1;
+  if (z_scale[layer] > 0.) {
+    izlo = (int)floor((zlo - z_min[layer]) * z_scale[layer]);
+    izhi = (int)floor((zhi - z_min[layer]) * z_scale[layer]);
+    if (izhi < 0 || izlo >= (int)n_z) {
+      return;
+    }
+    if (izlo < 0) {
+      izlo = 0;
+    }
+    if (izhi >= (int)n_z) {
+      izhi = n_z - 1;
+    }
+  }
+
+  // phi bins touched by the window, possibly wrapping around
+  int iphilo = 0;
+  int iphihi = n_phi - 1;
+  bool wrap = false;
+  if (dphi < M_PI) {
+    iphilo = (int)floor((phi0 - dphi + M_PI) * phi_scale);
+    iphihi = (int)floor((phi0 + dphi + M_PI) * phi_scale);
+    if ((iphihi - iphilo + 1) >= (int)n_phi) {
+      iphilo = 0;
+      iphihi = n_phi - 1;
+    } else {
+      iphilo = ((iphilo % (int)n_phi) + n_phi) % n_phi;
+      iphihi = ((iphihi % (int)n_phi) + n_phi) % n_phi;
+      wrap = (iphihi < iphilo);
+    }
+  }
+
+  for (int iz = izlo; iz <= izhi; ++iz) {
+    if (wrap == false) {
+      scan(offsets[cell(layer, iz, iphilo)], offsets[cell(layer, iz, iphihi) + 1],
+           phi0, dphi, zlo, zhi, result);
+    } else {
+      scan(offsets[cell(layer, iz, iphilo)], offsets[cell(layer, iz, n_phi - 1) + 1],
+           phi0, dphi, zlo, zhi, result);
+      scan(offsets[cell(layer, iz, 0)], offsets[cell(layer, iz, iphihi) + 1],
+           phi0, dphi, zlo, zhi, result);
+    }
+  }
+}
+
+void LayerHitIndex::query(int layer, float phi0, float dphi,
+                          vector<unsigned int>& result) const {
+  if (layer < 0 || layer >= (int)n_layers) {
+    return;
+  }
+  if (dphi >= M_PI) {
+    layerHits(layer, result);
+    return;
+  }
+  float zlo = z_min[layer];
+  float zhi = zlo;
+  if (z_scale[layer] > 0.) {
+    zhi = zlo + ((float)n_z) / z_scale[layer];
+  }
+  query(layer, phi0, dphi, zlo, zhi, result);
+}
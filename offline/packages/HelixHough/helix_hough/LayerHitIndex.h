@@ -0,0 +1,72 @@
+#ifndef __LAYERHITINDEX_H__
+#define __LAYERHITINDEX_H__
+
+#include "SimpleHit3D.h"
+#include <vector>
+
+// Per layer (phi, z) grid over a hit vector. build() bins the hits with a
+// counting sort, so the hits of one z row of a layer are contiguous in phi
+// and a phi window is one (or two, when it wraps around +-pi) contiguous
+// ranges per z row. The queries return positions in the vector given to
+// build(). The memory is kept between builds.
+
+class LayerHitIndex {
+ public:
+  LayerHitIndex(unsigned int nphi = 64, unsigned int nz = 16);
+  ~LayerHitIndex() {}
+
+  // hits with a negative layer are not indexed
+  void build(const std::vector<SimpleHit3D>& hits);
+  void clear();
+
+  unsigned int nLayers() const { return n_layers; }
+  unsigned int nHits() const { return hit_phi.size(); }
+  unsigned int nHits(int layer) const;
+
+  // phi of hits[i] as computed by build()
+  float phi(unsigned int i) const { return hit_phi[i]; }
+
+  // appends the hits on layer with |phi - phi0| <= dphi (wrapping at +-pi)
+  // and zlo <= z <= zhi to result, in bin order
+  void query(int layer, float phi0, float dphi, float zlo, float zhi,
+             std::vector<unsigned int>& result) const;
+  // same without a z window
+  void query(int layer, float phi0, float dphi,
+             std::vector<unsigned int>& result) const;
+  // appends all hits on layer to result
+  void layerHits(int layer, std::vector<unsigned int>& result) const;
+
+  // absolute phi difference folded into [0, pi]
+  static float absDiff(float phi1, float phi2);
+
+ private:
+  unsigned int cell(unsigned int layer, unsigned int iz,
+                    unsigned int iphi) const {
+    return (layer * n_z + iz) * n_phi + iphi;
+  }
+  void scan(unsigned int begin, unsigned int end, float phi0, float dphi,
+            float zlo, float zhi, std::vector<unsigned int>& result) const;
+
+  unsigned int n_phi;
+  unsigned int n_z;
+  unsigned int n_layers;
+  float phi_scale;  // n_phi/(2 pi)
+
+  // per layer z binning
+  std::vector<float> z_min;
+  std::vector<float> z_scale;
+
+  // per hit, in the order given to build()
+  std::vector<float> hit_phi;
+  std::vector<unsigned int> hit_cell;
+
+  // per cell offsets into the binned arrays, n_cells + 1 entries
+  std::vector<unsigned int> offsets;
+
+  // binned copies, so the filtering of a query stays in cache
+  std::vector<unsigned int> binned_index;
+  std::vector<float> binned_phi;
+  std::vector<float> binned_z;
+};
+
+#endif  // __LAYERHITINDEX_H__
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <Eigen/LU>
 #include <Eigen/Core>
+#include <sys/time.h>
 
 using namespace std;
 using namespace Eigen;
@@ -18,7 +19,9 @@ NHitSeedFinder::NHitSeedFinder(vector<float>& detrad, unsigned int n_phi,
   vertex_sigma_xy(0.002),
   vertex_sigma_z(0.005),
   chi2_cut(3.),
-  seed_mode(4)
+  seed_mode(4),
+  n_combos_tested(0),
+  seed_time(0.)
 {
   for(unsigned int i=0;i<detrad.size();++i)
   {
@@ -39,291 +42,105 @@ void NHitSeedFinder::findTracks(vector<SimpleHit3D>& hits, vector<SimpleTrack3D>
 
 void NHitSeedFinder::find4Tracks(vector<SimpleHit3D>& hits, vector<SimpleTrack3D>& tracks)
 {
-  // loop over the provided hits
-  for(unsigned int i=0;i<hits.size();i++)
-  {
-    // if this index is not in our map
-    if( phis.find(hits[i].index) == phis.end() )
-    {
-      // calculate the phi now and insert into the map
-      phis.insert(make_pair(hits[i].index,atan2(hits[i].y,hits[i].x)));
-    }
-  }
-	
-  vector<double> chi2_hits;
-  SimpleTrack3D temp_track;
-  temp_track.hits.resize(4, hits[0]);
-	
-  for(unsigned int i1=0;i1<hits.size();++i1)
-    {
-      temp_track.hits[0] = hits[i1];
-      
-      for(unsigned int i2=(i1+1);i2<hits.size();++i2)
-				{
-					if( hits[i2].layer == hits[i1].layer ) continue;
-					if( fabs( phis[hits[i2].index] - phis[hits[i1].index] ) > M_PI_2 ) continue; 
-					
-					temp_track.hits[1] = hits[i2];
-					
-					for(unsigned int i3=(i2+1);i3<hits.size();++i3)
-						{
-							if( hits[i3].layer == hits[i2].layer ) continue;
-							if( hits[i3].layer == hits[i1].layer ) continue;
-							if( fabs( phis[hits[i3].index] - phis[hits[i2].index] ) > M_PI_2 ) continue; 
-							if( fabs( phis[hits[i3].index] - phis[hits[i1].index] ) > M_PI_2 ) continue; 
-							
-							temp_track.hits[2] = hits[i3];
-							
-							for(unsigned int i4=(i3+1);i4<hits.size();++i4)
-								{
-									if( hits[i4].layer == hits[i3].layer ) continue;
-									if( hits[i4].layer == hits[i2].layer ) continue;
-									if( hits[i4].layer == hits[i1].layer ) continue;
-									if( fabs( phis[hits[i4].index] - phis[hits[i3].index] ) > M_PI_2 ) continue; 
-									if( fabs( phis[hits[i4].index] - phis[hits[i2].index] ) > M_PI_2 ) continue; 
-									if( fabs( phis[hits[i4].index] - phis[hits[i1].index] ) > M_PI_2 ) continue; 
-									
-									temp_track.hits[3] = hits[i4];
-									
-									// build track
-									vector<unsigned int> tempcomb;
-									tempcomb.assign(4,0);
-									tempcomb[0] = temp_track.hits[0].index;
-									tempcomb[1] = temp_track.hits[1].index;
-									tempcomb[2] = temp_track.hits[2].index;
-									tempcomb[3] = temp_track.hits[3].index;
-									
-									// check this combo has already been seen
-									sort(tempcomb.begin(), tempcomb.end());
-									set<vector<unsigned int> >::iterator it = combos.find(tempcomb);
-									if(it != combos.end()) continue;
-									
-									// add to list of checked combinations
-									combos.insert(tempcomb);
-									
-									// fit track
-									double chi2 = fitTrack(temp_track, chi2_hits);
-									if(chi2 > chi2_cut) continue;
-									
-									// add track
-									tracks.push_back(temp_track);
-								}
-						}
-				}
-    }
+  findNTracks(hits, tracks, 4, M_PI_2);
 }
 
 
 void NHitSeedFinder::find5Tracks(vector<SimpleHit3D>& hits, vector<SimpleTrack3D>& tracks)
-{//cout<<"find6Tracks Entered with "<<hits.size()<<" hits"<<endl;                                                     
-  // loop over the provided hits                                                                                      
-  for(unsigned int i=0;i<hits.size();i++)
-    {
-      // if this index is not in our map                                                                              
-      if( phis.find(hits[i].index) == phis.end() )
-        {
-          // calculate the phi now and insert into the map                                                            
-          phis.insert(make_pair(hits[i].index,atan2(hits[i].y,hits[i].x)));
-        }
-    }
-
-  vector<double> chi2_hits;
-  SimpleTrack3D temp_track;
-  temp_track.hits.resize(5, hits[0]);
-
-  for(unsigned int i1=0;i1<hits.size();++i1)
-    {
-      temp_track.hits[0] = hits[i1];
-
-      for(unsigned int i2=(i1+1);i2<hits.size();++i2)
-        {
-          if( hits[i2].layer == hits[i1].layer ) continue;
-					/*              if( fabs( phis[hits[i3].index] - phis[hits[i2].index] ) > M_PI_2 ) continue;            
-													if( fabs( phis[hits[i3].index] - phis[hits[i1].index] ) > M_PI_2 ) continue;*/
-
-					temp_track.hits[1] = hits[i2];
-
-					for(unsigned int i3=(i2+1);i3<hits.size();++i3)
-						{
-							if( hits[i3].layer == hits[i2].layer ) continue;
-							if( hits[i3].layer == hits[i1].layer ) continue;
-							/*                  if( fabs( phis[hits[i4].index] - phis[hits[i3].index] ) > M_PI_2 ) continue;    
-                                  if( fabs( phis[hits[i4].index] - phis[hits[i2].index] ) > M_PI_2 ) continue;                        
-                                  if( fabs( phis[hits[i4].index] - phis[hits[i1].index] ) > M_PI_2 ) continue;*/
-
-							temp_track.hits[2] = hits[i3];
-
-							for(unsigned int i4=(i3+1);i4<hits.size();++i4)
-								{
-									if( hits[i4].layer == hits[i3].layer ) continue;
-									if( hits[i4].layer == hits[i2].layer ) continue;
-									if( hits[i4].layer == hits[i1].layer ) continue;
-									/*                      if( fabs( phis[hits[i5].index] - phis[hits[i4].index] ) > M_PI_2 ) continue;                                                                                                                 
-                                          if( fabs( phis[hits[i5].index] - phis[hits[i3].index] ) > M_PI_2 ) continue;                    
-                                          if( fabs( phis[hits[i5].index] - phis[hits[i2].index] ) > M_PI_2 ) continue;                    
-                                          if( fabs( phis[hits[i5].index] - phis[hits[i1].index] ) > M_PI_2 ) continue;*/
-
-									temp_track.hits[3] = hits[i4];
-									for(unsigned int i5=(i4+1);i5<hits.size();++i5)
-										{
-											if( hits[i5].layer == hits[i4].layer ) continue;
-											if( hits[i5].layer == hits[i3].layer ) continue;
-											if( hits[i5].layer == hits[i2].layer ) continue;
-											if( hits[i5].layer == hits[i1].layer ) continue;
-											/*                      if( fabs( phis[hits[i5].index] - phis[hits[i4].index] ) > M_PI_2 ) continue;                                                           if( fabs( phis[hits[i5].index] - phis[hits[i3].index] ) > M_PI_2 ) continue;                                                                       if( fabs( phis[hits[i5].index] - phis[hits[i2].index] ) > M_PI_2 ) continue;                                                            if( fabs( phis[hits[i5].index] - phis[hits[i1].index] ) > M_PI_2 ) continue;*/
-											temp_track.hits[4]= hits[i5];
-											// build track                                                                           
-                                                                                                                      
-                      vector<unsigned int> tempcomb;
-                      tempcomb.assign(5,0);
-                      tempcomb[0] = temp_track.hits[0].index;
-                      tempcomb[1] = temp_track.hits[1].index;
-                      tempcomb[2] = temp_track.hits[2].index;
-                      tempcomb[3] = temp_track.hits[3].index;
-                      tempcomb[4] = temp_track.hits[4].index;
-
-                      // check this combo has already been seen                                                 
-                                                                                                                      
-                      sort(tempcomb.begin(), tempcomb.end());
-                      set<vector<unsigned int> >::iterator it = combos.find(tempcomb);
-                      if(it != combos.end()) continue;
-													
-                      // add to list of checked combinations                                          
-														
-                      combos.insert(tempcomb);
-														
-                      // fit track                                                           
-															
-                      double chi2 = fitTrack(temp_track, chi2_hits);
-                      //                          cout <<"chi2 of seed track: "<<chi2<<endl;                      
-                      if(chi2 > chi2_cut) continue;
-															
-                      // add track                                                                              
-																tracks.push_back(temp_track);
-										}
-								}
-						}
-				}
-		}
+{
+  // no phi cut for 5 and 6 hit seeds
+  findNTracks(hits, tracks, 5, M_PI);
 }
 
 
-
 void NHitSeedFinder::find6Tracks(vector<SimpleHit3D>& hits, vector<SimpleTrack3D>& tracks)
 {
-//   cout << "find6Tracks Entered with " << hits.size()
-//        << " hits, ncombos: " << combos.size() << endl;
+  findNTracks(hits, tracks, 6, M_PI);
+}
 
-  // loop over the provided hits
-  for(unsigned int i=0;i<hits.size();i++)
-    {
-      // if this index is not in our map
-      if( phis.find(hits[i].index) == phis.end() )
-				{
-					// calculate the phi now and insert into the map
-					phis.insert(make_pair(hits[i].index,atan2(hits[i].y,hits[i].x)));
-				}
-    }
 
-  vector<double> chi2_hits;
+// every combination of n hits on n different layers, with all hits
+// within max_dphi of each other in phi
+void NHitSeedFinder::findNTracks(vector<SimpleHit3D>& hits, vector<SimpleTrack3D>& tracks, unsigned int n, float max_dphi)
+{
+  if(hits.size() < n) return;
+  
+  timeval t1,t2;
+  gettimeofday(&t1, NULL);
+  
+  hit_index.build(hits);
+  
   SimpleTrack3D temp_track;
-  temp_track.hits.resize(6, hits[0]);
-
-  for(unsigned int i1=0;i1<hits.size();++i1)
-    {
-      temp_track.hits[0] = hits[i1];
-
-      for(unsigned int i2=(i1+1);i2<hits.size();++i2)
-				{
-					if( hits[i2].layer == hits[i1].layer ) continue;
-
-					//if( fabs( phis[hits[i2].index] - phis[hits[i1].index] ) > M_PI_2 ) continue;
-
-					temp_track.hits[1] = hits[i2];
-
-					for(unsigned int i3=(i2+1);i3<hits.size();++i3)
-						{
-							if( hits[i3].layer == hits[i2].layer ) continue;
-							if( hits[i3].layer == hits[i1].layer ) continue;
-							/*							if( fabs( phis[hits[i3].index] - phis[hits[i2].index] ) > M_PI_2 ) continue;
-								if( fabs( phis[hits[i3].index] - phis[hits[i1].index] ) > M_PI_2 ) continue;*/
-
-							temp_track.hits[2] = hits[i3];
-
-							for(unsigned int i4=(i3+1);i4<hits.size();++i4)
-								{
-									if( hits[i4].layer == hits[i3].layer ) continue;
-									if( hits[i4].layer == hits[i2].layer ) continue;
-									if( hits[i4].layer == hits[i1].layer ) continue;
-									/*									if( fabs( phis[hits[i4].index] - phis[hits[i3].index] ) > M_PI_2 ) continue;
-									if( fabs( phis[hits[i4].index] - phis[hits[i2].index] ) > M_PI_2 ) continue;
-									if( fabs( phis[hits[i4].index] - phis[hits[i1].index] ) > M_PI_2 ) continue;*/
-
-									temp_track.hits[3] = hits[i4];
-
-									for(unsigned int i5=(i4+1);i5<hits.size();++i5)
-										{
-											if( hits[i5].layer == hits[i4].layer ) continue;
-											if( hits[i5].layer == hits[i3].layer ) continue;
-											if( hits[i5].layer == hits[i2].layer ) continue;
-											if( hits[i5].layer == hits[i1].layer ) continue;
-											/*                      if( fabs( phis[hits[i5].index] - phis[hits[i4].index] ) > M_PI_2 ) continue;
-											if( fabs( phis[hits[i5].index] - phis[hits[i3].index] ) > M_PI_2 ) continue;
-											if( fabs( phis[hits[i5].index] - phis[hits[i2].index] ) > M_PI_2 ) continue;
-											if( fabs( phis[hits[i5].index] - phis[hits[i1].index] ) > M_PI_2 ) continue;*/
-
-											temp_track.hits[4] = hits[i5];
-
-											for(unsigned int i6=(i5+1);i6<hits.size();++i6)
-												{
-													if( hits[i6].layer == hits[i5].layer ) continue;
-													if( hits[i6].layer == hits[i4].layer ) continue;
-													if( hits[i6].layer == hits[i3].layer ) continue;
-													if( hits[i6].layer == hits[i2].layer ) continue;
-													if( hits[i6].layer == hits[i1].layer ) continue;
-													/*													if( fabs( phis[hits[i6].index] - phis[hits[i5].index] ) > M_PI_2 ) continue;
-													if( fabs( phis[hits[i6].index] - phis[hits[i4].index] ) > M_PI_2 ) continue;
-													if( fabs( phis[hits[i6].index] - phis[hits[i3].index] ) > M_PI_2 ) continue;
-													if( fabs( phis[hits[i6].index] - phis[hits[i2].index] ) > M_PI_2 ) continue;
-													if( fabs( phis[hits[i6].index] - phis[hits[i1].index] ) > M_PI_2 ) continue;*/
-
-													temp_track.hits[5] = hits[i6];
-													
-													// build track
-													vector<unsigned int> tempcomb;
-													tempcomb.assign(6,0);
-													tempcomb[0] = temp_track.hits[0].index;
-													tempcomb[1] = temp_track.hits[1].index;
-													tempcomb[2] = temp_track.hits[2].index;
-													tempcomb[3] = temp_track.hits[3].index;
-													tempcomb[4] = temp_track.hits[4].index;
-                          tempcomb[5] = temp_track.hits[5].index;
-													
-													// check this combo has already been seen
-													sort(tempcomb.begin(), tempcomb.end());
-													set<vector<unsigned int> >::iterator it = combos.find(tempcomb);
-													if(it != combos.end()) {
-                            //cout << "combo already used!" << endl;
-                            continue;
-													}
-
-													// add to list of checked combinations
-													combos.insert(tempcomb);
+  temp_track.hits.resize(n, hits[0]);
+  vector<unsigned int> comb(n, 0);
+  candidates.resize(n);
+  
+  addLayerHit(hits, tracks, temp_track, comb, 0, 0, max_dphi);
+  
+  gettimeofday(&t2, NULL);
+  double time1 = ((double)(t1.tv_sec) + (double)(t1.tv_usec)/1000000.);
+  double time2 = ((double)(t2.tv_sec) + (double)(t2.tv_usec)/1000000.);
+  seed_time += (time2 - time1);
+}
 
-													// fit track
-													double chi2 = fitTrack(temp_track, chi2_hits);
-                          //cout <<"chi2 of seed track: "<<chi2<<endl;
-													if(chi2 > chi2_cut) continue;
 
-													
-													// add track
-													tracks.push_back(temp_track);
-												}
-										}
-								}
-						}
-				}
-		}
+// picks hit number depth of the combination from the layers at or after
+// first_layer, the hits on the previous layers are in comb
+void NHitSeedFinder::addLayerHit(vector<SimpleHit3D>& hits, vector<SimpleTrack3D>& tracks, SimpleTrack3D& temp_track, vector<unsigned int>& comb, unsigned int depth, int first_layer, float max_dphi)
+{
+  unsigned int n = comb.size();
+  int last_layer = ((int)hit_index.nLayers()) - ((int)(n - depth));
+  vector<double> chi2_hits;
+  
+  for(int l=first_layer;l<=last_layer;++l)
+  {
+    vector<unsigned int>& cand = candidates[depth];
+    cand.clear();
+    if(depth == 0) hit_index.layerHits(l, cand);
+    else hit_index.query(l, hit_index.phi(comb[depth-1]), max_dphi, cand);
+    
+    for(unsigned int c=0;c<cand.size();++c)
+    {
+      unsigned int i = cand[c];
+      
+      // the window only checked the previous hit
+      bool good = true;
+      for(unsigned int j=0;(j+1)<depth;++j)
+      {
+        if( LayerHitIndex::absDiff(hit_index.phi(i), hit_index.phi(comb[j])) > max_dphi ){good = false;break;}
+      }
+      if(good == false) continue;
+      
+      comb[depth] = i;
+      temp_track.hits[depth] = hits[i];
+      if((depth + 1) < n)
+      {
+        addLayerHit(hits, tracks, temp_track, comb, depth + 1, l + 1, max_dphi);
+        continue;
+      }
+      
+      // build track
+      vector<unsigned int> tempcomb;
+      tempcomb.assign(n,0);
+      for(unsigned int j=0;j<n;++j) tempcomb[j] = temp_track.hits[j].get_id();
+      
+      // check this combo has already been seen
+      sort(tempcomb.begin(), tempcomb.end());
+      set<vector<unsigned int> >::iterator it = combos.find(tempcomb);
+      if(it != combos.end()) continue;
+      
+      // add to list of checked combinations
+      combos.insert(tempcomb);
+      
+      // fit track
+      n_combos_tested += 1;
+      double chi2 = fitTrack(temp_track, chi2_hits);
+      if(chi2 > chi2_cut) continue;
+      
+      // add track
+      tracks.push_back(temp_track);
+    }
+  }
 }
 
 
@@ -334,6 +151,14 @@ void NHitSeedFinder::finalize(vector<SimpleTrack3D>& input, vector<SimpleTrack3D
   {
     output.push_back(input[i]);
   }
+  
+  if(print_timings == true)
+  {
+    cout << "seed time = " << seed_time << endl;
+    cout << "combinations tested = " << n_combos_tested;
+    if(seed_time > 0.) cout << " (" << ((double)n_combos_tested)/seed_time << " /s)";
+    cout << endl;
+  }
 }
 
 
@@ -341,7 +166,9 @@ double NHitSeedFinder::fitTrack(SimpleTrack3D& track, vector<double>& chi2_hit)
 {
   if(using_vertex == true)
   {
-    track.hits.push_back(SimpleHit3D(0.,0., 0.,0., 0.,0., 0, 0));
+    SimpleHit3D vertex_hit;
+    vertex_hit.set_layer(0);
+    track.hits.push_back(vertex_hit);
   }
   
   chi2_hit.clear();
@@ -350,16 +177,16 @@ double NHitSeedFinder::fitTrack(SimpleTrack3D& track, vector<double>& chi2_hit)
   MatrixXf y = MatrixXf::Zero(track.hits.size(), 1);
   for(unsigned int i=0;i<track.hits.size();i++)
   {
-    y(i, 0) = ( pow(track.hits[i].x,2) + pow(track.hits[i].y,2) );
+    y(i, 0) = ( pow(track.hits[i].get_x(),2) + pow(track.hits[i].get_y(),2) );
     if((using_vertex==true ) && (i == (track.hits.size() - 1))){y(i, 0) /= vertex_sigma_xy;}
-    else{y(i, 0) /= layer_xy_resolution[track.hits[i].layer];}
+    else{y(i, 0) /= layer_xy_resolution[track.hits[i].get_layer()];}
   }
   
   MatrixXf X = MatrixXf::Zero(track.hits.size(), 3);
   for(unsigned int i=0;i<track.hits.size();i++)
   {
-    X(i, 0) = track.hits[i].x;
-    X(i, 1) = track.hits[i].y;
+    X(i, 0) = track.hits[i].get_x();
+    X(i, 1) = track.hits[i].get_y();
     X(i, 2) = -1.;
     if((using_vertex==true ) && (i == (track.hits.size() - 1)))
     {
@@ -369,9 +196,9 @@ double NHitSeedFinder::fitTrack(SimpleTrack3D& track, vector<double>& chi2_hit)
     }
     else
     {
-      X(i, 0) /= layer_xy_resolution[track.hits[i].layer];
-      X(i, 1) /= layer_xy_resolution[track.hits[i].layer];
-      X(i, 2) /= layer_xy_resolution[track.hits[i].layer];
+      X(i, 0) /= layer_xy_resolution[track.hits[i].get_layer()];
+      X(i, 1) /= layer_xy_resolution[track.hits[i].get_layer()];
+      X(i, 2) /= layer_xy_resolution[track.hits[i].get_layer()];
     }
   }
   
@@ -399,15 +226,15 @@ double NHitSeedFinder::fitTrack(SimpleTrack3D& track, vector<double>& chi2_hit)
   MatrixXf y2 = MatrixXf::Zero(track.hits.size(), 1);
   for(unsigned int i=0;i<track.hits.size();i++)
   {
-    y2(i,0) = track.hits[i].z;
+    y2(i,0) = track.hits[i].get_z();
     if((using_vertex==true ) && (i == (track.hits.size() - 1))){y2(i, 0) /= vertex_sigma_z;}
-    else{y2(i, 0) /= layer_z_resolution[track.hits[i].layer];}
+    else{y2(i, 0) /= layer_z_resolution[track.hits[i].get_layer()];}
   }
   
   MatrixXf X2 = MatrixXf::Zero(track.hits.size(), 2);
   for(unsigned int i=0;i<track.hits.size();i++)
   {
-    float D = sqrt( pow(dx - track.hits[i].x, 2) + pow(dy - track.hits[i].y,2));
+    float D = sqrt( pow(dx - track.hits[i].get_x(), 2) + pow(dy - track.hits[i].get_y(),2));
     float s = 0.0;
     
     if(0.5*k*D > 0.1)
@@ -439,8 +266,8 @@ double NHitSeedFinder::fitTrack(SimpleTrack3D& track, vector<double>& chi2_hit)
     }
     else
     {
-      X2(i, 0) /= layer_z_resolution[track.hits[i].layer];
-      X2(i, 1) /= layer_z_resolution[track.hits[i].layer];
+      X2(i, 0) /= layer_z_resolution[track.hits[i].get_layer()];
+      X2(i, 1) /= layer_z_resolution[track.hits[i].get_layer()];
     }
   }
   
@@ -476,18 +303,18 @@ double NHitSeedFinder::fitTrack(SimpleTrack3D& track, vector<double>& chi2_hit)
   float chi2_tot = 0.;
   for(unsigned int h=0;h<track.hits.size();h++)
   {
-    float dx1 = track.hits[h].x - cx;
-    float dy1 = track.hits[h].y - cy;
+    float dx1 = track.hits[h].get_x() - cx;
+    float dy1 = track.hits[h].get_y() - cy;
     
-    float dx2 = track.hits[h].x + cx;
-    float dy2 = track.hits[h].y + cy;
+    float dx2 = track.hits[h].get_x() + cx;
+    float dy2 = track.hits[h].get_y() + cy;
     
     float xydiff1 = sqrt(dx1*dx1 + dy1*dy1) - r;
     float xydiff2 = sqrt(dx2*dx2 + dy2*dy2) - r;
     float xydiff = xydiff2;
     if(fabs(xydiff1) < fabs(xydiff2)){ xydiff = xydiff1; }
     
-    float ls_xy = layer_xy_resolution[track.hits[h].layer];
+    float ls_xy = layer_xy_resolution[track.hits[h].get_layer()];
     if((using_vertex == true) && (h == (track.hits.size() - 1)))
     {
       ls_xy = vertex_sigma_xy;
@@ -2,6 +2,7 @@
 #define __NHITSEEDFINDER__
 
 #include "HelixHough.h"
+#include "LayerHitIndex.h"
 #include <vector>
 #include <set>
 #include <map>
@@ -20,7 +21,6 @@ class NHitSeedFinder : public HelixHough
     void initEvent(std::vector<SimpleHit3D>&)
     {
       combos.clear();
-      phis.clear();
     }
     
     void setUsingVertex(bool usevtx){using_vertex = usevtx;}
@@ -43,7 +43,12 @@ class NHitSeedFinder : public HelixHough
     
     void setChi2Cut(double c){chi2_cut=c;}
     
+    unsigned long long getNCombosTested(){return n_combos_tested;}
+    
   private:
+    void findNTracks(std::vector<SimpleHit3D>& hits, std::vector<SimpleTrack3D>& tracks, unsigned int n, float max_dphi);
+    void addLayerHit(std::vector<SimpleHit3D>& hits, std::vector<SimpleTrack3D>& tracks, SimpleTrack3D& temp_track, std::vector<unsigned int>& comb, unsigned int depth, int first_layer, float max_dphi);
+    
     bool using_vertex;
 		int seed_mode; //switches between fitTrack seeding algorithms
     std::vector<float> detector_radii;
@@ -52,7 +57,10 @@ class NHitSeedFinder : public HelixHough
     double vertex_sigma_xy, vertex_sigma_z;
     double chi2_cut;
     std::set<std::vector<unsigned int> > combos;
-    std::map<unsigned int, float> phis;
+    LayerHitIndex hit_index;
+    std::vector<std::vector<unsigned int> > candidates;
+    unsigned long long n_combos_tested;
+    double seed_time;
 };
 
 
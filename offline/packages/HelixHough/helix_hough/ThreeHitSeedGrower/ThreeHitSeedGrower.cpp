@@ -4,13 +4,14 @@
 #include <algorithm>
 #include <Eigen/LU>
 #include <Eigen/Core>
+#include <sys/time.h>
 
 
 using namespace std;
 using namespace Eigen;
 
 
-ThreeHitSeedGrower::ThreeHitSeedGrower(vector<float>& detrad, unsigned int n_phi, unsigned int n_d, unsigned int n_k, unsigned int n_dzdl, unsigned int n_z0, HelixResolution& min_resolution, HelixResolution& max_resolution, HelixRange& range) : HelixHough(n_phi, n_d, n_k, n_dzdl, n_z0, min_resolution, max_resolution, range), using_vertex(false), vertex_sigma_xy(0.002), vertex_sigma_z(0.005), chi2_cut(3.)
+ThreeHitSeedGrower::ThreeHitSeedGrower(vector<float>& detrad, unsigned int n_phi, unsigned int n_d, unsigned int n_k, unsigned int n_dzdl, unsigned int n_z0, HelixResolution& min_resolution, HelixResolution& max_resolution, HelixRange& range) : HelixHough(n_phi, n_d, n_k, n_dzdl, n_z0, min_resolution, max_resolution, range), using_vertex(false), vertex_sigma_xy(0.002), vertex_sigma_z(0.005), chi2_cut(3.), max_phi_sep(M_PI), search_window(0.), n_combos_tested(0), seed_time(0.)
 {
 	unsigned int n_layers = detrad.size();
 	_max_hits = n_layers + 2;
@@ -23,37 +24,59 @@ ThreeHitSeedGrower::ThreeHitSeedGrower(vector<float>& detrad, unsigned int n_phi
 
 void ThreeHitSeedGrower::findTracks(vector<SimpleHit3D>& hits, vector<SimpleTrack3D>& tracks)
 {cout<<"findTracks::entered with "<<hits.size()<<" hits"<<endl;
+  timeval t1,t2;
+  gettimeofday(&t1, NULL);
+  
+  hit_index.build(hits);
+  
   vector<double> chi2_hits;
 	double chi2;
   SimpleTrack3D temp_track;
   temp_track.hits.resize(3, hits[0]);
-  for(unsigned int i1=0;i1<hits.size();++i1)
+  vector<unsigned int> hits1, hits2, hits3;
+  int nlayers = hit_index.nLayers();
+  for(int l1=0;l1<nlayers;++l1)
   {
+  hits1.clear();
+  hit_index.layerHits(l1, hits1);
+  for(unsigned int j1=0;j1<hits1.size();++j1)
+  {
+    unsigned int i1 = hits1[j1];
     temp_track.hits[0] = hits[i1];
-    for(unsigned int i2=(i1+1);i2<hits.size();++i2)
-			{//TO DO: ADD PHICUT
-      if( (hits[i2].layer == hits[i1].layer)){continue;}
+    for(int l2=(l1+1);l2<nlayers;++l2)
+    {
+    hits2.clear();
+    hit_index.query(l2, hit_index.phi(i1), max_phi_sep, hits2);
+    for(unsigned int j2=0;j2<hits2.size();++j2)
+			{
+      unsigned int i2 = hits2[j2];
       temp_track.hits[1] = hits[i2];
-      for(unsigned int i3=(i2+1);i3<hits.size();++i3)
+      for(int l3=(l2+1);l3<nlayers;++l3)
+      {
+      hits3.clear();
+      hit_index.query(l3, hit_index.phi(i2), max_phi_sep, hits3);
+      for(unsigned int j3=0;j3<hits3.size();++j3)
       {
-        if((hits[i3].layer == hits[i2].layer) || (hits[i3].layer == hits[i1].layer)){continue;}
+        unsigned int i3 = hits3[j3];
+        if(LayerHitIndex::absDiff(hit_index.phi(i3), hit_index.phi(i1)) > max_phi_sep){continue;}
         temp_track.hits[2] = hits[i3];
 				
+				n_combos_tested += 1;
 				chi2 = fitTrack(temp_track, chi2_hits);
 				if(chi2 > chi2_cut){continue;}
 				vector<unsigned int> nhit_layer;
 				nhit_layer.assign(detector_radii.size(),0);
 				for(unsigned int ihit = 0; ihit<3;ihit++)
 					{
-						nhit_layer[temp_track.hits[ihit].layer]+=1;
+						nhit_layer[temp_track.hits[ihit].get_layer()]+=1;
 					}
 				if(GrowTrack(temp_track, nhit_layer, hits, tracks, 0) == false)
 					{//refit if track wasn't grown.
 						vector<unsigned int> tempcomb;
 						tempcomb.assign(3,0);
-						tempcomb[0] = temp_track.hits[0].index;
-						tempcomb[1] = temp_track.hits[1].index;
-						tempcomb[2] = temp_track.hits[2].index;
+						tempcomb[0] = temp_track.hits[0].get_id();
+						tempcomb[1] = temp_track.hits[1].get_id();
+						tempcomb[2] = temp_track.hits[2].get_id();
 						sort(tempcomb.begin(), tempcomb.end());
 						set<vector<unsigned int> >::iterator it = combos.find(tempcomb);
 						if(it != combos.end()){continue;}
@@ -64,8 +87,16 @@ void ThreeHitSeedGrower::findTracks(vector<SimpleHit3D>& hits, vector<SimpleTrac
 					}
 				
       }
+      }
     }
+    }
+  }
   }
+  
+  gettimeofday(&t2, NULL);
+  double time1 = ((double)(t1.tv_sec) + (double)(t1.tv_usec)/1000000.);
+  double time2 = ((double)(t2.tv_sec) + (double)(t2.tv_usec)/1000000.);
+  seed_time += (time2 - time1);
 	cout<<"leaving findTrack"<<endl;
 }
 //this is my attempt at implementation of 3 hit seeding adding hits up to 8 total
@@ -74,14 +105,21 @@ void ThreeHitSeedGrower::findTracks(vector<SimpleHit3D>& hits, vector<SimpleTrac
 //incrementally adds a hit from hits and fits it
 //tests to see if the chi squared is still in bound 
 //recursively calls grow track on newly accepted track and adds it to tracks.
+//only the hits in a window around the projection of the seed onto the
+//layers that can still take a hit are tried
 //
 bool ThreeHitSeedGrower::GrowTrack(SimpleTrack3D seed_track, vector<unsigned int>& nhit_layer, vector<SimpleHit3D>& hits, vector<SimpleTrack3D>& tracks, unsigned int c_hit){
 	unsigned int init_size = seed_track.hits.size();
 	vector<double> chi2_hits;
 	double chi2;
 	bool hit_added;
-	while(c_hit < hits.size())
+	vector<unsigned int> candidates;
+	findGrowCandidates(seed_track, nhit_layer, candidates);
+	vector<unsigned int>::iterator cand = lower_bound(candidates.begin(), candidates.end(), c_hit);
+	for(;cand != candidates.end();++cand)
 		{
+			c_hit = *cand;
+			n_combos_tested += 1;
 			hit_added = addOneHit(seed_track, nhit_layer, c_hit, hits);
 			c_hit+=1;
 			if(hit_added == false)
@@ -98,7 +136,7 @@ bool ThreeHitSeedGrower::GrowTrack(SimpleTrack3D seed_track, vector<unsigned int
 			vector<unsigned int> tempcomb;
 			tempcomb.assign(seed_track.hits.size(),0);
 			for(unsigned int ihit = 0; ihit < seed_track.hits.size();ihit++)
-				tempcomb[ihit] = seed_track.hits[ihit].index;
+				tempcomb[ihit] = seed_track.hits[ihit].get_id();
 			sort(tempcomb.begin(), tempcomb.end());
 			set<vector<unsigned int> >::iterator it = combos.find(tempcomb);
 			if(it != combos.end()){
@@ -113,17 +151,72 @@ bool ThreeHitSeedGrower::GrowTrack(SimpleTrack3D seed_track, vector<unsigned int
 	return false;
 }
 
+// positions in the hit vector of the hits close to where seed_track
+// crosses the layers that can still take a hit, sorted
+void ThreeHitSeedGrower::findGrowCandidates(SimpleTrack3D& seed_track, vector<unsigned int>& nhit_layer, vector<unsigned int>& candidates)
+{
+  candidates.clear();
+  
+  float k = seed_track.kappa;
+  float r = 0.;
+  if(k > 1.0e-6){r = 1./k;}
+  // signed distance of the circle center from the origin
+  float cd = seed_track.d + r;
+  float cphi = seed_track.phi;
+  if(cd < 0.)
+  {
+    cd = -cd;
+    cphi += M_PI;
+  }
+  // side of the center line the seed hits are on
+  float hphi = atan2(seed_track.hits[0].get_y(), seed_track.hits[0].get_x());
+  float side = sin(hphi - cphi) < 0. ? -1. : 1.;
+  float dx = seed_track.d*cos(seed_track.phi);
+  float dy = seed_track.d*sin(seed_track.phi);
+  float slope = seed_track.dzdl/sqrt(1. - seed_track.dzdl*seed_track.dzdl);
+  
+  for(unsigned int l=0;l<nhit_layer.size();++l)
+  {
+    if( !(nhit_layer[l] == 0 || (nhit_layer[l] == 1  && l >1)) ){continue;}
+    
+    float R = detector_radii[l];
+    float cos_a = 2.;
+    if((search_window > 0.) && (r > 0.) && (cd > 0.)){cos_a = (R*R + cd*cd - r*r)/(2.*R*cd);}
+    if(fabs(cos_a) > 1.)
+    {
+      // no window, try the whole layer
+      hit_index.layerHits(l, candidates);
+      continue;
+    }
+    float phi = cphi + side*acos(cos_a);
+    float px = R*cos(phi);
+    float py = R*sin(phi);
+    
+    // path length as in fitTrack
+    float D = sqrt( (dx - px)*(dx - px) + (dy - py)*(dy - py) );
+    float v = 0.5*k*D;
+    if(v >= 0.999999){v = 0.999999;}
+    float s = 2.*asin(v)/k;
+    float z = seed_track.z0 + s*slope;
+    
+    float dphi = search_window*layer_xy_resolution[l]/R;
+    float dz = search_window*layer_z_resolution[l];
+    hit_index.query(l, atan2(py, px), dphi, z - dz, z + dz, candidates);
+  }
+  sort(candidates.begin(), candidates.end());
+}
+
 bool ThreeHitSeedGrower::addOneHit(SimpleTrack3D & seed_track, vector<unsigned int> & nhit_layer, unsigned int c_hit, vector<SimpleHit3D>& hits) 
 {//cout<<"addOneHit::newly entered"<<endl;
 	for(unsigned int ihit =0; ihit<seed_track.hits.size();ihit++)
 		{
-			//	cout<<"addOneHit::hit: "<<ihit<<" index = "<<seed_track.hits[ihit].index<<endl;
-			if(seed_track.hits[ihit].index == hits[c_hit].index)
+			//	cout<<"addOneHit::hit: "<<ihit<<" index = "<<seed_track.hits[ihit].get_id()<<endl;
+			if(seed_track.hits[ihit].get_id() == hits[c_hit].get_id())
 			return false;
 		}
-	//	cout<<"addOneHit::hit: "<<c_hit<<" passed with index = "<<hits[c_hit].index<<endl;
+	//	cout<<"addOneHit::hit: "<<c_hit<<" passed with index = "<<hits[c_hit].get_id()<<endl;
   //this conditional logic specifically applies to the VTX, maybe modularize this later.                                   
-	if(nhit_layer[hits[c_hit].layer] == 0 || (nhit_layer[hits[c_hit].layer] == 1  && hits[c_hit].layer >1)){
+	if(nhit_layer[hits[c_hit].get_layer()] == 0 || (nhit_layer[hits[c_hit].get_layer()] == 1  && hits[c_hit].get_layer() >1)){
 		vector<double> chi2_hits;
 		double chi2;
 		seed_track.hits.push_back(hits[c_hit]);
@@ -131,7 +224,7 @@ bool ThreeHitSeedGrower::addOneHit(SimpleTrack3D & seed_track, vector<unsigned i
 		if(chi2 <= chi2_cut)
 			{
 				return true;
-				nhit_layer[hits[c_hit].layer]+=1;;
+				nhit_layer[hits[c_hit].get_layer()]+=1;;
 			}
 		else
 			seed_track.hits.pop_back();
@@ -146,6 +239,14 @@ void ThreeHitSeedGrower::finalize(vector<SimpleTrack3D>& input, vector<SimpleTra
   {
     output.push_back(input[i]);
   }
+  
+  if(print_timings == true)
+  {
+    cout << "seed time = " << seed_time << endl;
+    cout << "combinations tested = " << n_combos_tested;
+    if(seed_time > 0.) cout << " (" << ((double)n_combos_tested)/seed_time << " /s)";
+    cout << endl;
+  }
 }
 
 
@@ -153,7 +254,9 @@ double ThreeHitSeedGrower::fitTrack(SimpleTrack3D & track, vector<double>& chi2_
 {
   if(using_vertex == true)
   {
-    track.hits.push_back(SimpleHit3D(0.,0., 0.,0., 0.,0., 0, 0));
+    SimpleHit3D vertex_hit;
+    vertex_hit.set_layer(0);
+    track.hits.push_back(vertex_hit);
   }
   
   chi2_hit.clear();
@@ -162,16 +265,16 @@ double ThreeHitSeedGrower::fitTrack(SimpleTrack3D & track, vector<double>& chi2_
   MatrixXf y = MatrixXf::Zero(track.hits.size(), 1);
   for(unsigned int i=0;i<track.hits.size();i++)
   {
-    y(i, 0) = ( pow(track.hits[i].x,2) + pow(track.hits[i].y,2) );
+    y(i, 0) = ( pow(track.hits[i].get_x(),2) + pow(track.hits[i].get_y(),2) );
     if((using_vertex==true ) && (i == (track.hits.size() - 1))){y(i, 0) /= vertex_sigma_xy;}
-    else{y(i, 0) /= layer_xy_resolution[track.hits[i].layer];}
+    else{y(i, 0) /= layer_xy_resolution[track.hits[i].get_layer()];}
   }
   
   MatrixXf X = MatrixXf::Zero(track.hits.size(), 3);
   for(unsigned int i=0;i<track.hits.size();i++)
   {
-    X(i, 0) = track.hits[i].x;
-    X(i, 1) = track.hits[i].y;
+    X(i, 0) = track.hits[i].get_x();
+    X(i, 1) = track.hits[i].get_y();
     X(i, 2) = -1.;
     if((using_vertex==true ) && (i == (track.hits.size() - 1)))
     {
@@ -181,9 +284,9 @@ double ThreeHitSeedGrower::fitTrack(SimpleTrack3D & track, vector<double>& chi2_
     }
     else
     {
-      X(i, 0) /= layer_xy_resolution[track.hits[i].layer];
-      X(i, 1) /= layer_xy_resolution[track.hits[i].layer];
-      X(i, 2) /= layer_xy_resolution[track.hits[i].layer];
+      X(i, 0) /= layer_xy_resolution[track.hits[i].get_layer()];
+      X(i, 1) /= layer_xy_resolution[track.hits[i].get_layer()];
+      X(i, 2) /= layer_xy_resolution[track.hits[i].get_layer()];
     }
   }
   
@@ -211,15 +314,15 @@ double ThreeHitSeedGrower::fitTrack(SimpleTrack3D & track, vector<double>& chi2_
   MatrixXf y2 = MatrixXf::Zero(track.hits.size(), 1);
   for(unsigned int i=0;i<track.hits.size();i++)
   {
-    y2(i,0) = track.hits[i].z;
+    y2(i,0) = track.hits[i].get_z();
     if((using_vertex==true ) && (i == (track.hits.size() - 1))){y2(i, 0) /= vertex_sigma_z;}
-    else{y2(i, 0) /= layer_z_resolution[track.hits[i].layer];}
+    else{y2(i, 0) /= layer_z_resolution[track.hits[i].get_layer()];}
   }
   
   MatrixXf X2 = MatrixXf::Zero(track.hits.size(), 2);
   for(unsigned int i=0;i<track.hits.size();i++)
   {
-    float D = sqrt( pow(dx - track.hits[i].x, 2) + pow(dy - track.hits[i].y,2));
+    float D = sqrt( pow(dx - track.hits[i].get_x(), 2) + pow(dy - track.hits[i].get_y(),2));
     float s = 0.0;
     
     if(0.5*k*D > 0.1)
@@ -251,8 +354,8 @@ double ThreeHitSeedGrower::fitTrack(SimpleTrack3D & track, vector<double>& chi2_
     }
     else
     {
-      X2(i, 0) /= layer_z_resolution[track.hits[i].layer];
-      X2(i, 1) /= layer_z_resolution[track.hits[i].layer];
+      X2(i, 0) /= layer_z_resolution[track.hits[i].get_layer()];
+      X2(i, 1) /= layer_z_resolution[track.hits[i].get_layer()];
     }
   }
   
@@ -288,18 +391,18 @@ double ThreeHitSeedGrower::fitTrack(SimpleTrack3D & track, vector<double>& chi2_
   float chi2_tot = 0.;
   for(unsigned int h=0;h<track.hits.size();h++)
   {
-    float dx1 = track.hits[h].x - cx;
-    float dy1 = track.hits[h].y - cy;
+    float dx1 = track.hits[h].get_x() - cx;
+    float dy1 = track.hits[h].get_y() - cy;
     
-    float dx2 = track.hits[h].x + cx;
-    float dy2 = track.hits[h].y + cy;
+    float dx2 = track.hits[h].get_x() + cx;
+    float dy2 = track.hits[h].get_y() + cy;
     
     float xydiff1 = sqrt(dx1*dx1 + dy1*dy1) - r;
     float xydiff2 = sqrt(dx2*dx2 + dy2*dy2) - r;
     float xydiff = xydiff2;
     if(fabs(xydiff1) < fabs(xydiff2)){ xydiff = xydiff1; }
     
-    float ls_xy = layer_xy_resolution[track.hits[h].layer];
+    float ls_xy = layer_xy_resolution[track.hits[h].get_layer()];
     if((using_vertex == true) && (h == (track.hits.size() - 1)))
     {
       ls_xy = vertex_sigma_xy;
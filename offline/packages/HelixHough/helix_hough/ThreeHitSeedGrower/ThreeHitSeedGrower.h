@@ -2,6 +2,7 @@
 #define __THREEHITSEEDGROWER__
 
 #include "HelixHough.h"
+#include "LayerHitIndex.h"
 #include <vector>
 #include <set>
 
@@ -41,7 +42,18 @@ class ThreeHitSeedGrower : public HelixHough
     
     void setChi2Cut(double c){chi2_cut=c;}
     
+    // largest phi difference between the 3 seed hits, no cut by default
+    void setMaxPhiSeparation(float dphi){max_phi_sep = dphi;}
+    
+    // half width of the window searched for new hits by GrowTrack, in
+    // units of the layer resolutions. 0 (default) tries every hit
+    void setSearchWindow(float nsigma){search_window = nsigma;}
+    
+    unsigned long long getNCombosTested(){return n_combos_tested;}
+    
   private:
+    void findGrowCandidates(SimpleTrack3D& seed_track, std::vector<unsigned int>& nhit_layer, std::vector<unsigned int>& candidates);
+    
     bool using_vertex;
     std::vector<float> detector_radii;
     std::vector<float> layer_xy_resolution;
@@ -50,6 +62,11 @@ class ThreeHitSeedGrower : public HelixHough
     double chi2_cut;
 		unsigned int _max_hits;
     std::set<std::vector<unsigned int> > combos; 
+    float max_phi_sep;
+    float search_window;
+    LayerHitIndex hit_index;
+    unsigned long long n_combos_tested;
+    double seed_time;
 };
 
 
@@ -13,6 +13,9 @@ using namespace std;
 using namespace Eigen;
 using namespace SeamStress;
 
+// number of track candidates per call of the batched fast fit
+static const unsigned int fit_batch_size = 256;
+
 class hit_triplet {
  public:
   hit_triplet(unsigned int h1, unsigned int h2, unsigned int h3, unsigned int t,
@@ -166,7 +169,12 @@ sPHENIXTracker::sPHENIXTracker(unsigned int n_phi, unsigned int n_d,
       prev_p_inv(0.),
       seed_layer(0),
       ca_chi2_cut(2.0),
-      cosang_cut(0.985) {
+      cosang_cut(0.985),
+      ca_nsectors(1),
+      ca_hits(NULL),
+      ca_ncells(0),
+      ca_nlinks(0),
+      ca_nchains(0) {
   vector<float> detector_material;
 
   for (unsigned int i = 0; i < radius.size(); ++i) {
@@ -231,7 +239,12 @@ sPHENIXTracker::sPHENIXTracker(vector<vector<unsigned int> >& zoom_profile,
       is_parallel(parallel),
       is_thread(false),
       ca_chi2_cut(2.0),
-      cosang_cut(0.985) {
+      cosang_cut(0.985),
+      ca_nsectors(1),
+      ca_hits(NULL),
+      ca_ncells(0),
+      ca_nlinks(0),
+      ca_nchains(0) {
   vector<float> detector_material;
 
   for (unsigned int i = 0; i < radius.size(); ++i) {
@@ -483,6 +496,16 @@ void sPHENIXTracker::finalize(vector<SimpleTrack3D>& input,
     cout << "findTracks called " << findtracksiter << " times" << endl;
     cout << "CAtime = " << CAtime << endl;
     cout << "KALime = " << KALtime << endl;
+    if (ca_ncells > 0) {
+      cout << "CA cells = " << ca_ncells << ", links = " << ca_nlinks
+           << ", chains = " << ca_nchains << endl;
+    }
+    cout << "batch fits = " << fit_batch.getNFitted();
+    if (fit_batch.getFitTime() > 0.) {
+      cout << " (" << fit_batch.getNFitted() / fit_batch.getFitTime()
+           << " candidates/s)";
+    }
+    cout << endl;
   }
 }
 
@@ -786,6 +809,47 @@ float sPHENIXTracker::fitTrack(SimpleTrack3D& track, vector<float>& chi2_hit) {
   return (chi2_tot) / ((float)(deg_of_freedom));
 }
 
+void sPHENIXTracker::fitTracks(vector<SimpleTrack3D>& tracks,
+                               vector<float>& chi2) {
+  chi2.assign(tracks.size(), 0.);
+
+  // candidates with the same number of hits are fitted together
+  map<unsigned int, vector<unsigned int> > by_nhits;
+  for (unsigned int i = 0; i < tracks.size(); ++i) {
+    if (tracks[i].hits.size() < 3) {
+      chi2[i] = fitTrack(tracks[i]);
+      continue;
+    }
+    by_nhits[tracks[i].hits.size()].push_back(i);
+  }
+
+  vector<float> xyres;
+  vector<float> zres;
+  for (map<unsigned int, vector<unsigned int> >::iterator it =
+           by_nhits.begin();
+       it != by_nhits.end(); ++it) {
+    unsigned int nhits = it->first;
+    vector<unsigned int>& indices = it->second;
+    fit_batch.reset(nhits);
+    xyres.resize(nhits);
+    zres.resize(nhits);
+    for (unsigned int j = 0; j < indices.size(); ++j) {
+      SimpleTrack3D& track = tracks[indices[j]];
+      // same resolutions as in fitTrack
+      for (unsigned int i = 0; i < nhits; i++) {
+        xyres[i] = sqrt((0.5*sqrt(12.)*sqrt(track.hits[i].get_size(0,0))) * (0.5*sqrt(12.)*sqrt(track.hits[i].get_size(0,0))) +
+                        (0.5*sqrt(12.)*sqrt(track.hits[i].get_size(1,1))) * (0.5*sqrt(12.)*sqrt(track.hits[i].get_size(1,1))));
+        zres[i] = (0.5*sqrt(12.)*sqrt(track.hits[i].get_size(2,2)));
+      }
+      fit_batch.addTrack(track, &xyres[0], &zres[0]);
+    }
+    fit_batch.fit();
+    for (unsigned int j = 0; j < indices.size(); ++j) {
+      chi2[indices[j]] = fit_batch.getTrack(j, tracks[indices[j]]);
+    }
+  }
+}
+
 void sPHENIXTracker::calculateKappaTangents(
     float* x1_a, float* y1_a, float* z1_a, float* x2_a, float* y2_a,
     float* z2_a, float* x3_a, float* y3_a, float* z3_a, float* dx1_a,
@@ -1625,36 +1689,61 @@ void sPHENIXTracker::findTracksBySegments(vector<SimpleHit3D>& hits,
   SimpleTrack3D temp_track;
   temp_track.hits.assign(n_layers, SimpleHit3D());
   vector<SimpleHit3D> temp_hits;
-  for (unsigned int i = 0, sizei = curseg_size; i < sizei; ++i) {
-    temp_track.hits.assign((*cur_seg)[i].n_hits, SimpleHit3D());
+  vector<SimpleTrack3D> candidates;
+  unsigned int i = 0;
+  while (i < curseg_size) {
+    // collect a batch of candidates for the fast fit
+    candidates.clear();
+    for (; (i < curseg_size) && (candidates.size() < fit_batch_size); ++i) {
+      temp_track.hits.assign((*cur_seg)[i].n_hits, SimpleHit3D());
+
+      temp_comb.assign((*cur_seg)[i].n_hits, 0);
+      for (unsigned int l = 0; l < (*cur_seg)[i].n_hits; ++l) {
+        temp_comb[l] = layer_sorted[l][(*cur_seg)[i].hits[l]].get_id();
+      }
+      sort(temp_comb.begin(), temp_comb.end());
+      set<vector<unsigned int> >::iterator it = combos.find(temp_comb);
+      if (it != combos.end()) {
+        continue;
+      }
+      if (combos.size() > 10000) {
+        combos.clear();
+      }
+      combos.insert(temp_comb);
 
-    temp_comb.assign((*cur_seg)[i].n_hits, 0);
-    for (unsigned int l = 0; l < (*cur_seg)[i].n_hits; ++l) {
-      temp_comb[l] = layer_sorted[l][(*cur_seg)[i].hits[l]].get_id();
-    }
-    sort(temp_comb.begin(), temp_comb.end());
-    set<vector<unsigned int> >::iterator it = combos.find(temp_comb);
-    if (it != combos.end()) {
-      continue;
-    }
-    if (combos.size() > 10000) {
-      combos.clear();
+      for (unsigned int l = 0; l < (*cur_seg)[i].n_hits; ++l) {
+        temp_track.hits[l] = layer_sorted[l][(*cur_seg)[i].hits[l]];
+      }
+      candidates.push_back(temp_track);
     }
-    combos.insert(temp_comb);
 
-    for (unsigned int l = 0; l < (*cur_seg)[i].n_hits; ++l) {
-      temp_track.hits[l] = layer_sorted[l][(*cur_seg)[i].hits[l]];
-    }
+    acceptCandidates(candidates, tracks);
+  }
+}
 
-    gettimeofday(&t1, NULL);
+// fast fit of the candidates, then a kalman fit of the ones passing the
+// fast chi2 cut. The candidates passing all cuts are added to tracks, their
+// kalman states to track_states
+void sPHENIXTracker::acceptCandidates(vector<SimpleTrack3D>& candidates,
+                                      vector<SimpleTrack3D>& tracks) {
+  timeval t1, t2;
+  double time1 = 0.;
+  double time2 = 0.;
+  vector<float> candidate_chi2;
 
-    // unsigned int layer_out = temp_track.hits.size()-1;
-    // unsigned int layer_mid = layer_out/2;
-    // temp_track_3hits.hits[0] = temp_track.hits[0];
-    // temp_track_3hits.hits[1] = temp_track.hits[layer_mid];
-    // temp_track_3hits.hits[2] = temp_track.hits[layer_out];
+  gettimeofday(&t1, NULL);
+  fitTracks(candidates, candidate_chi2);
+  gettimeofday(&t2, NULL);
+  time1 = ((double)(t1.tv_sec) + (double)(t1.tv_usec) / 1000000.);
+  time2 = ((double)(t2.tv_sec) + (double)(t2.tv_usec) / 1000000.);
+  KALtime += (time2 - time1);
 
-    float init_chi2 = fitTrack(temp_track);
+  for (unsigned int c = 0; c < candidates.size(); ++c) {
+    SimpleTrack3D& temp_track = candidates[c];
+
+    gettimeofday(&t1, NULL);
+
+    float init_chi2 = candidate_chi2[c];
 
     if (init_chi2 > fast_chi2_cut_max) {
       if (init_chi2 > fast_chi2_cut_par0 +
@@ -1736,7 +1825,6 @@ void sPHENIXTracker::findTracksBySegments(vector<SimpleHit3D>& hits,
 }
 
 
-
 static inline double sign(double x) {
   return ((double)(x > 0.)) - ((double)(x < 0.));
 }
@@ -2,6 +2,8 @@
 #define __SPHENIXTRACKER__
 
 #include "HelixHough.h"
+#include "HelixFitBatch.h"
+#include "LayerHitIndex.h"
 #include <vector>
 #include <set>
 #include <map>
@@ -184,6 +186,36 @@ class TrackSegment {
   unsigned int n_hits;
 };
 
+// doublet of hits on two layers, the cells of the cellular automaton seeding
+class CACell {
+ public:
+  CACell()
+      : inner(0), outer(0), inner_layer(0), sector(0), ux(0.), uy(0.),
+        dzdl(0.), ddzdl(0.), state(1) {}
+  ~CACell() {}
+
+  unsigned int inner, outer;  // positions in the hit vector
+  unsigned int inner_layer;
+  unsigned int sector;  // phi sector of the inner hit
+  float ux, uy;         // xy direction from the inner to the outer hit
+  float dzdl, ddzdl;
+  unsigned int state;  // number of cells in the longest chain ending here
+};
+
+// compatible pair of cells sharing a hit, the triplet curvature is kept
+// for the chain extraction
+class CALink {
+ public:
+  CALink() : cell(0), neighbor(0), kappa(0.) {}
+  CALink(unsigned int c, unsigned int n, float k)
+      : cell(c), neighbor(n), kappa(k) {}
+  ~CALink() {}
+
+  unsigned int cell;
+  unsigned int neighbor;  // the inner cell
+  float kappa;
+};
+
 class sPHENIXTracker : public HelixHough {
  public:
   sPHENIXTracker(unsigned int n_phi, unsigned int n_d, unsigned int n_k,
@@ -210,6 +242,17 @@ class sPHENIXTracker : public HelixHough {
                             std::vector<SimpleTrack3D>& tracks,
                             const HelixRange& range);
 
+  /// alternative to findHelices: seeds with a cellular automaton on the
+  /// layered hit graph instead of the Hough zooming, the doublet and
+  /// triplet building is split over phi sectors and runs on the worker
+  /// threads of a parallel tracker. The chains are fitted and selected
+  /// like the segments of findTracksBySegments
+  void findHelicesCA(std::vector<SimpleHit3D>& hits, unsigned int min_hits,
+                     unsigned int max_hits,
+                     std::vector<SimpleTrack3D>& tracks,
+                     unsigned int maxtracks = 0);
+  void setCASectors(unsigned int n) { ca_nsectors = (n > 0 ? n : 1); }
+
   void initEvent(std::vector<SimpleHit3D>& hits, unsigned int min_hits) {
     int min_layer = 999999;
     int max_layer = 0;
@@ -273,6 +316,9 @@ class sPHENIXTracker : public HelixHough {
 
   static float fitTrack(SimpleTrack3D& track);
   static float fitTrack(SimpleTrack3D& track, std::vector<float>& chi2_hit);
+  /// fits all tracks with the batched fitter, chi2[i] is the chi2/ndf
+  /// fitTrack() would return for tracks[i]
+  void fitTracks(std::vector<SimpleTrack3D>& tracks, std::vector<float>& chi2);
 
   void setVerbosity(int v) { verbosity = v; }
 
@@ -469,6 +515,17 @@ class sPHENIXTracker : public HelixHough {
   void findHelicesParallelThread(void* arg);
   void splitHitsParallelThread(void* arg);
 
+  void acceptCandidates(std::vector<SimpleTrack3D>& candidates,
+                        std::vector<SimpleTrack3D>& tracks);
+
+  // cellular automaton seeding, sPHENIXTracker_CA.cpp
+  void caDoublets(unsigned int first_sector, unsigned int stride);
+  void caLinks(unsigned int first_sector, unsigned int stride);
+  void caDoubletsThread(void* arg);
+  void caLinksThread(void* arg);
+  void caChains(unsigned int min_hits, unsigned int max_hits,
+                std::vector<SimpleTrack3D>& tracks, unsigned int maxtracks);
+
   void initDummyHits(std::vector<SimpleHit3D>& dummies, const HelixRange& range,
                      HelixKalmanState& init_state);
 
@@ -535,6 +592,8 @@ class sPHENIXTracker : public HelixHough {
   
   double CAtime;
   double KALtime;
+
+  HelixFitBatch fit_batch;
   
   std::vector<std::vector<SimpleHit3D> > layer_sorted_1[4];
   unsigned int findtracks_bin;
@@ -543,6 +602,22 @@ class sPHENIXTracker : public HelixHough {
   float cosang_cut;
   
   std::vector<float> hit_error_scale;
+
+  // cellular automaton seeding
+  unsigned int ca_nsectors;
+  std::vector<SimpleHit3D>* ca_hits;
+  LayerHitIndex ca_index;
+  std::vector<std::vector<unsigned int> > ca_sector_hits;
+  std::vector<std::vector<CACell> > ca_sector_cells;
+  std::vector<std::vector<CALink> > ca_thread_links;
+  std::vector<CACell> ca_cells;
+  std::vector<unsigned int> ca_outer_offsets;  // cells by outer hit
+  std::vector<unsigned int> ca_outer_cells;
+  std::vector<unsigned int> ca_link_offsets;   // links by cell
+  std::vector<CALink> ca_links;
+  unsigned long long ca_ncells;
+  unsigned long long ca_nlinks;
+  unsigned long long ca_nchains;
 };
 
 
@@ -13,6 +13,9 @@ using namespace std;
 using namespace Eigen;
 using namespace SeamStress;
 
+// number of track candidates per call of the batched fast fit
+static const unsigned int fit_batch_size = 256;
+
 class hitTriplet {
 public:
   hitTriplet(unsigned int h1, unsigned int h2, unsigned int h3, unsigned int t,
@@ -410,6 +413,12 @@ void sPHENIXTrackerTPC::finalize(vector<SimpleTrack3D>& input,
     cout << "findTracks called " << findtracksiter << " times" << endl;
     cout << "CAtime = " << CAtime << endl;
     cout << "KALime = " << KALtime << endl;
+    cout << "batch fits = " << fit_batch.getNFitted();
+    if (fit_batch.getFitTime() > 0.) {
+      cout << " (" << fit_batch.getNFitted() / fit_batch.getFitTime()
+           << " candidates/s)";
+    }
+    cout << endl;
   }
 }
 
@@ -699,6 +708,57 @@ float sPHENIXTrackerTPC::fitTrack(SimpleTrack3D& track,
   return (chi2_tot) / ((float)(deg_of_freedom));
 }
 
+void sPHENIXTrackerTPC::fitTracks(vector<SimpleTrack3D>& tracks,
+                                  vector<float>& chi2,
+                                  float scale) {
+  chi2.assign(tracks.size(), 0.);
+
+  // candidates with the same number of hits are fitted together
+  map<unsigned int, vector<unsigned int> > by_nhits;
+  for (unsigned int i = 0; i < tracks.size(); ++i) {
+    if (tracks[i].hits.size() < 3) {
+      chi2[i] = fitTrack(tracks[i], scale);
+      continue;
+    }
+    by_nhits[tracks[i].hits.size()].push_back(i);
+  }
+
+  vector<float> xyres;
+  vector<float> zres;
+  for (map<unsigned int, vector<unsigned int> >::iterator it =
+           by_nhits.begin();
+       it != by_nhits.end(); ++it) {
+    unsigned int nhits = it->first;
+    vector<unsigned int>& indices = it->second;
+    fit_batch.reset(nhits);
+    xyres.resize(nhits);
+    zres.resize(nhits);
+    for (unsigned int j = 0; j < indices.size(); ++j) {
+      SimpleTrack3D& track = tracks[indices[j]];
+      // same resolutions as in fitTrack
+      for (unsigned int i = 0; i < nhits; i++) {
+        float ex = (2.0*sqrt(track.hits[i].get_size(0,0))) * scale;
+        float ey = (2.0*sqrt(track.hits[i].get_size(1,1))) * scale;
+        float ez = (2.0*sqrt(track.hits[i].get_size(2,2))) * scale;
+
+        if (track.hits[i].get_layer() < 0) {
+          ex = 0.0001 * scale;
+          ey = 0.0001 * scale;
+          ez = 0.0001 * scale;
+        }
+
+        xyres[i] = sqrt( ex * ex + ey * ey );
+        zres[i] = ez;
+      }
+      fit_batch.addTrack(track, &xyres[0], &zres[0]);
+    }
+    fit_batch.fit();
+    for (unsigned int j = 0; j < indices.size(); ++j) {
+      chi2[indices[j]] = fit_batch.getTrack(j, tracks[indices[j]]);
+    }
+  }
+}
+
 void sPHENIXTrackerTPC::initSplitting(vector<SimpleHit3D>& hits,
                                       unsigned int min_hits,
                                       unsigned int max_hits) {
@@ -1444,103 +1504,122 @@ void sPHENIXTrackerTPC::findTracksBySegments(vector<SimpleHit3D>& hits,
   SimpleTrack3D temp_track;
   temp_track.hits.assign(n_layers, SimpleHit3D());
   vector<SimpleHit3D> temp_hits;
-  for (unsigned int i = 0, sizei = curseg_size; i < sizei; ++i) {
-    temp_track.hits.assign((*cur_seg)[i].n_hits, SimpleHit3D());
-
-    temp_comb.assign((*cur_seg)[i].n_hits, 0);
-    for (unsigned int l = 0; l < (*cur_seg)[i].n_hits; ++l) {
-      temp_comb[l] = layer_sorted[l][(*cur_seg)[i].hits[l]].get_id();
-    }
-    sort(temp_comb.begin(), temp_comb.end());
-    set<vector<unsigned int> >::iterator it = combos.find(temp_comb);
-    if (it != combos.end()) {
-      continue;
-    }
-    if (combos.size() > 10000) {
-      combos.clear();
-    }
-    combos.insert(temp_comb);
-
-    for (unsigned int l = 0; l < (*cur_seg)[i].n_hits; ++l) {
-      temp_track.hits[l] = layer_sorted[l][(*cur_seg)[i].hits[l]];
-    }
-
-    gettimeofday(&t1, NULL);
-
-    float init_chi2 = fitTrack(temp_track);
-
-    if (init_chi2 > fast_chi2_cut_max) {
-      if (init_chi2 > fast_chi2_cut_par0 +
-                          fast_chi2_cut_par1 / kappaToPt(temp_track.kappa)) {
-        gettimeofday(&t2, NULL);
-        time1 = ((double)(t1.tv_sec) + (double)(t1.tv_usec) / 1000000.);
-        time2 = ((double)(t2.tv_sec) + (double)(t2.tv_usec) / 1000000.);
-        KALtime += (time2 - time1);
+  vector<SimpleTrack3D> candidates;
+  vector<float> candidate_chi2;
+  unsigned int i = 0;
+  while (i < curseg_size) {
+    // collect a batch of candidates for the fast fit
+    candidates.clear();
+    for (; (i < curseg_size) && (candidates.size() < fit_batch_size); ++i) {
+      temp_track.hits.assign((*cur_seg)[i].n_hits, SimpleHit3D());
+
+      temp_comb.assign((*cur_seg)[i].n_hits, 0);
+      for (unsigned int l = 0; l < (*cur_seg)[i].n_hits; ++l) {
+        temp_comb[l] = layer_sorted[l][(*cur_seg)[i].hits[l]].get_id();
+      }
+      sort(temp_comb.begin(), temp_comb.end());
+      set<vector<unsigned int> >::iterator it = combos.find(temp_comb);
+      if (it != combos.end()) {
         continue;
       }
-    }
-    HelixKalmanState state;
-    state.phi = temp_track.phi;
-    if (state.phi < 0.) {
-      state.phi += 2. * M_PI;
-    }
-    state.d = temp_track.d;
-    state.kappa = temp_track.kappa;
-    state.nu = sqrt(state.kappa);
-    state.z0 = temp_track.z0;
-    state.dzdl = temp_track.dzdl;
-    state.C = Matrix<float, 5, 5>::Zero(5, 5);
-    state.C(0, 0) = pow(0.01, 2.);
-    state.C(1, 1) = pow(0.01, 2.);
-    state.C(2, 2) = pow(0.01 * state.nu, 2.);
-    state.C(3, 3) = pow(0.05, 2.);
-    state.C(4, 4) = pow(0.05, 2.);
-    state.chi2 = 0.;
-    state.position = 0;
-    state.x_int = 0.;
-    state.y_int = 0.;
-    state.z_int = 0.;
-    for (unsigned int h = 0; h < temp_track.hits.size(); ++h) {
-      kalman->addHit(temp_track.hits[h], state);
-      nfits += 1;
-    }
+      if (combos.size() > 10000) {
+        combos.clear();
+      }
+      combos.insert(temp_comb);
 
-    // fudge factor for non-gaussian hit sizes
-           state.C *= 3.;
-    state.chi2 *= 6.;
+      for (unsigned int l = 0; l < (*cur_seg)[i].n_hits; ++l) {
+        temp_track.hits[l] = layer_sorted[l][(*cur_seg)[i].hits[l]];
+      }
+      candidates.push_back(temp_track);
+    }
 
+    gettimeofday(&t1, NULL);
+    fitTracks(candidates, candidate_chi2);
     gettimeofday(&t2, NULL);
     time1 = ((double)(t1.tv_sec) + (double)(t1.tv_usec) / 1000000.);
     time2 = ((double)(t2.tv_sec) + (double)(t2.tv_usec) / 1000000.);
     KALtime += (time2 - time1);
 
-    if (!(temp_track.kappa == temp_track.kappa)) {
-      continue;
-    }
-    if (temp_track.kappa > top_range.max_k) {
-      continue;
-    }
-    if (!(state.chi2 == state.chi2)) {
-      continue;
-    }
-    if (state.chi2 / (2. * ((float)(temp_track.hits.size())) - 5.) > chi2_cut) {
-      continue;
-    }
+    for (unsigned int c = 0; c < candidates.size(); ++c) {
+      SimpleTrack3D& temp_track = candidates[c];
+
+      gettimeofday(&t1, NULL);
+
+      float init_chi2 = candidate_chi2[c];
 
-    if (cut_on_dca == true) {
-      if (fabs(temp_track.d) > dca_cut) {
+      if (init_chi2 > fast_chi2_cut_max) {
+        if (init_chi2 > fast_chi2_cut_par0 +
+                            fast_chi2_cut_par1 / kappaToPt(temp_track.kappa)) {
+          gettimeofday(&t2, NULL);
+          time1 = ((double)(t1.tv_sec) + (double)(t1.tv_usec) / 1000000.);
+          time2 = ((double)(t2.tv_sec) + (double)(t2.tv_usec) / 1000000.);
+          KALtime += (time2 - time1);
+          continue;
+        }
+      }
+      HelixKalmanState state;
+      state.phi = temp_track.phi;
+      if (state.phi < 0.) {
+        state.phi += 2. * M_PI;
+      }
+      state.d = temp_track.d;
+      state.kappa = temp_track.kappa;
+      state.nu = sqrt(state.kappa);
+      state.z0 = temp_track.z0;
+      state.dzdl = temp_track.dzdl;
+      state.C = Matrix<float, 5, 5>::Zero(5, 5);
+      state.C(0, 0) = pow(0.01, 2.);
+      state.C(1, 1) = pow(0.01, 2.);
+      state.C(2, 2) = pow(0.01 * state.nu, 2.);
+      state.C(3, 3) = pow(0.05, 2.);
+      state.C(4, 4) = pow(0.05, 2.);
+      state.chi2 = 0.;
+      state.position = 0;
+      state.x_int = 0.;
+      state.y_int = 0.;
+      state.z_int = 0.;
+      for (unsigned int h = 0; h < temp_track.hits.size(); ++h) {
+        kalman->addHit(temp_track.hits[h], state);
+        nfits += 1;
+      }
+
+      // fudge factor for non-gaussian hit sizes
+             state.C *= 3.;
+      state.chi2 *= 6.;
+
+      gettimeofday(&t2, NULL);
+      time1 = ((double)(t1.tv_sec) + (double)(t1.tv_usec) / 1000000.);
+      time2 = ((double)(t2.tv_sec) + (double)(t2.tv_usec) / 1000000.);
+      KALtime += (time2 - time1);
+
+      if (!(temp_track.kappa == temp_track.kappa)) {
         continue;
       }
-      if (fabs(temp_track.z0) > dca_cut) {
+      if (temp_track.kappa > top_range.max_k) {
         continue;
       }
-    }
-    tracks.push_back(temp_track);
-    track_states.push_back(state);
-    if ((remove_hits == true) && (state.chi2 < chi2_removal_cut) &&
-        (temp_track.hits.size() >= n_removal_hits)) {
-      for (unsigned int i = 0; i < temp_track.hits.size(); ++i) {
-        (*hit_used)[temp_track.hits[i].get_id()] = true;
+      if (!(state.chi2 == state.chi2)) {
+        continue;
+      }
+      if (state.chi2 / (2. * ((float)(temp_track.hits.size())) - 5.) > chi2_cut) {
+        continue;
+      }
+
+      if (cut_on_dca == true) {
+        if (fabs(temp_track.d) > dca_cut) {
+          continue;
+        }
+        if (fabs(temp_track.z0) > dca_cut) {
+          continue;
+        }
+      }
+      tracks.push_back(temp_track);
+      track_states.push_back(state);
+      if ((remove_hits == true) && (state.chi2 < chi2_removal_cut) &&
+          (temp_track.hits.size() >= n_removal_hits)) {
+        for (unsigned int i = 0; i < temp_track.hits.size(); ++i) {
+          (*hit_used)[temp_track.hits[i].get_id()] = true;
+        }
       }
     }
   }
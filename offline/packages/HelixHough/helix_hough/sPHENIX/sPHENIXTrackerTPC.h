@@ -2,6 +2,7 @@
 #define __SPHENIXTRACKERTPC__
 
 #include "HelixHough.h"
+#include "HelixFitBatch.h"
 #include <vector>
 #include <set>
 #include <map>
@@ -265,6 +266,11 @@ class sPHENIXTrackerTPC : public HelixHough {
   static float fitTrack(SimpleTrack3D& track,
 			std::vector<float>& chi2_hit,
 			float scale = 1.0);
+  /// fits all tracks with the batched fitter, chi2[i] is the chi2/ndf
+  /// fitTrack() would return for tracks[i]
+  void fitTracks(std::vector<SimpleTrack3D>& tracks,
+                 std::vector<float>& chi2,
+                 float scale = 1.0);
 
   void setVerbosity(int v) { verbosity = v; }
 
@@ -532,6 +538,8 @@ class sPHENIXTrackerTPC : public HelixHough {
   
   double CAtime;
   double KALtime;
+
+  HelixFitBatch fit_batch;
   
   std::vector<std::vector<SimpleHit3D> > layer_sorted_1[4];
   unsigned int findtracks_bin;
@@ -0,0 +1,480 @@
+#include "sPHENIXTracker.h"
+#include <float.h>
+#include <sys/time.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+using namespace SeamStress;
+
+// number of track candidates per call of the batched fast fit
+static const unsigned int ca_batch_size = 256;
+
+static inline float hitError(const SimpleHit3D& hit, unsigned int i) {
+  return 0.5 * sqrt(12.0) * sqrt(hit.get_size(i, i));
+}
+
+// curvature of the circle through three points in xy
+static inline float tripletKappa(const SimpleHit3D& h1, const SimpleHit3D& h2,
+                                 const SimpleHit3D& h3) {
+  float ax = h2.get_x() - h1.get_x();
+  float ay = h2.get_y() - h1.get_y();
+  float bx = h3.get_x() - h2.get_x();
+  float by = h3.get_y() - h2.get_y();
+  float cx = h3.get_x() - h1.get_x();
+  float cy = h3.get_y() - h1.get_y();
+  float den = sqrt((ax * ax + ay * ay) * (bx * bx + by * by) *
+                   (cx * cx + cy * cy));
+  if (den <= 0.) {
+    return FLT_MAX;
+  }
+  return 2. * fabs(ax * by - ay * bx) / den;
+}
+
+static inline float safeAsin(float x) {
+  if (x >= 1.) {
+    return 0.5 * M_PI;
+  }
+  return asin(x);
+}
+
+class CARoot {
+ public:
+  CARoot(unsigned int c, unsigned int s) : cell(c), state(s) {}
+  ~CARoot() {}
+
+  // longest chains first, then by cell for a reproducible order
+  bool operator<(const CARoot& other) const {
+    return (state > other.state) ||
+           ((state == other.state) && (cell < other.cell));
+  }
+
+  unsigned int cell;
+  unsigned int state;
+};
+
+class CALinkCellLess {
+ public:
+  bool operator()(const CALink& a, const CALink& b) const {
+    return (a.cell < b.cell) ||
+           ((a.cell == b.cell) && (a.neighbor < b.neighbor));
+  }
+};
+
+class CACellLayerLess {
+ public:
+  bool operator()(const CACell& a, const CACell& b) const {
+    return (a.inner_layer < b.inner_layer) ||
+           ((a.inner_layer == b.inner_layer) &&
+            ((a.inner < b.inner) ||
+             ((a.inner == b.inner) && (a.outer < b.outer))));
+  }
+};
+
+void sPHENIXTracker::findHelicesCA(vector<SimpleHit3D>& hits,
+                                   unsigned int min_hits,
+                                   unsigned int max_hits,
+                                   vector<SimpleTrack3D>& tracks,
+                                   unsigned int maxtracks) {
+  index_mapping.clear();
+  index_mapping.resize(hits.size(), 0);
+  hit_used->clear();
+  for (unsigned int i = 0; i < hits.size(); i++) {
+    index_mapping[i] = hits[i].get_id();
+    hits[i].set_id(i);
+  }
+  (*hit_used).assign(hits.size(), false);
+
+  initEvent(hits, min_hits);
+
+  timeval t1, t2;
+  double time1 = 0.;
+  double time2 = 0.;
+  gettimeofday(&t1, NULL);
+
+  ca_hits = &hits;
+  ca_index.build(hits);
+
+  // phi sectors by the position of the inner hit of a cell
+  ca_sector_hits.resize(ca_nsectors);
+  ca_sector_cells.resize(ca_nsectors);
+  for (unsigned int s = 0; s < ca_nsectors; ++s) {
+    ca_sector_hits[s].clear();
+    ca_sector_cells[s].clear();
+  }
+  float sector_scale = ((float)ca_nsectors) / (2. * M_PI);
+  for (unsigned int i = 0; i < hits.size(); ++i) {
+    if (hits[i].get_layer() < 0) {
+      continue;
+    }
+    int s = (int)((ca_index.phi(i) + M_PI) * sector_scale);
+    if (s < 0) {
+      s = 0;
+    }
+    if (s >= (int)ca_nsectors) {
+      s = ca_nsectors - 1;
+    }
+    ca_sector_hits[s].push_back(i);
+  }
+
+  unsigned int nworkers = 1;
+  if ((is_parallel == true) && (nthreads > 1)) {
+    nworkers = nthreads;
+  }
+  ca_thread_links.resize(nworkers);
+  for (unsigned int w = 0; w < nworkers; ++w) {
+    ca_thread_links[w].clear();
+  }
+
+  // doublets
+  if (nworkers > 1) {
+    pins->sewStraight(&sPHENIXTracker::caDoubletsThread, nthreads);
+  } else {
+    caDoublets(0, 1);
+  }
+
+  ca_cells.clear();
+  for (unsigned int s = 0; s < ca_nsectors; ++s) {
+    ca_cells.insert(ca_cells.end(), ca_sector_cells[s].begin(),
+                    ca_sector_cells[s].end());
+  }
+  // the evolution runs in inner layer order
+  sort(ca_cells.begin(), ca_cells.end(), CACellLayerLess());
+  unsigned int ncells = ca_cells.size();
+  ca_ncells += ncells;
+
+  // cells by outer hit, for finding the inner neighbours of a cell
+  ca_outer_offsets.assign(hits.size() + 1, 0);
+  for (unsigned int c = 0; c < ncells; ++c) {
+    ca_outer_offsets[ca_cells[c].outer + 1] += 1;
+  }
+  for (unsigned int i = 0; i < hits.size(); ++i) {
+    ca_outer_offsets[i + 1] += ca_outer_offsets[i];
+  }
+  ca_outer_cells.resize(ncells);
+  vector<unsigned int> fill(ca_outer_offsets.begin(),
+                            ca_outer_offsets.end() - 1);
+  for (unsigned int c = 0; c < ncells; ++c) {
+    ca_outer_cells[fill[ca_cells[c].outer]++] = c;
+  }
+
+  // links between cells sharing a hit
+  if (nworkers > 1) {
+    pins->sewStraight(&sPHENIXTracker::caLinksThread, nthreads);
+  } else {
+    caLinks(0, 1);
+  }
+
+  ca_links.clear();
+  for (unsigned int w = 0; w < nworkers; ++w) {
+    ca_links.insert(ca_links.end(), ca_thread_links[w].begin(),
+                    ca_thread_links[w].end());
+  }
+  sort(ca_links.begin(), ca_links.end(), CALinkCellLess());
+  ca_nlinks += ca_links.size();
+  ca_link_offsets.assign(ncells + 1, 0);
+  for (unsigned int k = 0; k < ca_links.size(); ++k) {
+    ca_link_offsets[ca_links[k].cell + 1] += 1;
+  }
+  for (unsigned int c = 0; c < ncells; ++c) {
+    ca_link_offsets[c + 1] += ca_link_offsets[c];
+  }
+
+  // evolution : the state of a cell is the length of the longest chain of
+  // linked cells ending in it. Links always point to a lower inner layer,
+  // so one pass in layer order is enough
+  for (unsigned int c = 0; c < ncells; ++c) {
+    unsigned int state = 1;
+    for (unsigned int k = ca_link_offsets[c]; k < ca_link_offsets[c + 1];
+         ++k) {
+      unsigned int s = ca_cells[ca_links[k].neighbor].state + 1;
+      if (s > state) {
+        state = s;
+      }
+    }
+    ca_cells[c].state = state;
+  }
+
+  gettimeofday(&t2, NULL);
+  time1 = ((double)(t1.tv_sec) + (double)(t1.tv_usec) / 1000000.);
+  time2 = ((double)(t2.tv_sec) + (double)(t2.tv_usec) / 1000000.);
+  CAtime += (time2 - time1);
+
+  vector<SimpleTrack3D> temp_tracks;
+  caChains((min_hits > req_layers ? min_hits : req_layers), max_hits,
+           temp_tracks, maxtracks);
+
+  for (unsigned int i = 0; i < hits.size(); i++) {
+    hits[i].set_id(index_mapping[i]);
+  }
+  for (unsigned int t = 0; t < temp_tracks.size(); t++) {
+    for (unsigned int h = 0; h < temp_tracks[t].hits.size(); h++) {
+      if (temp_tracks[t].hits[h].get_id() != (unsigned)-1) {
+        temp_tracks[t].hits[h].set_id(
+            index_mapping[temp_tracks[t].hits[h].get_id()]);
+      }
+    }
+  }
+  ca_hits = NULL;
+
+  finalize(temp_tracks, tracks);
+}
+
+void sPHENIXTracker::caDoubletsThread(void* arg) {
+  unsigned long int w = (*((unsigned long int*)arg));
+  caDoublets(w, nthreads);
+}
+
+void sPHENIXTracker::caLinksThread(void* arg) {
+  unsigned long int w = (*((unsigned long int*)arg));
+  caLinks(w, nthreads);
+}
+
+// cells from the hits of the sectors first_sector, first_sector + stride, ...
+// to the hits of the next (1 + allowed missing) layers which are compatible
+// with a track from the vertex region inside the top range
+void sPHENIXTracker::caDoublets(unsigned int first_sector,
+                                unsigned int stride) {
+  vector<SimpleHit3D>& hits = *ca_hits;
+  unsigned int allowed_missing = n_layers - req_layers;
+  if (req_layers > n_layers) {
+    allowed_missing = 0;
+  }
+  float max_k = top_range.max_k;
+  float max_d = fabs(top_range.max_d);
+  if (fabs(top_range.min_d) > max_d) {
+    max_d = fabs(top_range.min_d);
+  }
+  float min_dzdl = top_range.min_dzdl;
+  float max_dzdl = top_range.max_dzdl;
+
+  vector<unsigned int> outer_hits;
+  for (unsigned int s = first_sector; s < ca_nsectors; s += stride) {
+    vector<CACell>& cells = ca_sector_cells[s];
+    for (unsigned int ih = 0; ih < ca_sector_hits[s].size(); ++ih) {
+      unsigned int i = ca_sector_hits[s][ih];
+      const SimpleHit3D& hit1 = hits[i];
+      if ((*hit_used)[i] == true) {
+        continue;
+      }
+      unsigned int l1 = hit1.get_layer();
+      float x1 = hit1.get_x();
+      float y1 = hit1.get_y();
+      float z1 = hit1.get_z();
+      float r1 = sqrt(x1 * x1 + y1 * y1);
+      if (r1 <= 0.) {
+        continue;
+      }
+      float ex1 = hitError(hit1, 0);
+      float ey1 = hitError(hit1, 1);
+      float ez1 = hitError(hit1, 2);
+      float phi1 = ca_index.phi(i);
+
+      for (unsigned int l2 = l1 + 1;
+           (l2 <= l1 + 1 + allowed_missing) && (l2 < n_layers); ++l2) {
+        float r2 = r1;
+        if (l2 < detector_radii.size()) {
+          r2 = detector_radii[l2];
+        }
+        if (r2 <= r1) {
+          r2 = r1 * 1.0001;
+        }
+        // phi bend between the two radii for the largest curvature, and
+        // the phi offset of a displaced track
+        float dphi = fabs(safeAsin(0.5 * max_k * r2) -
+                          safeAsin(0.5 * max_k * r1)) +
+                     max_d / r1 + 3. * (ex1 + ey1) / r1;
+        // straight line in rz from the z0 range through the inner hit
+        float scale = r2 / r1;
+        float zlo = z1 * scale + top_range.max_z0 * (1. - scale);
+        float zhi = z1 * scale + top_range.min_z0 * (1. - scale);
+        float zmargin = 3. * ez1 * (scale + 1.);
+        outer_hits.clear();
+        ca_index.query(l2, phi1, dphi, zlo - zmargin, zhi + zmargin,
+                       outer_hits);
+
+        for (unsigned int jh = 0; jh < outer_hits.size(); ++jh) {
+          unsigned int j = outer_hits[jh];
+          if ((*hit_used)[j] == true) {
+            continue;
+          }
+          const SimpleHit3D& hit2 = hits[j];
+          float dx = hit2.get_x() - x1;
+          float dy = hit2.get_y() - y1;
+          float dz = hit2.get_z() - z1;
+          float dxy = sqrt(dx * dx + dy * dy);
+          float len = sqrt(dxy * dxy + dz * dz);
+          if (dxy <= 0.) {
+            continue;
+          }
+          CACell cell;
+          cell.inner = i;
+          cell.outer = j;
+          cell.inner_layer = l1;
+          cell.sector = s;
+          cell.ux = dx / dxy;
+          cell.uy = dy / dxy;
+          cell.dzdl = dz / len;
+          cell.ddzdl = (ez1 + hitError(hit2, 2)) / len;
+          if ((cell.dzdl + cell.ddzdl < min_dzdl) ||
+              (cell.dzdl - cell.ddzdl > max_dzdl)) {
+            continue;
+          }
+          cells.push_back(cell);
+        }
+      }
+    }
+  }
+}
+
+// links from every cell of the sectors first_sector, first_sector + stride,
+// ... to the cells ending on its inner hit, when the hit triplet has a
+// curvature inside the top range and the two cells agree in dz/dl
+void sPHENIXTracker::caLinks(unsigned int first_sector, unsigned int stride) {
+  vector<SimpleHit3D>& hits = *ca_hits;
+  vector<CALink>& links = ca_thread_links[first_sector];
+  float sinang_cut = sqrt(1. - cosang_cut * cosang_cut);
+  float max_k = top_range.max_k;
+
+  for (unsigned int c = 0; c < ca_cells.size(); ++c) {
+    const CACell& cell = ca_cells[c];
+    if ((cell.sector % stride) != first_sector) {
+      continue;
+    }
+    for (unsigned int k = ca_outer_offsets[cell.inner];
+         k < ca_outer_offsets[cell.inner + 1]; ++k) {
+      unsigned int n = ca_outer_cells[k];
+      const CACell& neighbor = ca_cells[n];
+      // the track has to keep moving outwards in xy
+      if ((neighbor.ux * cell.ux + neighbor.uy * cell.uy) <= 0.) {
+        continue;
+      }
+      float chi2 = (neighbor.dzdl - cell.dzdl) /
+                   (neighbor.ddzdl + cell.ddzdl +
+                    fabs(neighbor.dzdl * sinang_cut));
+      chi2 *= chi2;
+      if (chi2 > ca_chi2_cut) {
+        continue;
+      }
+      float kappa =
+          tripletKappa(hits[neighbor.inner], hits[cell.inner], hits[cell.outer]);
+      if (kappa > max_k) {
+        continue;
+      }
+      links.push_back(CALink(c, n, kappa));
+    }
+  }
+}
+
+// chains of cells, walking inwards from the cells which end a chain of at
+// least min_hits hits. At every step the inner neighbour with the next
+// lower state whose triplet curvature is closest to the one of the chain so
+// far is taken. The chains are fitted and selected in batches like the
+// segments of findTracksBySegments
+void sPHENIXTracker::caChains(unsigned int min_hits, unsigned int max_hits,
+                              vector<SimpleTrack3D>& tracks,
+                              unsigned int maxtracks) {
+  vector<SimpleHit3D>& hits = *ca_hits;
+  unsigned int ncells = ca_cells.size();
+
+  // cells which are an inner neighbour of another cell can not end a chain
+  vector<bool> has_outer(ncells, false);
+  for (unsigned int k = 0; k < ca_links.size(); ++k) {
+    has_outer[ca_links[k].neighbor] = true;
+  }
+  vector<CARoot> roots;
+  for (unsigned int c = 0; c < ncells; ++c) {
+    if ((has_outer[c] == false) && (ca_cells[c].state + 1 >= min_hits)) {
+      roots.push_back(CARoot(c, ca_cells[c].state));
+    }
+  }
+  sort(roots.begin(), roots.end());
+
+  float angle_tolerance = 2. * acos(cosang_cut);
+
+  vector<unsigned int> chain;
+  SimpleTrack3D temp_track;
+  vector<SimpleTrack3D> candidates;
+  unsigned int r = 0;
+  while (r < roots.size()) {
+    if ((maxtracks != 0) && (tracks.size() >= maxtracks)) {
+      break;
+    }
+    candidates.clear();
+    for (; (r < roots.size()) && (candidates.size() < ca_batch_size); ++r) {
+      unsigned int c = roots[r].cell;
+      chain.clear();
+      chain.push_back(ca_cells[c].outer);
+      chain.push_back(ca_cells[c].inner);
+      float kappa = -1.;
+      while ((ca_cells[c].state > 1) && (chain.size() < max_hits)) {
+        const CACell& cell = ca_cells[c];
+        float dx = hits[cell.outer].get_x() - hits[cell.inner].get_x();
+        float dy = hits[cell.outer].get_y() - hits[cell.inner].get_y();
+        float max_dk = angle_tolerance / sqrt(dx * dx + dy * dy);
+        unsigned int best = ca_links.size();
+        float best_dk = FLT_MAX;
+        for (unsigned int k = ca_link_offsets[c]; k < ca_link_offsets[c + 1];
+             ++k) {
+          unsigned int n = ca_links[k].neighbor;
+          if (ca_cells[n].state + 1 != cell.state) {
+            continue;
+          }
+          float dk = 0.;
+          if (kappa >= 0.) {
+            dk = fabs(ca_links[k].kappa - kappa);
+            if (dk > max_dk) {
+              continue;
+            }
+          }
+          if (dk < best_dk) {
+            best_dk = dk;
+            best = k;
+          }
+        }
+        if (best == ca_links.size()) {
+          break;
+        }
+        kappa = ca_links[best].kappa;
+        c = ca_links[best].neighbor;
+        chain.push_back(ca_cells[c].inner);
+      }
+      if (chain.size() < min_hits) {
+        continue;
+      }
+
+      bool used = false;
+      for (unsigned int h = 0; h < chain.size(); ++h) {
+        if ((*hit_used)[chain[h]] == true) {
+          used = true;
+          break;
+        }
+      }
+      if (used == true) {
+        continue;
+      }
+
+      temp_comb = chain;
+      sort(temp_comb.begin(), temp_comb.end());
+      set<vector<unsigned int> >::iterator it = combos.find(temp_comb);
+      if (it != combos.end()) {
+        continue;
+      }
+      if (combos.size() > 10000) {
+        combos.clear();
+      }
+      combos.insert(temp_comb);
+
+      // inner to outer, like the segments
+      temp_track.hits.assign(chain.size(), SimpleHit3D());
+      for (unsigned int h = 0; h < chain.size(); ++h) {
+        temp_track.hits[h] = hits[chain[chain.size() - 1 - h]];
+      }
+      candidates.push_back(temp_track);
+      ca_nchains += 1;
+    }
+
+    acceptCandidates(candidates, tracks);
+  }
+}
@@ -31,9 +31,16 @@ namespace genfit {
 
 bool Field2D::re_scale(double r)
 {
+	if(!field_map_r_ || !field_map_z_)
+	{
+		LogERROR("No field map to re-scale!");
+		return false;
+	}
 	field_map_r_->Scale(r);
 	field_map_z_->Scale(r);
 
+	fill_cache();
+
 	return true;
 }
 
@@ -81,9 +88,34 @@ bool Field2D::initialize(std::string inname) {
 
 	//field_map_z_->Print("all");
 
+	fill_cache();
+
 	return true;
 }
 
+void Field2D::fill_cache() {
+	const TAxis *axis_z = field_map_r_->GetXaxis();
+	const TAxis *axis_r = field_map_r_->GetYaxis();
+
+	cache_nbins_z_ = axis_z->GetNbins();
+	cache_nbins_r_ = axis_r->GetNbins();
+	cache_z_min_ = axis_z->GetXmin();
+	cache_z_max_ = axis_z->GetXmax();
+	cache_r_min_ = axis_r->GetXmin();
+	cache_r_max_ = axis_r->GetXmax();
+
+	// including under- and overflow, as the global bins of the TH2D
+	int nz = cache_nbins_z_ + 2;
+	int nr = cache_nbins_r_ + 2;
+	cache_.assign(2 * nz * nr, 0.);
+	for (int bin_r = 0; bin_r < nr; ++bin_r)
+		for (int bin_z = 0; bin_z < nz; ++bin_z) {
+			int bin = bin_z + nz * bin_r;
+			cache_[2 * bin] = field_map_r_->GetBinContent(bin_z, bin_r);
+			cache_[2 * bin + 1] = field_map_z_->GetBinContent(bin_z, bin_r);
+		}
+}
+
 //void Field2D::plot(std::string option){
 //
 ////	TH2D *hbr = new TH2D("hbr","|B_{r}| [kGauss]; z [cm]; r [cm]",401, -401, 401, 151, -1, 301);
@@ -145,7 +177,7 @@ TVector3 Field2D::get(const TVector3& v) const {
 void Field2D::get(const double&x, const double&y, const double&z, double& Bx, double& By, double& Bz) const {
 	double r = sqrt(x*x + y*y);
 
-	if(fabs(r) > 300 || fabs(z) > 400)
+	if(cache_.empty() || fabs(r) > 300 || fabs(z) > 400)
 	{
 		Bx = 0;
 		By = 0;
@@ -153,11 +185,21 @@ void Field2D::get(const double&x, const double&y, const double&z, double& Bx, do
 		return;
 	}
 
-	int bin_z = field_map_r_->GetXaxis()->FindBin(z);
-	int bin_r = field_map_r_->GetYaxis()->FindBin(r);
-
-	Bz = field_map_z_->GetBinContent(bin_z,bin_r);
-	double Br = field_map_r_->GetBinContent(bin_z,bin_r);
+	// same bin as TAxis::FindBin, without the histogram calls
+	int bin_z = 0;
+	if (z >= cache_z_max_)
+		bin_z = cache_nbins_z_ + 1;
+	else if (z >= cache_z_min_)
+		bin_z = 1 + int(cache_nbins_z_ * (z - cache_z_min_) / (cache_z_max_ - cache_z_min_));
+	int bin_r = 0;
+	if (r >= cache_r_max_)
+		bin_r = cache_nbins_r_ + 1;
+	else if (r >= cache_r_min_)
+		bin_r = 1 + int(cache_nbins_r_ * (r - cache_r_min_) / (cache_r_max_ - cache_r_min_));
+
+	const double *b = &cache_[2 * (bin_z + (cache_nbins_z_ + 2) * bin_r)];
+	double Br = b[0];
+	Bz = b[1];
 
 	Bx = x/r*Br;
 	By = y/r*Br;
@@ -13,6 +13,7 @@
 #include "boost/tuple/tuple.hpp"
 #include "boost/tuple/tuple_comparison.hpp"
 #include <map>
+#include <vector>
 
 #include <TH2D.h>
 
@@ -27,10 +28,14 @@ namespace genfit {
 class Field2D : public AbsBField {
  public:
   //! define the constant field in this ctor
-  Field2D() : field_map_r_(NULL), field_map_z_(NULL)
+  Field2D() : field_map_r_(NULL), field_map_z_(NULL),
+    cache_nbins_z_(0), cache_nbins_r_(0),
+    cache_z_min_(0), cache_z_max_(0), cache_r_min_(0), cache_r_max_(0)
   { ; }
 
-  Field2D(std::string inname)
+  Field2D(std::string inname) : field_map_r_(NULL), field_map_z_(NULL),
+    cache_nbins_z_(0), cache_nbins_r_(0),
+    cache_z_min_(0), cache_z_max_(0), cache_r_min_(0), cache_r_max_(0)
   { initialize(inname); }
 
   ~Field2D();
@@ -46,8 +51,21 @@ class Field2D : public AbsBField {
   void get(const double& posX, const double& posY, const double& posZ, double& Bx, double& By, double& Bz) const;
 
  private:
+  //! copy the histograms into the flat lookup table
+  void fill_cache();
+
   TH2D *field_map_r_;
   TH2D *field_map_z_;
+
+  //! (B_r, B_z) per histogram bin, same global bin numbering as the TH2D,
+  //! empty (no field) as long as no map was read
+  std::vector<double> cache_;
+  int cache_nbins_z_;
+  int cache_nbins_r_;
+  double cache_z_min_;
+  double cache_z_max_;
+  double cache_r_min_;
+  double cache_r_max_;
 };
 
 } /* End of namespace genfit */
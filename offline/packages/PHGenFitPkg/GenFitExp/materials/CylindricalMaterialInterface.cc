@@ -0,0 +1,323 @@
+#include "CylindricalMaterialInterface.h"
+
+#include <GenFit/MaterialProperties.h>
+#include <GenFit/MeanExcEnergy.h>
+
+#include <TGeoManager.h>
+#include <TGeoMaterial.h>
+#include <TGeoMedium.h>
+#include <TGeoNode.h>
+
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+
+#define LogDEBUG(exp)		std::cout<<"DEBUG: "<<__FILE__<<": "<<__LINE__<<": "<< exp <<"\n"
+#define LogERROR(exp)		std::cout<<"ERROR: "<<__FILE__<<": "<<__LINE__<<": "<< exp <<"\n"
+#define LogWARNING(exp)	std::cout<<"WARNING: "<<__FILE__<<": "<<__LINE__<<": "<< exp <<"\n"
+
+namespace {
+
+//! step beyond a boundary, cm
+const double boundary_push = 1.E-4;
+
+//! radiation length of an empty cell, cm
+const double no_material_radiation_length = 1.E30;
+
+//! relative difference below which two averaged materials are the same
+const double material_tolerance = 1.E-6;
+
+bool same_value(double a, double b) {
+	return fabs(a - b) <= material_tolerance * std::max(fabs(a), fabs(b));
+}
+
+//! sums over the path in one cell
+struct CellSum {
+	double mass;		// rho * L
+	double x0;			// L / X0
+	double mass_a;		// rho * L * A
+	double electrons;	// rho * L * Z/A
+	double electrons_lnI;	// rho * L * Z/A * ln(I)
+};
+
+//! smallest positive distance along the line to r = radius, -1 if none
+double distance_to_cylinder(double x, double y, double ax, double ay,
+		double radius, bool outwards) {
+	double c = ax * ax + ay * ay;
+	if (c <= 0)
+		return -1;
+	double b = x * ax + y * ay;
+	double disc = b * b - c * (x * x + y * y - radius * radius);
+	if (disc < 0)
+		return -1;
+	double s = outwards ? (-b + sqrt(disc)) / c : (-b - sqrt(disc)) / c;
+	return (s > 0) ? s : -1;
+}
+
+}
+
+namespace genfit {
+
+CylindricalMaterialInterface::CylindricalMaterialInterface() :
+		r_max_(0), z_min_(0), z_max_(0), dz_(1), n_slices_(0),
+		current_slice_(-1), current_interval_(-1), current_material_(&vacuum_)
+{
+	vacuum_.density = 0;
+	vacuum_.Z = 1;
+	vacuum_.A = 1;
+	vacuum_.radiationLength = no_material_radiation_length;
+	vacuum_.mEE = 1.E-6;
+}
+
+unsigned int CylindricalMaterialInterface::addMaterial(const Material& mat) {
+	for (unsigned int i = 0; i < materials_.size(); ++i) {
+		const Material& m = materials_[i];
+		if (same_value(m.density, mat.density) && same_value(m.Z, mat.Z)
+				&& same_value(m.A, mat.A)
+				&& same_value(m.radiationLength, mat.radiationLength)
+				&& same_value(m.mEE, mat.mEE))
+			return i;
+	}
+	materials_.push_back(mat);
+	return materials_.size() - 1;
+}
+
+bool CylindricalMaterialInterface::build(TGeoManager* tgeo_manager,
+		double r_max, double z_max, double dr, double dz, unsigned int nphi,
+		unsigned int n_z_rays) {
+
+	if (!tgeo_manager) {
+		LogERROR("No TGeoManager found!");
+		return false;
+	}
+	if (!(r_max > 0 && z_max > 0 && dr > 0 && dz > 0 && nphi > 0 && n_z_rays > 0)) {
+		LogERROR("Invalid material map binning!");
+		return false;
+	}
+
+	TGeoNavigator* nav = tgeo_manager->GetCurrentNavigator();
+	if (!nav)
+		nav = tgeo_manager->AddNavigator();
+
+	r_max_ = r_max;
+	z_min_ = -z_max;
+	z_max_ = z_max;
+	n_slices_ = (unsigned int) ceil(2. * z_max / dz);
+	dz_ = 2. * z_max / n_slices_;
+	unsigned int n_r = (unsigned int) ceil(r_max / dr);
+	dr = r_max / n_r;
+
+	slice_offsets_.assign(1, 0);
+	interval_r_max_.clear();
+	interval_material_.clear();
+	materials_.clear();
+
+	std::vector<CellSum> cells(n_r);
+	std::vector<unsigned int> cell_material(n_r);
+
+	for (unsigned int iz = 0; iz < n_slices_; ++iz) {
+		for (unsigned int ir = 0; ir < n_r; ++ir) {
+			CellSum zero = {0, 0, 0, 0, 0};
+			cells[ir] = zero;
+		}
+
+		// radial rays through the slice
+		for (unsigned int jz = 0; jz < n_z_rays; ++jz) {
+			double z = z_min_ + dz_ * (iz + (jz + 0.5) / n_z_rays);
+			for (unsigned int jphi = 0; jphi < nphi; ++jphi) {
+				double phi = 2. * M_PI * (jphi + 0.5) / nphi;
+				double ax = cos(phi);
+				double ay = sin(phi);
+
+				nav->InitTrack(0., 0., z, ax, ay, 0.);
+				double r = 0;
+				while (r < r_max_) {
+					TGeoNode* node = nav->GetCurrentNode();
+					TGeoMaterial* mat = NULL;
+					if (node && node->GetMedium())
+						mat = node->GetMedium()->GetMaterial();
+
+					nav->FindNextBoundaryAndStep(r_max_ - r);
+					double step = nav->GetStep();
+					if (!(step > 0))
+						step = boundary_push;
+					double r_next = std::min(r + step, r_max_);
+
+					if (mat && mat->GetDensity() > 0) {
+						double rho = mat->GetDensity();
+						double A = mat->GetA();
+						double Z = mat->GetZ();
+						double X0 = mat->GetRadLen();
+						double lnI = log(MeanExcEnergy_get(mat));
+
+						// spread the segment over the radial cells
+						unsigned int ir_begin = (unsigned int) (r / dr);
+						for (unsigned int ir = ir_begin; ir < n_r; ++ir) {
+							double lo = std::max(r, ir * dr);
+							double hi = std::min(r_next, (ir + 1) * dr);
+							if (hi <= lo)
+								break;
+							double L = hi - lo;
+							CellSum& cell = cells[ir];
+							cell.mass += rho * L;
+							cell.x0 += (X0 > 0) ? L / X0 : 0;
+							cell.mass_a += rho * L * A;
+							cell.electrons += rho * L * Z / A;
+							cell.electrons_lnI += rho * L * Z / A * lnI;
+						}
+					}
+
+					r = r_next;
+					if (nav->IsOutside())
+						break;
+				}
+			}
+		}
+
+		// effective materials, merged into intervals
+		double ray_length = nphi * n_z_rays * dr;
+		for (unsigned int ir = 0; ir < n_r; ++ir) {
+			const CellSum& cell = cells[ir];
+			if (!(cell.mass > 0)) {
+				cell_material[ir] = (unsigned int) -1;
+				continue;
+			}
+			Material mat;
+			mat.density = cell.mass / ray_length;
+			mat.A = cell.mass_a / cell.mass;
+			mat.Z = mat.A * cell.electrons / cell.mass;
+			mat.radiationLength = (cell.x0 > 0) ? ray_length / cell.x0 : no_material_radiation_length;
+			mat.mEE = exp(cell.electrons_lnI / cell.electrons);
+			cell_material[ir] = addMaterial(mat);
+		}
+
+		for (unsigned int ir = 0; ir < n_r; ++ir) {
+			if (ir + 1 < n_r && cell_material[ir + 1] == cell_material[ir])
+				continue;
+			interval_r_max_.push_back((ir + 1) * dr);
+			interval_material_.push_back(cell_material[ir]);
+		}
+		slice_offsets_.push_back(interval_r_max_.size());
+	}
+
+	current_slice_ = -1;
+	current_interval_ = -1;
+	current_material_ = &vacuum_;
+
+	return true;
+}
+
+void CylindricalMaterialInterface::locate(double x, double y, double z,
+		int& slice, int& interval) const {
+	slice = -1;
+	interval = -1;
+	if (slice_offsets_.empty() || !(z >= z_min_ && z < z_max_))
+		return;
+	double r = sqrt(x * x + y * y);
+	if (!(r < r_max_))
+		return;
+
+	slice = (int) ((z - z_min_) / dz_);
+	if (slice >= (int) n_slices_)
+		slice = n_slices_ - 1;
+
+	std::vector<double>::const_iterator begin = interval_r_max_.begin() + slice_offsets_[slice];
+	std::vector<double>::const_iterator end = interval_r_max_.begin() + slice_offsets_[slice + 1];
+	std::vector<double>::const_iterator it = std::upper_bound(begin, end, r);
+	if (it == end)
+		--it;
+	interval = it - interval_r_max_.begin();
+}
+
+bool CylindricalMaterialInterface::initTrack(double posX, double posY,
+		double posZ, double dirX, double dirY, double dirZ) {
+	int slice;
+	int interval;
+	locate(posX, posY, posZ, slice, interval);
+
+	bool changed = (slice != current_slice_ || interval != current_interval_);
+	current_slice_ = slice;
+	current_interval_ = interval;
+
+	current_material_ = &vacuum_;
+	if (interval >= 0 && interval_material_[interval] != (unsigned int) -1)
+		current_material_ = &materials_[interval_material_[interval]];
+
+	return changed;
+}
+
+void CylindricalMaterialInterface::getMaterialParameters(double& density,
+		double& Z, double& A, double& radiationLength, double& mEE) {
+	density = current_material_->density;
+	Z = current_material_->Z;
+	A = current_material_->A;
+	radiationLength = current_material_->radiationLength;
+	mEE = current_material_->mEE;
+}
+
+void CylindricalMaterialInterface::getMaterialParameters(
+		MaterialProperties& parameters) {
+	parameters.setMaterialProperties(current_material_->density,
+			current_material_->Z, current_material_->A,
+			current_material_->radiationLength, current_material_->mEE);
+}
+
+double CylindricalMaterialInterface::findNextBoundary(const RKTrackRep* rep,
+		const M1x7& state7, double sMax, bool varField) {
+
+	double sign = (sMax < 0) ? -1. : 1.;
+	double x = state7[0];
+	double y = state7[1];
+	double z = state7[2];
+	double ax = sign * state7[3];
+	double ay = sign * state7[4];
+	double az = sign * state7[5];
+
+	int slice;
+	int interval;
+	locate(x, y, z, slice, interval);
+
+	// distance to leave the current cell along the straight line
+	double s = -1;
+	if (slice >= 0) {
+		double z_lo = z_min_ + slice * dz_;
+		double z_hi = z_lo + dz_;
+		if (az > 0)
+			s = (z_hi - z) / az;
+		else if (az < 0)
+			s = (z_lo - z) / az;
+
+		double r_hi = interval_r_max_[interval];
+		double r_lo = (interval > (int) slice_offsets_[slice]) ? interval_r_max_[interval - 1] : 0;
+		double s_r = distance_to_cylinder(x, y, ax, ay, r_hi, true);
+		if (s_r > 0 && (s < 0 || s_r < s))
+			s = s_r;
+		if (r_lo > 0) {
+			s_r = distance_to_cylinder(x, y, ax, ay, r_lo, false);
+			if (s_r > 0 && (s < 0 || s_r < s))
+				s = s_r;
+		}
+	} else {
+		// outside, distance to enter the map
+		if (z < z_min_ && az > 0)
+			s = (z_min_ - z) / az;
+		else if (z >= z_max_ && az < 0)
+			s = (z_max_ - z) / az;
+		else if (z >= z_min_ && z < z_max_)
+			s = distance_to_cylinder(x, y, ax, ay, r_max_, false);
+	}
+
+	if (s < 0 || s + boundary_push >= fabs(sMax))
+		return sMax;
+
+	return sign * (s + boundary_push);
+}
+
+void CylindricalMaterialInterface::print() const {
+	std::cout << "genfit::CylindricalMaterialInterface: r < " << r_max_
+			<< " cm, " << z_min_ << " < z < " << z_max_ << " cm, "
+			<< n_slices_ << " slices, " << get_n_cells() << " cells, "
+			<< get_n_materials() << " materials" << std::endl;
+}
+
+} /* End of namespace genfit */
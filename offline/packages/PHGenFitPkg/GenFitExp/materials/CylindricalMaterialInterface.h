@@ -0,0 +1,114 @@
+/** @addtogroup genfit
+ * @{
+ */
+
+#ifndef genfit_CylindricalMaterialInterface_h
+#define genfit_CylindricalMaterialInterface_h
+
+#include "GenFit/AbsMaterialInterface.h"
+
+#include <vector>
+
+class TGeoManager;
+
+namespace genfit {
+
+/** @brief Precomputed material map in (r, z) for the track propagation
+ *
+ *  The volume r < r_max, |z| < z_max is cut in slices in z, every slice is a
+ *  list of radial intervals with one effective material each. build() fills
+ *  the map from the TGeo geometry with radial rays, averaging the materials
+ *  met in a cell over phi such that the mass and the radiation lengths per
+ *  path length are kept. Outside of the map there is no material.
+ *
+ *  The boundaries are found along the straight line of the current direction,
+ *  so no TGeo navigation is done during the fit. Thin volumes perpendicular
+ *  to z (end caps) are only seen if they are hit by the rays of build().
+ *
+ *  The current cell is navigation state of the instance.
+ */
+class CylindricalMaterialInterface : public AbsMaterialInterface {
+ public:
+  CylindricalMaterialInterface();
+  ~CylindricalMaterialInterface() {}
+
+  /** @brief Trace the geometry of tgeo_manager into the map.
+   *
+   *  Cells are dr [cm] in r and dz [cm] in z, every cell is sampled by
+   *  nphi rays in phi at n_z_rays positions in z.
+   */
+  bool build(TGeoManager* tgeo_manager,
+             double r_max, double z_max,
+             double dr = 0.01, double dz = 5.,
+             unsigned int nphi = 72, unsigned int n_z_rays = 2);
+
+  bool initTrack(double posX, double posY, double posZ,
+                 double dirX, double dirY, double dirZ);
+
+  void getMaterialParameters(double& density,
+                             double& Z,
+                             double& A,
+                             double& radiationLength,
+                             double& mEE);
+
+  void getMaterialParameters(MaterialProperties& parameters);
+
+  double findNextBoundary(const RKTrackRep* rep,
+                          const M1x7& state7,
+                          double sMax,
+                          bool varField = true);
+
+  bool is_built() const {return !slice_offsets_.empty();}
+
+  //! number of (slice, radial interval) cells after merging
+  unsigned int get_n_cells() const {return interval_material_.size();}
+
+  //! number of distinct materials
+  unsigned int get_n_materials() const {return materials_.size();}
+
+  void print() const;
+
+ private:
+
+  CylindricalMaterialInterface(const CylindricalMaterialInterface&);
+  CylindricalMaterialInterface& operator=(const CylindricalMaterialInterface&);
+
+  struct Material {
+    double density;
+    double Z;
+    double A;
+    double radiationLength;
+    double mEE;
+  };
+
+  //! index of the material with these parameters, added if new
+  unsigned int addMaterial(const Material& mat);
+
+  //! slice and interval of a position, -1 for outside of the map
+  void locate(double x, double y, double z, int& slice, int& interval) const;
+
+  double r_max_;
+  double z_min_;
+  double z_max_;
+  double dz_;
+  unsigned int n_slices_;
+
+  //! per slice offsets into the interval arrays, n_slices_ + 1 entries
+  std::vector<unsigned int> slice_offsets_;
+  //! upper radial edge and material of every interval
+  std::vector<double> interval_r_max_;
+  std::vector<unsigned int> interval_material_;
+
+  std::vector<Material> materials_;
+  Material vacuum_;
+
+  //! state of the current track, per instance
+  int current_slice_;
+  int current_interval_;
+  const Material* current_material_;
+};
+
+} /* End of namespace genfit */
+/** @} */
+
+#endif // genfit_CylindricalMaterialInterface_h
@@ -0,0 +1,54 @@
+#include "MaterialInterfaceSwitch.h"
+
+#include <cstddef>
+
+namespace genfit {
+
+MaterialInterfaceSwitch::MaterialInterfaceSwitch(
+		AbsMaterialInterface* tgeo_material) :
+		tgeo_material_(tgeo_material), material_map_(NULL),
+		current_(tgeo_material)
+{
+}
+
+MaterialInterfaceSwitch::~MaterialInterfaceSwitch() {
+	delete tgeo_material_;
+	delete material_map_;
+}
+
+void MaterialInterfaceSwitch::set_material_map(
+		AbsMaterialInterface* material_map) {
+	if (current_ == material_map_)
+		current_ = (material_map) ? material_map : tgeo_material_;
+	delete material_map_;
+	material_map_ = material_map;
+}
+
+bool MaterialInterfaceSwitch::use_material_map(bool use) {
+	if (use && !material_map_)
+		return false;
+	current_ = (use) ? material_map_ : tgeo_material_;
+	return true;
+}
+
+bool MaterialInterfaceSwitch::initTrack(double posX, double posY,
+		double posZ, double dirX, double dirY, double dirZ) {
+	return current_->initTrack(posX, posY, posZ, dirX, dirY, dirZ);
+}
+
+void MaterialInterfaceSwitch::getMaterialParameters(double& density,
+		double& Z, double& A, double& radiationLength, double& mEE) {
+	current_->getMaterialParameters(density, Z, A, radiationLength, mEE);
+}
+
+void MaterialInterfaceSwitch::getMaterialParameters(
+		MaterialProperties& parameters) {
+	current_->getMaterialParameters(parameters);
+}
+
+double MaterialInterfaceSwitch::findNextBoundary(const RKTrackRep* rep,
+		const M1x7& state7, double sMax, bool varField) {
+	return current_->findNextBoundary(rep, state7, sMax, varField);
+}
+
+} /* End of namespace genfit */
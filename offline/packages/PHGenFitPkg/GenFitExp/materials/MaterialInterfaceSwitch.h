@@ -0,0 +1,71 @@
+/** @addtogroup genfit
+ * @{
+ */
+
+#ifndef genfit_MaterialInterfaceSwitch_h
+#define genfit_MaterialInterfaceSwitch_h
+
+#include "GenFit/AbsMaterialInterface.h"
+
+namespace genfit {
+
+/** @brief Material interface handing the calls to the TGeo navigation or to a material map
+ *
+ *  genfit::MaterialEffects is a singleton which is initialized once with
+ *  one material interface for the whole process. This interface is the one
+ *  registered, the material is switched inside it between tracks.
+ *
+ *  It owns the TGeo interface and the map. Once registered it belongs to
+ *  MaterialEffects and has to stay alive as long as the singleton.
+ */
+class MaterialInterfaceSwitch : public AbsMaterialInterface {
+ public:
+  //! takes tgeo_material
+  explicit MaterialInterfaceSwitch(AbsMaterialInterface* tgeo_material);
+  ~MaterialInterfaceSwitch();
+
+  /** @brief Take material_map, the previous map is deleted.
+   *
+   *  NULL drops the map and goes back to the TGeo navigation.
+   */
+  void set_material_map(AbsMaterialInterface* material_map);
+
+  const AbsMaterialInterface* get_material_map() const {return material_map_;}
+
+  //! false if there is no map to switch to
+  bool use_material_map(bool use);
+
+  bool is_use_material_map() const {return current_ != tgeo_material_;}
+
+  bool initTrack(double posX, double posY, double posZ,
+                 double dirX, double dirY, double dirZ);
+
+  void getMaterialParameters(double& density,
+                             double& Z,
+                             double& A,
+                             double& radiationLength,
+                             double& mEE);
+
+  void getMaterialParameters(MaterialProperties& parameters);
+
+  double findNextBoundary(const RKTrackRep* rep,
+                          const M1x7& state7,
+                          double sMax,
+                          bool varField = true);
+
+ private:
+
+  MaterialInterfaceSwitch(const MaterialInterfaceSwitch&);
+  MaterialInterfaceSwitch& operator=(const MaterialInterfaceSwitch&);
+
+  AbsMaterialInterface* tgeo_material_;
+  AbsMaterialInterface* material_map_;
+
+  //! one of the two above
+  AbsMaterialInterface* current_;
+};
+
+} /* End of namespace genfit */
+/** @} */
+
+#endif // genfit_MaterialInterfaceSwitch_h
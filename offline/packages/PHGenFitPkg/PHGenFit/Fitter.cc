@@ -25,6 +25,8 @@
 
 //GenFitExp
 #include <genfitexp/Field2D.h>
+#include <genfitexp/CylindricalMaterialInterface.h>
+#include <genfitexp/MaterialInterfaceSwitch.h>
 
 //PHGenFit
 #include "Fitter.h"
@@ -34,6 +36,25 @@
 #define LogERROR(exp)		std::cout<<"ERROR: "<<__FILE__<<": "<<__LINE__<<": "<< exp <<"\n"
 #define LogWARNING(exp)	std::cout<<"WARNING: "<<__FILE__<<": "<<__LINE__<<": "<< exp <<"\n"
 
+namespace {
+
+/*!
+ * The material interface of genfit::MaterialEffects, which can only be initialized once.
+ * The first fitter registers it, the others switch the material inside it.
+ */
+genfit::MaterialInterfaceSwitch* material_switch()
+{
+	static genfit::MaterialInterfaceSwitch* material = NULL;
+	if(!material)
+	{
+		material = new genfit::MaterialInterfaceSwitch(new genfit::TGeoMaterialInterface());
+		genfit::MaterialEffects::getInstance()->init(material);
+	}
+	return material;
+}
+
+}
+
 namespace PHGenFit {
 
 Fitter::Fitter(
@@ -43,7 +64,8 @@ Fitter::Fitter(
 		const std::string fitter_choice,
 		const std::string track_rep_choice,
 		const bool doEventDisplay
-) : verbosity(0), _doEventDisplay(doEventDisplay)
+) : verbosity(0), _doEventDisplay(doEventDisplay),
+		_material(material_switch())
 {
 	_tgeo_manager = new TGeoManager("Default", "Geane geometry");
 	TGeoManager::Import(tgeo_file_name.data());
@@ -53,8 +75,6 @@ Fitter::Fitter(
 
 	genfit::FieldManager::getInstance()->init(
 			fieldMap);
-	genfit::MaterialEffects::getInstance()->init(
-			new genfit::TGeoMaterialInterface());
 
 	// init event display
 	if(_doEventDisplay)
@@ -172,13 +192,12 @@ Fitter* Fitter::getInstance(TGeoManager* tgeo_manager,
 
 Fitter::Fitter(TGeoManager* tgeo_manager, genfit::AbsBField* fieldMap,
 		const std::string fitter_choice, const std::string track_rep_choice,
-		const bool doEventDisplay): verbosity(0), _tgeo_manager(tgeo_manager), _doEventDisplay(doEventDisplay)
+		const bool doEventDisplay): verbosity(0), _tgeo_manager(tgeo_manager), _doEventDisplay(doEventDisplay),
+		_material(material_switch())
 {
 
 	genfit::FieldManager::getInstance()->init(
 			fieldMap);
-	genfit::MaterialEffects::getInstance()->init(
-			new genfit::TGeoMaterialInterface());
 
 	// init event display
 	if(_doEventDisplay)
@@ -195,6 +214,49 @@ Fitter::Fitter(TGeoManager* tgeo_manager, genfit::AbsBField* fieldMap,
 		_fitter = new genfit::KalmanFitter();
 }
 
+bool Fitter::build_material_map(const double r_max, const double z_max,
+		const double dr, const double dz, const unsigned int nphi)
+{
+	// TGeoMaterialInterface navigates gGeoManager as well
+	if(!gGeoManager)
+	{
+		LogERROR("No TGeoManager found!");
+		return false;
+	}
+
+	genfit::CylindricalMaterialInterface* material_map = new genfit::CylindricalMaterialInterface();
+	if(!material_map->build(gGeoManager, r_max, z_max, dr, dz, nphi))
+	{
+		LogERROR("Material map building failed!");
+		delete material_map;
+		return false;
+	}
+
+	_material->set_material_map(material_map);
+
+	return true;
+}
+
+bool Fitter::use_material_map(const bool use)
+{
+	if(!_material->use_material_map(use))
+	{
+		LogERROR("No material map, call build_material_map() first!");
+		return false;
+	}
+	return true;
+}
+
+bool Fitter::is_use_material_map() const
+{
+	return _material->is_use_material_map();
+}
+
+const genfit::CylindricalMaterialInterface* Fitter::get_material_map() const
+{
+	return dynamic_cast<const genfit::CylindricalMaterialInterface*>(_material->get_material_map());
+}
+
 int Fitter::displayEvent()
 {
 	if(_display)
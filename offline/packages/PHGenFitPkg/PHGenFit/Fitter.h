@@ -27,6 +27,8 @@ namespace genfit{
 	class EventDisplay;
 	class AbsKalmanFitter;
 	class AbsBField;
+	class CylindricalMaterialInterface;
+	class MaterialInterfaceSwitch;
 	class Field2D;
 }
 
@@ -67,6 +69,25 @@ public:
 			const std::string track_rep_choice = "RKTrackRep",
 			const bool doEventDisplay = false);
 
+	/*!
+	 * Trace the geometry into a (r,z) material map, see genfit::CylindricalMaterialInterface.
+	 * Units are cm. The material effects keep using TGeo until use_material_map(true).
+	 */
+	bool build_material_map(const double r_max, const double z_max,
+			const double dr = 0.01, const double dz = 5.,
+			const unsigned int nphi = 72);
+
+	/*!
+	 * Switch the material effects between the material map and the TGeo navigation.
+	 * genfit::MaterialEffects is a singleton, this applies to all fitters.
+	 */
+	bool use_material_map(const bool use);
+
+	bool is_use_material_map() const;
+
+	//! the map of the last build_material_map() of any fitter, NULL if none
+	const genfit::CylindricalMaterialInterface* get_material_map() const;
+
 	int processTrack(PHGenFit::Track* track, const bool save_to_evt_disp = false);
 
 	int displayEvent();
@@ -115,6 +136,9 @@ private:
 	genfit::EventDisplay* _display;
 	genfit::AbsKalmanFitter* _fitter;
 
+	//! material interface of genfit::MaterialEffects, shared by all fitters and never deleted
+	genfit::MaterialInterfaceSwitch* _material;
+
 }; //class Fitter
 
 } //End of PHGenFit namespace
@@ -32,6 +32,7 @@ VariableArray::identify(ostream &os) const
 void
 VariableArray::set_val(const vector<short> &vec)
 {
+  delete [] sval;
   nVal = vec.size();
   sval = new short[nVal];
   vector<short>::const_iterator iter;
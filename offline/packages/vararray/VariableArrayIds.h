@@ -7,7 +7,12 @@ namespace varids
     {
       TECHITV1 = 6000,
       G4VTXV1 = 1,
-      G4PARTICLEV1 = 2
+      G4PARTICLEV1 = 2,
+      G4HITV1 = 3,
+      TOWERV1 = 4,
+      SVTXHITV1 = 5,
+      SVTXCLUSTERV1 = 6,
+      G4CELLV1 = 7
     };
 };
 
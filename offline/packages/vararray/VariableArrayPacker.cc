@@ -0,0 +1,352 @@
+#include "VariableArrayPacker.h"
+#include "VariableArray.h"
+#include "VariableArrayUtils.h"
+
+#include <phool/phool.h>
+
+#include <iomanip>
+
+using namespace std;
+
+static const short PACKERVERSION = 1;
+
+// 32 bit words are stored as two shorts, low bits first
+union u_word32
+{
+  float fdata;
+  int idata;
+  unsigned short sdata[2];
+};
+
+static void
+push_word32(vector<short> &vec, const u_word32 &w)
+{
+  vec.push_back(w.sdata[0]);
+  vec.push_back(w.sdata[1]);
+  return;
+}
+
+// differences which do not fit into a short are flagged by this value and
+// follow as a full 32 bit word
+static const short DELTA_ESCAPE = -32768;
+
+static u_word32
+get_word32(const short *sval)
+{
+  u_word32 w;
+  w.sdata[0] = sval[0];
+  w.sdata[1] = sval[1];
+  return w;
+}
+
+VariableArrayPacker::VariableArrayPacker(const string &nam):
+  name(nam),
+  nvalues(0),
+  rawbytes(0),
+  packedbytes(0),
+  nclamped(0),
+  packtimer(nam + "_pack"),
+  unpacktimer(nam + "_unpack")
+{}
+
+void
+VariableArrayPacker::identify(ostream &os) const
+{
+  os << name << " packs " << fields.size() << " fields" << endl;
+  for (vector<Field>::const_iterator iter = fields.begin(); iter != fields.end(); ++iter)
+    {
+      os << "  " << iter->name << ": encoding " << iter->encoding;
+      if (iter->encoding == FIXED16)
+        {
+          os << ", precision " << iter->precision;
+        }
+      os << endl;
+    }
+  return;
+}
+
+unsigned int
+VariableArrayPacker::AddField(const string &fieldname, const Encoding enc, const float precision)
+{
+  Field field;
+  field.name = fieldname;
+  field.encoding = enc;
+  field.precision = precision;
+  fields.push_back(field);
+  return fields.size() - 1;
+}
+
+bool
+VariableArrayPacker::SetEncoding(const string &fieldname, const Encoding enc, const float precision)
+{
+  for (vector<Field>::iterator iter = fields.begin(); iter != fields.end(); ++iter)
+    {
+      if (iter->name != fieldname)
+        {
+          continue;
+        }
+      if (IsIntEncoding(iter->encoding) != IsIntEncoding(enc))
+        {
+          cout << PHWHERE << " field " << fieldname << " of " << name
+               << " cannot switch between int and float encoding" << endl;
+          return false;
+        }
+      if (enc == FIXED16 && precision <= 0)
+        {
+          cout << PHWHERE << " field " << fieldname << " of " << name
+               << " needs a positive precision for fixed point encoding" << endl;
+          return false;
+        }
+      iter->encoding = enc;
+      iter->precision = precision;
+      return true;
+    }
+  cout << PHWHERE << " no field " << fieldname << " in " << name << endl;
+  return false;
+}
+
+void
+VariableArrayPacker::Clear()
+{
+  for (vector<Field>::iterator iter = fields.begin(); iter != fields.end(); ++iter)
+    {
+      iter->fval.clear();
+      iter->ival.clear();
+    }
+  return;
+}
+
+unsigned int
+VariableArrayPacker::Size(const unsigned int ifield) const
+{
+  const Field &field = fields[ifield];
+  return (IsIntEncoding(field.encoding) ? field.ival.size() : field.fval.size());
+}
+
+void
+VariableArrayPacker::Pack(VariableArray *vararray)
+{
+  packtimer.restart();
+  packbuffer.clear();
+  packbuffer.push_back(PACKERVERSION);
+  packbuffer.push_back(fields.size());
+  for (vector<Field>::const_iterator iter = fields.begin(); iter != fields.end(); ++iter)
+    {
+      u_word32 w;
+      packbuffer.push_back(iter->encoding);
+      w.fdata = iter->precision;
+      push_word32(packbuffer, w);
+      unsigned int n = (IsIntEncoding(iter->encoding) ? iter->ival.size() : iter->fval.size());
+      w.idata = n;
+      push_word32(packbuffer, w);
+      nvalues += n;
+      rawbytes += n * 4;
+      switch (iter->encoding)
+        {
+        case FLOAT32:
+          for (unsigned int i = 0; i < n; i++)
+            {
+              w.fdata = iter->fval[i];
+              push_word32(packbuffer, w);
+            }
+          break;
+        case INT32:
+          for (unsigned int i = 0; i < n; i++)
+            {
+              w.idata = iter->ival[i];
+              push_word32(packbuffer, w);
+            }
+          break;
+        case DELTA:
+          {
+            // unsigned arithmetic, the difference wraps around like the reader's sum
+            unsigned int prev = 0;
+            for (unsigned int i = 0; i < n; i++)
+              {
+                unsigned int cur = iter->ival[i];
+                w.idata = static_cast<int>(cur - prev);
+                prev = cur;
+                if (w.idata > DELTA_ESCAPE && w.idata <= 32767)
+                  {
+                    packbuffer.push_back(w.idata);
+                  }
+                else
+                  {
+                    packbuffer.push_back(DELTA_ESCAPE);
+                    push_word32(packbuffer, w);
+                  }
+              }
+          }
+          break;
+        case HALF:
+        case FIXED16:
+          {
+            // convert the whole column in one go, this is where the
+            // vectorized conversion pays off
+            size_t offset = packbuffer.size();
+            packbuffer.resize(offset + n);
+            if (n == 0)
+              {
+                break;
+              }
+            if (iter->encoding == HALF)
+              {
+                VariableArrayUtils::FloatToShortBits(&iter->fval[0], &packbuffer[offset], n);
+              }
+            else
+              {
+                nclamped += VariableArrayUtils::FloatToFixed(&iter->fval[0], &packbuffer[offset], n, iter->precision);
+              }
+          }
+          break;
+        }
+    }
+  packedbytes += packbuffer.size() * sizeof(short);
+  vararray->set_val(packbuffer);
+  packtimer.stop();
+  return;
+}
+
+int
+VariableArrayPacker::Unpack(const VariableArray *vararray)
+{
+  unpacktimer.restart();
+  Clear();
+  unsigned int size = vararray->get_array_size();
+  const short *sval = vararray->get_array();
+  const short *send = sval + size;
+  if (size < 2 || sval[0] != PACKERVERSION || static_cast<unsigned int>(sval[1]) != fields.size())
+    {
+      cout << PHWHERE << " payload of " << name << " does not match the "
+           << fields.size() << " fields of the schema" << endl;
+      unpacktimer.stop();
+      return -1;
+    }
+  sval += 2;
+  for (vector<Field>::iterator iter = fields.begin(); iter != fields.end(); ++iter)
+    {
+      if (send - sval < 5)
+        {
+          cout << PHWHERE << " truncated payload of " << name << endl;
+          unpacktimer.stop();
+          return -1;
+        }
+      Encoding enc = static_cast<Encoding>(sval[0]);
+      if (IsIntEncoding(enc) != IsIntEncoding(iter->encoding))
+        {
+          cout << PHWHERE << " field " << iter->name << " of " << name
+               << " was written with incompatible encoding " << enc << endl;
+          unpacktimer.stop();
+          return -1;
+        }
+      // what was written wins over the local configuration
+      iter->encoding = enc;
+      iter->precision = get_word32(sval + 1).fdata;
+      unsigned int n = get_word32(sval + 3).idata;
+      sval += 5;
+      // for DELTA this is the minimum, the escaped differences are counted while decoding
+      unsigned int nshorts = ((enc == FLOAT32 || enc == INT32) ? 2 * n : n);
+      if (static_cast<unsigned int>(send - sval) < nshorts)
+        {
+          cout << PHWHERE << " truncated payload of " << name << endl;
+          unpacktimer.stop();
+          return -1;
+        }
+      switch (enc)
+        {
+        case FLOAT32:
+          iter->fval.resize(n);
+          for (unsigned int i = 0; i < n; i++)
+            {
+              iter->fval[i] = get_word32(sval + 2 * i).fdata;
+            }
+          break;
+        case INT32:
+          iter->ival.resize(n);
+          for (unsigned int i = 0; i < n; i++)
+            {
+              iter->ival[i] = get_word32(sval + 2 * i).idata;
+            }
+          break;
+        case DELTA:
+          {
+            iter->ival.resize(n);
+            const short *sdelta = sval;
+            unsigned int prev = 0;
+            for (unsigned int i = 0; i < n; i++)
+              {
+                if (sdelta >= send || (*sdelta == DELTA_ESCAPE && send - sdelta < 3))
+                  {
+                    cout << PHWHERE << " truncated payload of " << name << endl;
+                    unpacktimer.stop();
+                    return -1;
+                  }
+                if (*sdelta == DELTA_ESCAPE)
+                  {
+                    prev += get_word32(sdelta + 1).idata;
+                    sdelta += 3;
+                  }
+                else
+                  {
+                    prev += *sdelta;
+                    sdelta++;
+                  }
+                iter->ival[i] = prev;
+              }
+            nshorts = sdelta - sval;
+          }
+          break;
+        case HALF:
+          iter->fval.resize(n);
+          if (n > 0)
+            {
+              VariableArrayUtils::ShortBitsToFloat(sval, &iter->fval[0], n);
+            }
+          break;
+        case FIXED16:
+          iter->fval.resize(n);
+          if (n > 0)
+            {
+              VariableArrayUtils::FixedToFloat(sval, &iter->fval[0], n, iter->precision);
+            }
+          break;
+        default:
+          cout << PHWHERE << " unknown encoding " << enc << " in payload of " << name << endl;
+          unpacktimer.stop();
+          return -1;
+        }
+      sval += nshorts;
+      nvalues += n;
+      rawbytes += n * 4;
+    }
+  packedbytes += size * sizeof(short);
+  unpacktimer.stop();
+  return 0;
+}
+
+void
+VariableArrayPacker::PrintReport(ostream &os) const
+{
+  os << name << ": " << nvalues << " values";
+  if (rawbytes > 0)
+    {
+      os << ", " << rawbytes << " bytes raw, " << packedbytes << " bytes packed ("
+         << setprecision(3) << 100. * (1. - static_cast<double>(packedbytes) / rawbytes)
+         << "% saved)";
+    }
+  if (nclamped > 0)
+    {
+      os << ", " << nclamped << " fixed point values clamped";
+    }
+  os << endl;
+  if (packtimer.get_ncycle() > 0)
+    {
+      os << "  pack:   " << packtimer.get_time_per_cycle() << " ms/event" << endl;
+    }
+  if (unpacktimer.get_ncycle() > 0)
+    {
+      os << "  unpack: " << unpacktimer.get_time_per_cycle() << " ms/event" << endl;
+    }
+  os << "  conversion: " << (VariableArrayUtils::HasF16C() ? "F16C" : "lookup table") << endl;
+  return;
+}
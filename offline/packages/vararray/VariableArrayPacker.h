@@ -0,0 +1,83 @@
+#ifndef VARIABLEARRAYPACKER_H_
+#define VARIABLEARRAYPACKER_H_
+
+#include <phool/PHTimer.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+class VariableArray;
+
+// packs columns of floats and ints into the short array of a VariableArray.
+// Every column (field) has its own encoding and length, so variable length
+// lists (e.g. hit ids of a cluster) are a count column plus a flat column.
+// The encodings and precisions are written into the payload, the reader
+// only has to know the order of the fields.
+class VariableArrayPacker
+{
+ public:
+  enum Encoding
+  {
+    FLOAT32 = 0,  // lossless float, 2 shorts
+    HALF = 1,     // 16 bit float
+    FIXED16 = 2,  // value/precision in 16 bits, clamped
+    INT32 = 3,    // lossless int, 2 shorts
+    DELTA = 4     // lossless int as difference to the previous value, 1 short
+                  // if it fits, 3 otherwise. Pays off for sorted keys and ids
+  };
+
+  VariableArrayPacker(const std::string &name = "VariableArrayPacker");
+  virtual ~VariableArrayPacker() {}
+
+  void identify(std::ostream &os = std::cout) const;
+
+  // schema, returns the field index
+  unsigned int AddField(const std::string &fieldname, const Encoding enc, const float precision = 0);
+  // change the encoding of an existing field, returns false if not found or
+  // if an int field is asked to become a float one (and vice versa)
+  bool SetEncoding(const std::string &fieldname, const Encoding enc, const float precision = 0);
+  unsigned int NFields() const {return fields.size();}
+
+  // clear the column buffers, the schema stays
+  void Clear();
+
+  void Fill(const unsigned int ifield, const float val) {fields[ifield].fval.push_back(val);}
+  void Fill(const unsigned int ifield, const int val) {fields[ifield].ival.push_back(val);}
+
+  void Pack(VariableArray *vararray);
+  // returns 0 on success, -1 if the payload does not match the schema
+  int Unpack(const VariableArray *vararray);
+
+  unsigned int Size(const unsigned int ifield) const;
+  float GetFloat(const unsigned int ifield, const unsigned int i) const {return fields[ifield].fval[i];}
+  int GetInt(const unsigned int ifield, const unsigned int i) const {return fields[ifield].ival[i];}
+
+  // bytes saved and coding cost accumulated over all Pack/Unpack calls
+  void PrintReport(std::ostream &os = std::cout) const;
+
+ protected:
+  struct Field
+  {
+    std::string name;
+    Encoding encoding;
+    float precision;
+    std::vector<float> fval;
+    std::vector<int> ival;
+  };
+
+  static bool IsIntEncoding(const Encoding enc) {return (enc == INT32 || enc == DELTA);}
+
+  std::string name;
+  std::vector<Field> fields;
+  std::vector<short> packbuffer;
+
+  unsigned long long nvalues;
+  unsigned long long rawbytes;
+  unsigned long long packedbytes;
+  unsigned long long nclamped;
+  PHTimer packtimer;
+  PHTimer unpacktimer;
+};
+
+#endif /* VARIABLEARRAYPACKER_H_ */
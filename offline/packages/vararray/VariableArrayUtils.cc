@@ -1,10 +1,58 @@
 #include "VariableArrayUtils.h"
 #include <half/half.h>
 
+#include <cmath>
+
+// runtime dispatch to the F16C conversion instructions, gcc >= 4.9 lets us
+// compile them into a single function without -mf16c for the whole library
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define VARARRAY_F16C_DISPATCH
+#include <immintrin.h>
+#endif
+
+#ifdef VARARRAY_F16C_DISPATCH
+__attribute__((target("avx,f16c")))
+static void
+FloatToShortBitsF16C(const float *rval, short *ival, const unsigned int n)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= n; i += 8)
+    {
+      __m256 fv = _mm256_loadu_ps(rval + i);
+      // 0 -> round to nearest even, which is what the half class does
+      __m128i hv = _mm256_cvtps_ph(fv, 0);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(ival + i), hv);
+    }
+  for (; i < n; i++)
+    {
+      half ftoi(rval[i]);
+      ival[i] = ftoi.bits();
+    }
+}
+
+__attribute__((target("avx,f16c")))
+static void
+ShortBitsToFloatF16C(const short *ival, float *rval, const unsigned int n)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= n; i += 8)
+    {
+      __m128i hv = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ival + i));
+      _mm256_storeu_ps(rval + i, _mm256_cvtph_ps(hv));
+    }
+  for (; i < n; i++)
+    {
+      half halfvar;
+      halfvar.setBits(ival[i]);
+      rval[i] = halfvar;
+    }
+}
+#endif
+
 short
 VariableArrayUtils::FloatToShortBits(const float rval)
 {
-    half ftoi(rval);  
+    half ftoi(rval);
     return ftoi.bits();
 }
 
@@ -15,3 +63,84 @@ VariableArrayUtils::ShortBitsToFloat(const short ival)
     halfvar.setBits(ival);
     return halfvar;
 }
+
+bool
+VariableArrayUtils::HasF16C()
+{
+#ifdef VARARRAY_F16C_DISPATCH
+  static const bool hasf16c = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+  return hasf16c;
+#else
+  return false;
+#endif
+}
+
+void
+VariableArrayUtils::FloatToShortBits(const float *rval, short *ival, const unsigned int n)
+{
+#ifdef VARARRAY_F16C_DISPATCH
+  if (HasF16C())
+    {
+      FloatToShortBitsF16C(rval, ival, n);
+      return;
+    }
+#endif
+  for (unsigned int i = 0; i < n; i++)
+    {
+      half ftoi(rval[i]);
+      ival[i] = ftoi.bits();
+    }
+  return;
+}
+
+void
+VariableArrayUtils::ShortBitsToFloat(const short *ival, float *rval, const unsigned int n)
+{
+#ifdef VARARRAY_F16C_DISPATCH
+  if (HasF16C())
+    {
+      ShortBitsToFloatF16C(ival, rval, n);
+      return;
+    }
+#endif
+  half halfvar;
+  for (unsigned int i = 0; i < n; i++)
+    {
+      halfvar.setBits(ival[i]);
+      rval[i] = halfvar;
+    }
+  return;
+}
+
+unsigned int
+VariableArrayUtils::FloatToFixed(const float *rval, short *ival, const unsigned int n, const float precision)
+{
+  const float scale = 1. / precision;
+  unsigned int nclamped = 0;
+  for (unsigned int i = 0; i < n; i++)
+    {
+      float fixed = rintf(rval[i] * scale);
+      if (fixed > 32767)
+        {
+          fixed = 32767;
+          nclamped++;
+        }
+      else if (fixed < -32768)
+        {
+          fixed = -32768;
+          nclamped++;
+        }
+      ival[i] = static_cast<short>(fixed);
+    }
+  return nclamped;
+}
+
+void
+VariableArrayUtils::FixedToFloat(const short *ival, float *rval, const unsigned int n, const float precision)
+{
+  for (unsigned int i = 0; i < n; i++)
+    {
+      rval[i] = ival[i] * precision;
+    }
+  return;
+}
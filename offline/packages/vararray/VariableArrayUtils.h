@@ -6,7 +6,18 @@ class VariableArrayUtils
  public:
   static short FloatToShortBits(const float rval);
   static float ShortBitsToFloat(const short ival);
+
+  // bulk conversions, use the F16C instructions if the cpu has them,
+  // the half lookup tables otherwise. Both give bit identical results
+  static void FloatToShortBits(const float *rval, short *ival, const unsigned int n);
+  static void ShortBitsToFloat(const short *ival, float *rval, const unsigned int n);
+
+  // fixed point with given precision, values outside the 16 bit range
+  // are clamped. Returns the number of clamped values
+  static unsigned int FloatToFixed(const float *rval, short *ival, const unsigned int n, const float precision);
+  static void FixedToFloat(const short *ival, float *rval, const unsigned int n, const float precision);
+
+  static bool HasF16C();
 };
 
 #endif
-
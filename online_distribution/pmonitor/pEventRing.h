@@ -0,0 +1,133 @@
+#ifndef __PEVENTRING_H__
+#define __PEVENTRING_H__
+
+#include <Event/Event.h>
+
+// bounded lock-free queue of events between the reader thread and the
+// worker threads. Every slot carries a sequence number which tells
+// whether it is free for the next push or filled for the next pop, so
+// neither side ever takes a lock (D. Vyukov's bounded MPMC queue)
+
+class pEventRing
+{
+
+ public:
+
+  // the size is rounded up to a power of 2
+  pEventRing(const unsigned int size = 1024)
+    {
+      unsigned int n = 2;
+      while (n < size) n <<= 1;
+      mask = n - 1;
+      buffer = new cell[n];
+      for (unsigned int i = 0; i < n; i++)
+	{
+	  buffer[i].seq = i;
+	  buffer[i].evt = 0;
+	}
+      enqueue_pos = 0;
+      dequeue_pos = 0;
+    };
+
+  virtual ~pEventRing()
+    {
+      Event *evt;
+      while ( (evt = pop()) )
+	{
+	  delete evt;
+	}
+      delete [] buffer;
+    };
+
+  // returns 0 if the event was queued, 1 if the ring is full
+  int push(Event *evt)
+    {
+      cell *c;
+      unsigned long pos = enqueue_pos;
+      for (;;)
+	{
+	  c = &buffer[pos & mask];
+	  unsigned long seq = c->seq;
+	  __sync_synchronize();
+	  long dif = (long) seq - (long) pos;
+	  if (dif == 0)
+	    {
+	      if (__sync_bool_compare_and_swap(&enqueue_pos, pos, pos + 1)) break;
+	    }
+	  else if (dif < 0)
+	    {
+	      return 1;
+	    }
+	  else
+	    {
+	      pos = enqueue_pos;
+	    }
+	}
+      c->evt = evt;
+      __sync_synchronize();
+      c->seq = pos + 1;
+      return 0;
+    };
+
+  // returns 0 if the ring is empty
+  Event *pop()
+    {
+      cell *c;
+      unsigned long pos = dequeue_pos;
+      for (;;)
+	{
+	  c = &buffer[pos & mask];
+	  unsigned long seq = c->seq;
+	  __sync_synchronize();
+	  long dif = (long) seq - (long) (pos + 1);
+	  if (dif == 0)
+	    {
+	      if (__sync_bool_compare_and_swap(&dequeue_pos, pos, pos + 1)) break;
+	    }
+	  else if (dif < 0)
+	    {
+	      return 0;
+	    }
+	  else
+	    {
+	      pos = dequeue_pos;
+	    }
+	}
+      Event *evt = c->evt;
+      __sync_synchronize();
+      c->seq = pos + mask + 1;
+      return evt;
+    };
+
+  // events waiting, only a snapshot while the threads are running
+  unsigned int depth() const
+    {
+      return enqueue_pos - dequeue_pos;
+    };
+
+  unsigned int capacity() const
+    {
+      return mask + 1;
+    };
+
+ private:
+
+  struct cell
+  {
+    volatile unsigned long seq;
+    Event *evt;
+  };
+
+  cell *buffer;
+  unsigned long mask;
+
+  // keep the two ends on different cache lines
+  char pad0[64];
+  volatile unsigned long enqueue_pos;
+  char pad1[64];
+  volatile unsigned long dequeue_pos;
+  char pad2[64];
+
+};
+
+#endif /* __PEVENTRING_H__ */
@@ -7,7 +7,10 @@
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <map>
+#include <vector>
 #include <unistd.h>
+#include <sys/time.h>
 
 #include "pmonitor.h"
 #include "pmonstate.h"
@@ -16,7 +19,9 @@
 
 #include <TThread.h>
 #include <TGClient.h>
+#include <TH1.h>
 #include <pMutex.h>
+#include <pEventRing.h>
 #include <pthread.h>
 
 #ifdef HAVE_FROG
@@ -39,7 +44,37 @@ static pMutex runningTM;
 
 using namespace std;
 
-pthread_mutex_t pmonmutex;
+pthread_mutex_t pmonmutex = PTHREAD_MUTEX_INITIALIZER;
+
+// multi-threaded mode, see psetthreads()
+static int nworkers = 1;
+static pEventRing *eventRing = 0;
+static TThread *mt_thread = 0;
+static volatile int readerdone = 0;
+static int mergeinterval = 100;
+// -1 outside of the worker threads
+static __thread long worker_index = -1;
+
+// histograms filled through phisto(), one copy per worker
+static vector<TH1 *> registeredHistos;
+static map<TH1 *, unsigned int> histoIndex;
+static vector<vector<TH1 *> > workerHistos;
+
+// rate and lag counters for pstatus()
+static volatile unsigned long nread = 0;
+static volatile unsigned long nprocessed = 0;
+static volatile unsigned long nfullwaits = 0;
+static volatile unsigned long nmerges = 0;
+static double starttime = 0;
+static double lasttime = 0;
+static unsigned long lastprocessed = 0;
+
+static double pnow()
+{
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + 1e-6 * tv.tv_usec;
+}
 
 int pstatus()
 {
@@ -51,6 +86,27 @@ int pstatus()
   else
     cout << endl;
 
+  if (nworkers > 1 && starttime > 0)
+    {
+      double now = pnow();
+      cout << " " << nworkers << " worker threads, "
+	   << nread << " events read, " << nprocessed << " processed, "
+	   << nread - nprocessed << " behind (ring " << eventRing->depth()
+	   << "/" << eventRing->capacity() << ", full " << nfullwaits << " times), "
+	   << nmerges << " histogram merges" << endl;
+      if (now > starttime)
+	{
+	  cout << " rate " << nprocessed / (now - starttime) << " Hz since start";
+	}
+      if (now > lasttime && lasttime > 0)
+	{
+	  cout << ", " << (nprocessed - lastprocessed) / (now - lasttime) << " Hz since last pstatus()";
+	}
+      cout << endl;
+      lasttime = now;
+      lastprocessed = nprocessed;
+    }
+
   return 0;
 }
 
@@ -287,6 +343,246 @@ void pprocess (void * ptr)
 }
 
 
+//-----------------------------------------
+
+// adds the worker copies into the registered histograms and clears them
+static void pmerge(const long worker)
+{
+  if (workerHistos.empty())
+    {
+      return;
+    }
+  pthread_mutex_lock(&pmonmutex);
+  for (unsigned int i = 0; i < registeredHistos.size(); i++)
+    {
+      registeredHistos[i]->Add(workerHistos[worker][i]);
+      workerHistos[worker][i]->Reset();
+    }
+  pthread_mutex_unlock(&pmonmutex);
+  __sync_fetch_and_add(&nmerges, 1);
+}
+
+void pworker (void * ptr)
+{
+  worker_index = (long) ptr;
+  int nsincemerge = 0;
+  while (1)
+    {
+      Event *evt = eventRing->pop();
+      if (!evt)
+        {
+          if (readerdone)
+            {
+              // the reader may have queued its last event after our pop
+              evt = eventRing->pop();
+              if (!evt)
+                break;
+            }
+          else
+            {
+              usleep(50);
+              continue;
+            }
+        }
+      if (stopcondition)
+        {
+          // drain the ring
+          delete evt;
+          continue;
+        }
+      int istat = process_event(evt);
+      delete evt;
+      __sync_fetch_and_add(&nprocessed, 1);
+      if (istat)
+        {
+          theState.setloopStatus(istat);
+          stopcondition = 1;
+        }
+      if (mergeinterval > 0 && ++nsincemerge >= mergeinterval)
+        {
+          pmerge(worker_index);
+          nsincemerge = 0;
+        }
+    }
+  pmerge(worker_index);
+  return ;
+}
+
+// reader thread of the multi-threaded mode, it feeds the ring and the
+// workers call process_event
+void pprocess_mt (void * ptr)
+{
+  theState.setloopStatus(0); //clear loop status field
+  int nevents = totalevents;
+  stopcondition = 0;
+
+  runningTM.Lock();
+
+  theState.setRunning();
+  theState.clearNoevt();
+
+  nread = nprocessed = nfullwaits = nmerges = 0;
+  lastprocessed = 0;
+  starttime = pnow();
+  lasttime = starttime;
+  readerdone = 0;
+
+  // the worker copies of the histograms are made before any thread runs
+  TThread::Lock();
+  Bool_t adddir = TH1::AddDirectoryStatus();
+  TH1::AddDirectory(kFALSE);
+  workerHistos.resize(nworkers);
+  for (int i = 0; i < nworkers; i++)
+    {
+      for (unsigned int j = 0; j < registeredHistos.size(); j++)
+        {
+          TH1 *h = (TH1 *) registeredHistos[j]->Clone();
+          h->Reset();
+          workerHistos[i].push_back(h);
+        }
+    }
+  TH1::AddDirectory(adddir);
+  TThread::UnLock();
+
+  vector<TThread *> workers;
+  for (long i = 0; i < nworkers; i++)
+    {
+      ostringstream name;
+      name << "pworker" << i;
+      workers.push_back(new TThread(name.str().c_str(), pworker, (void *) i));
+      workers.back()->Run();
+    }
+
+  Event *evt;
+  evt = theIterator->getNextEvent();
+  int ncount = 0;
+
+  if (theGui)
+    theGui->setStatusLabel("Running");
+  while (evt )
+    {
+      if (theGui)
+        theGui->setEvtnrLabel(evt->getEvtSequence() );
+      if (theState.isIdentifyFlag())
+        evt->identify();
+      theState.incrementNoevt();
+      int full = 0;
+      while ( (full = eventRing->push(evt)) && !stopcondition)
+        {
+          nfullwaits++;
+          usleep(100);
+        }
+      if (full)
+        {
+          delete evt;
+        }
+      else
+        {
+          nread++;
+        }
+      if (stopcondition)
+        break;
+      if ( ( nevents > 0 && ++ncount >= nevents) )
+        break;
+      evt = theIterator->getNextEvent();
+    }
+
+  readerdone = 1;
+  for (unsigned int i = 0; i < workers.size(); i++)
+    {
+      workers[i]->Join();
+      delete workers[i];
+    }
+
+  TThread::Lock();
+  for (unsigned int i = 0; i < workerHistos.size(); i++)
+    {
+      for (unsigned int j = 0; j < workerHistos[i].size(); j++)
+        {
+          delete workerHistos[i][j];
+        }
+    }
+  workerHistos.clear();
+  TThread::UnLock();
+
+  theState.clearRunning();
+  if (stopcondition)
+    {
+      runningTM.Release();
+      if (theGui)
+        theGui->setStatusLabel("Stopped");
+      return ;
+    }
+  if (!evt)
+    pclose();
+  if (theGui)
+    theGui->setEvtnrLabel(0);
+  if (theGui)
+    theGui->setStatusLabel("Stopped");
+  runningTM.Release();
+  return ;
+}
+
+//-----------------------------------------
+
+int psetthreads (const int nthreads, const int ringsize)
+{
+  if (theState.isRunning() )
+    {
+      cout << "Still running, stop first" << endl;
+      return 1;
+    }
+  if (nthreads < 1 || ringsize < 1)
+    {
+      cout << "need at least one thread and a ring size > 0" << endl;
+      return 1;
+    }
+  nworkers = nthreads;
+  delete eventRing;
+  eventRing = 0;
+  if (nworkers > 1)
+    {
+      eventRing = new pEventRing(ringsize);
+    }
+  return 0;
+}
+
+int pregister (TH1 *h)
+{
+  if (theState.isRunning() )
+    {
+      cout << "Still running, stop first" << endl;
+      return 1;
+    }
+  if (!h || histoIndex.find(h) != histoIndex.end())
+    {
+      return 1;
+    }
+  histoIndex[h] = registeredHistos.size();
+  registeredHistos.push_back(h);
+  return 0;
+}
+
+TH1 *phisto (TH1 *h)
+{
+  if (worker_index < 0 || workerHistos.empty())
+    {
+      return h;
+    }
+  map<TH1 *, unsigned int>::const_iterator iter = histoIndex.find(h);
+  if (iter == histoIndex.end())
+    {
+      return h;
+    }
+  return workerHistos[worker_index][iter->second];
+}
+
+int psetmerge (const int nevents)
+{
+  mergeinterval = nevents;
+  return 0;
+}
+
 //-----------------------------------------
 
 int pstart (const int nevents)
@@ -305,6 +601,14 @@ int pstart (const int nevents)
 
   totalevents = nevents;
 
+  if (nworkers > 1)
+    {
+      if (!mt_thread)
+        mt_thread = new TThread ( pprocess_mt);
+      mt_thread->Run();
+      return 0;
+    }
+
   if (!main_thread)
     main_thread = new TThread ( pprocess);
   main_thread->Run();
@@ -405,8 +709,6 @@ int pclose()
 int mylock = 0;
 int plock()
 {
-  if (!mylock)
-    pthread_mutex_init(&pmonmutex, NULL);
   if (mylock)
     {
       cout << "Locked already" << endl;
@@ -558,6 +860,10 @@ void phelp()
   cout << " pstart(nevt)              starts event loop for nevt events in background" << endl;
   cout << " prun(nevt)                run nevt events" << endl;
   cout << endl;
+  cout << " psetthreads(n, ringsize)  pstart runs process_event in n threads (must be thread safe)" << endl;
+  cout << " pregister(h)              histogram h gets one copy per thread, fill phisto(h) in process_event" << endl;
+  cout << " psetmerge(nevt)           add the thread copies to the histograms every nevt events" << endl;
+  cout << endl;
   cout << " pidentify()               identify the next event read from the data stream" << endl;
   cout << " pidentify(5)              identify the next 5 events read from the data stream" << endl;
   cout << " pidentify(0)              identify all events read from the data stream (lots of output!)" << endl;
@@ -3,6 +3,8 @@
 
 #include <Event/Event.h>
 
+class TH1;
+
 int pstatus ();                         
 
 int ptestopen ();                       
@@ -34,6 +36,16 @@ int pexitstatus();
 int pgui ();                            
 int prmgui ();
 
+// multi-threaded mode: pstart() hands the events to nthreads workers
+// through a ring of ringsize events. Histograms registered with
+// pregister() are filled through phisto(h), which returns the copy of
+// the calling thread. The copies are added to h (under plock) every
+// psetmerge() events and at the end of the run
+int psetthreads (const int nthreads, const int ringsize = 1024);
+int pregister (TH1 *h);
+TH1 *phisto (TH1 *h);
+int psetmerge (const int nevents);
+
 int pinit ();
 int process_event (Event * e);
 
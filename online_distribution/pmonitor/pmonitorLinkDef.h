@@ -12,13 +12,17 @@
 #pragma link C++ function pgui;
 #pragma link C++ function phelp;
 #pragma link C++ function phsave;
+#pragma link C++ function phisto;
 #pragma link C++ function pidentify;
 #pragma link C++ function plistopen;
 #pragma link C++ function plock;
 #pragma link C++ function poncsopen;
 #pragma link C++ function rcdaqopen;
+#pragma link C++ function pregister;
 #pragma link C++ function prelease;
 #pragma link C++ function prun;
+#pragma link C++ function psetmerge;
+#pragma link C++ function psetthreads;
 #pragma link C++ function pstart;
 #pragma link C++ function pstatus;
 #pragma link C++ function pstop;
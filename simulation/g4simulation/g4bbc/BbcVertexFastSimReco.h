@@ -9,12 +9,6 @@
 
 #include <fun4all/SubsysReco.h>
 
-// rootcint barfs with this header so we need to hide it
-#ifndef __CINT__
-#include <gsl/gsl_rng.h>
-#endif
-
-
 class PHCompositeNode;
 
 /// \class BbcVertexFastSimReco
@@ -43,10 +37,6 @@ class BbcVertexFastSimReco : public SubsysReco {
   float _t_smear;
   float _z_smear;
 
-#ifndef __CINT__
-  gsl_rng *RandomGenerator;
-#endif
-
 };
 
 #endif // __BBCVERTEXFASTSIMRECO_H__
@@ -13,14 +13,12 @@
 #include <phool/PHCompositeNode.h>
 #include <phool/PHNodeIterator.h>
 #include <phool/PHIODataNode.h>
-#include <phool/PHRandomSeed.h>
+#include <phool/PHPhiloxRandom.h>
+#include <phool/PHRandomService.h>
 #include <fun4all/Fun4AllReturnCodes.h>
 #include <phool/getClass.h>
 #include <phool/recoConsts.h>
 
-#include <gsl/gsl_rng.h>
-#include <gsl/gsl_randist.h>
-
 #include <cmath>
 #include <iostream>
 #include <map>
@@ -45,22 +43,25 @@ RawTowerDigitizer::RawTowerDigitizer(const std::string& name) :
   _tower_type(-1),
   _timer(PHTimeServer::get()->insert_new(name))
 {
-  RandomGenerator = gsl_rng_alloc(gsl_rng_mt19937);
-  seed = PHRandomSeed(); // fixed seed handled in PHRandomSeed()
-  cout << Name() << " Random Seed: " << seed << endl;
-  gsl_rng_set(RandomGenerator, seed);
+  cout << Name() << " Random Seed: " << get_seed() << endl;
+  RandomGenerator = new PHPhiloxRandom();
 }
 
 RawTowerDigitizer::~RawTowerDigitizer()
 {
-  gsl_rng_free(RandomGenerator);
+  delete RandomGenerator;
 }
 
 void
 RawTowerDigitizer::set_seed(const unsigned int iseed)
 {
-  seed = iseed;
-  gsl_rng_set(RandomGenerator, seed);
+  PHRandomService::instance()->SetModuleSeed(Name(), iseed);
+}
+
+unsigned int
+RawTowerDigitizer::get_seed() const
+{
+  return PHRandomService::instance()->GetSeed(Name());
 }
 
 int
@@ -113,6 +114,9 @@ RawTowerDigitizer::process_event(PHCompositeNode *topNode)
   // pedestals
   RawTowerGeomContainer::ConstRange all_towers = rawtowergeom->get_tower_geometries();
 
+  // generator of this module in this event, each tower picks its stream below
+  *RandomGenerator = PHRandomService::instance()->GetStream(Name());
+
   for (RawTowerGeomContainer::ConstIterator it = all_towers.first;
        it != all_towers.second; ++it)
     {
@@ -129,6 +133,9 @@ RawTowerDigitizer::process_event(PHCompositeNode *topNode)
       RawTower *sim_tower = _sim_towers->getTower(key);
       RawTower *digi_tower = nullptr;
 
+      // random stream of this tower in this event
+      RandomGenerator->SetStream(key);
+
       if (_digi_algorithm == kNo_digitization)
 	{
 	  // for no digitization just copy existing towers
@@ -187,10 +194,10 @@ RawTowerDigitizer::simple_photon_digitization(RawTower * sim_tower)
       energy = sim_tower->get_energy();
     }
   const double photon_count_mean = energy * _photonelec_yield_visible_GeV;
-  const int photon_count = gsl_ran_poisson(RandomGenerator, photon_count_mean);
+  const int photon_count = RandomGenerator->Poisson(photon_count_mean);
   const int signal_ADC = floor(photon_count / _photonelec_ADC);
 
-  const double pedstal = _pedstal_central_ADC + ((_pedstal_width_ADC > 0) ? gsl_ran_gaussian(RandomGenerator, _pedstal_width_ADC) : 0);
+  const double pedstal = _pedstal_central_ADC + ((_pedstal_width_ADC > 0) ? RandomGenerator->Gaus(0, _pedstal_width_ADC) : 0);
   const int sum_ADC = signal_ADC + (int) pedstal;
 
   if (sum_ADC > _zero_suppression_ADC)
@@ -11,15 +11,14 @@ class RawTowerContainer;
 class RawTowerGeomContainer;
 
 class RawTower;
-
-// rootcint barfs with this header so we need to hide it
-#ifndef __CINT__
-#include <gsl/gsl_rng.h>
-#endif
+class PHPhiloxRandom;
 
 //! simple tower digitizer which sum all cell to produce photon yield and pedstal noises
 //! default input DST node is TOWER_SIM_DETECTOR
 //! default output DST node is TOWER_RAW_DETECTOR
+//! every tower draws from its own stream of the PHRandomService (seed, run, event, module name,
+//! tower key) so the result does not depend on the order in which towers or calorimeters are
+//! processed. Digitizers of different calorimeters need different module names
 class RawTowerDigitizer : public SubsysReco
 {
 
@@ -34,7 +33,7 @@ public:
   void TowerType(const int type) {_tower_type = type;} 
 
   void set_seed(const unsigned int iseed);
-  unsigned int get_seed() const {return seed;}
+  unsigned int get_seed() const;
 
   enum enu_digi_algorithm
   {
@@ -186,10 +185,7 @@ protected:
 
   PHTimeServer::timer _timer;
 
-  unsigned int seed;
-#ifndef __CINT__
-  gsl_rng *RandomGenerator;
-#endif
+  PHPhiloxRandom *RandomGenerator;
 };
 
 #endif /* RawTowerDigitizer_H__ */
@@ -0,0 +1,224 @@
+#include "RawTowerPipeline.h"
+
+#include <fun4all/Fun4AllReturnCodes.h>
+#include <phool/PHCompositeNode.h>
+
+#include <Seamstress/Pincushion.h>
+
+#include <iostream>
+
+using namespace std;
+
+RawTowerPipeline::RawTowerPipeline(const std::string& name) :
+  SubsysReco(name),
+  _topNode(nullptr),
+  _nthreads(1),
+  _seamstresses(nullptr),
+  _pins(nullptr)
+{
+}
+
+RawTowerPipeline::~RawTowerPipeline()
+{
+  if (_seamstresses)
+    {
+      for (unsigned int i = 0; i < _seamstresses->size(); ++i)
+	{
+	  (*_seamstresses)[i]->stop();
+	}
+      for (unsigned int i = 0; i < _seamstresses->size(); ++i)
+	{
+	  delete (*_seamstresses)[i];
+	}
+      delete _seamstresses;
+    }
+  delete _pins;
+
+  for (unsigned int icalo = 0; icalo < _chains.size(); ++icalo)
+    {
+      for (unsigned int i = 0; i < _chains[icalo].size(); ++i)
+	{
+	  delete _chains[icalo][i];
+	}
+    }
+}
+
+void
+RawTowerPipeline::AddModule(const std::string &detector, SubsysReco *module)
+{
+  for (unsigned int icalo = 0; icalo < _detectors.size(); ++icalo)
+    {
+      if (_detectors[icalo] == detector)
+	{
+	  _chains[icalo].push_back(module);
+	  return;
+	}
+    }
+  _detectors.push_back(detector);
+  _chains.push_back(vector<SubsysReco *>(1, module));
+}
+
+int
+RawTowerPipeline::Init(PHCompositeNode *topNode)
+{
+  for (unsigned int icalo = 0; icalo < _chains.size(); ++icalo)
+    {
+      for (unsigned int i = 0; i < _chains[icalo].size(); ++i)
+	{
+	  int iret = _chains[icalo][i]->Init(topNode);
+	  if (iret != Fun4AllReturnCodes::EVENT_OK)
+	    {
+	      cout << Name() << "::" << __PRETTY_FUNCTION__ << " " << _chains[icalo][i]->Name()
+		   << " of " << _detectors[icalo] << " returned " << iret << endl;
+	      return iret;
+	    }
+	}
+    }
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+int
+RawTowerPipeline::InitRun(PHCompositeNode *topNode)
+{
+  // the nodes are created here, always in order
+  for (unsigned int icalo = 0; icalo < _chains.size(); ++icalo)
+    {
+      for (unsigned int i = 0; i < _chains[icalo].size(); ++i)
+	{
+	  int iret = _chains[icalo][i]->InitRun(topNode);
+	  if (iret != Fun4AllReturnCodes::EVENT_OK)
+	    {
+	      cout << Name() << "::" << __PRETTY_FUNCTION__ << " " << _chains[icalo][i]->Name()
+		   << " of " << _detectors[icalo] << " returned " << iret << endl;
+	      return iret;
+	    }
+	}
+    }
+
+  if (_nthreads > 1 && _chains.size() > 1 && !_pins)
+    {
+      _seamstresses = SeamStress::Seamstress::create_vector(_nthreads);
+      _pins = new SeamStress::Pincushion<RawTowerPipeline>(this, _seamstresses);
+    }
+
+  if (verbosity > 0)
+    {
+      Print();
+    }
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+int
+RawTowerPipeline::process_event(PHCompositeNode *topNode)
+{
+  _topNode = topNode;
+  _retcodes.assign(_chains.size(), Fun4AllReturnCodes::EVENT_OK);
+  if (_pins)
+    {
+      _pins->sewStraight(&RawTowerPipeline::process_calorimeters_thread, _nthreads);
+    }
+  else
+    {
+      for (unsigned int icalo = 0; icalo < _chains.size(); ++icalo)
+	{
+	  _retcodes[icalo] = process_calorimeter(icalo);
+	}
+    }
+
+  // the most severe return code of all calorimeters
+  int iret = Fun4AllReturnCodes::EVENT_OK;
+  for (unsigned int icalo = 0; icalo < _retcodes.size(); ++icalo)
+    {
+      if (_retcodes[icalo] < 0)
+	{
+	  if (iret >= 0 || _retcodes[icalo] < iret)
+	    {
+	      iret = _retcodes[icalo];
+	    }
+	}
+      else if (iret >= 0 && _retcodes[icalo] > iret)
+	{
+	  iret = _retcodes[icalo];
+	}
+    }
+  return iret;
+}
+
+int
+RawTowerPipeline::process_calorimeter(const unsigned int icalo)
+{
+  for (unsigned int i = 0; i < _chains[icalo].size(); ++i)
+    {
+      int iret = _chains[icalo][i]->process_event(_topNode);
+      if (iret != Fun4AllReturnCodes::EVENT_OK)
+	{
+	  return iret;
+	}
+    }
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+void
+RawTowerPipeline::process_calorimeters_thread(void *arg)
+{
+  unsigned long int w = *((unsigned long int*) arg);
+  for (unsigned int icalo = w; icalo < _chains.size(); icalo += _nthreads)
+    {
+      _retcodes[icalo] = process_calorimeter(icalo);
+    }
+}
+
+int
+RawTowerPipeline::ResetEvent(PHCompositeNode *topNode)
+{
+  for (unsigned int icalo = 0; icalo < _chains.size(); ++icalo)
+    {
+      for (unsigned int i = 0; i < _chains[icalo].size(); ++i)
+	{
+	  _chains[icalo][i]->ResetEvent(topNode);
+	}
+    }
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+int
+RawTowerPipeline::EndRun(const int runnumber)
+{
+  for (unsigned int icalo = 0; icalo < _chains.size(); ++icalo)
+    {
+      for (unsigned int i = 0; i < _chains[icalo].size(); ++i)
+	{
+	  _chains[icalo][i]->EndRun(runnumber);
+	}
+    }
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+int
+RawTowerPipeline::End(PHCompositeNode *topNode)
+{
+  for (unsigned int icalo = 0; icalo < _chains.size(); ++icalo)
+    {
+      for (unsigned int i = 0; i < _chains[icalo].size(); ++i)
+	{
+	  _chains[icalo][i]->End(topNode);
+	}
+    }
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+void
+RawTowerPipeline::Print(const std::string &what) const
+{
+  cout << Name() << ": " << _chains.size() << " calorimeters with "
+       << _nthreads << " threads" << endl;
+  for (unsigned int icalo = 0; icalo < _chains.size(); ++icalo)
+    {
+      cout << "  " << _detectors[icalo] << ":";
+      for (unsigned int i = 0; i < _chains[icalo].size(); ++i)
+	{
+	  cout << " " << _chains[icalo][i]->Name();
+	}
+      cout << endl;
+    }
+}
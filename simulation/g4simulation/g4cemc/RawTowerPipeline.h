@@ -0,0 +1,74 @@
+#ifndef RawTowerPipeline_H__
+#define RawTowerPipeline_H__
+
+#include <fun4all/SubsysReco.h>
+
+#include <string>
+#include <vector>
+
+class PHCompositeNode;
+
+#ifndef __CINT__
+namespace SeamStress {
+  class Seamstress;
+  template <class TClass> class Pincushion;
+}
+#endif
+
+//! runs the tower modules (builder, digitizer, calibration, ...) of several
+//! calorimeters as one module. The modules of a calorimeter are run in the
+//! order they are added, the calorimeters of an event run concurrently with
+//! set_nthreads(n). The modules are owned by the pipeline and must not be
+//! registered to the Fun4AllServer. The calorimeters must not share output
+//! nodes, RawTowerDigitizer draws from per tower PHRandomService streams so the
+//! output does not depend on the number of threads.
+//!
+//! RawTowerPipeline *towers = new RawTowerPipeline();
+//! towers->AddModule("CEMC", cemc_builder);
+//! towers->AddModule("CEMC", cemc_digitizer);
+//! towers->AddModule("CEMC", cemc_calibration);
+//! towers->AddModule("HCALIN", ...);
+//! towers->set_nthreads(3);
+//! se->registerSubsystem(towers);
+class RawTowerPipeline : public SubsysReco
+{
+
+public:
+  RawTowerPipeline(const std::string& name = "RawTowerPipeline");
+  virtual ~RawTowerPipeline();
+
+  int Init(PHCompositeNode *topNode);
+  int InitRun(PHCompositeNode *topNode);
+  int process_event(PHCompositeNode *topNode);
+  int ResetEvent(PHCompositeNode *topNode);
+  int EndRun(const int runnumber);
+  int End(PHCompositeNode *topNode);
+  void Print(const std::string &what = "ALL") const;
+
+  //! appends module to the chain of this calorimeter
+  void AddModule(const std::string &detector, SubsysReco *module);
+
+  //! number of threads running the calorimeter chains, default 1 runs them in order
+  void set_nthreads(const unsigned int nthreads) {_nthreads = (nthreads > 0) ? nthreads : 1;}
+
+protected:
+  //! runs the chain of calorimeter icalo, returns the first return code which is not EVENT_OK
+  int process_calorimeter(const unsigned int icalo);
+
+  //! worker thread w runs calorimeters w, w + _nthreads, ...
+  void process_calorimeters_thread(void *arg);
+
+  std::vector<std::string> _detectors;
+  std::vector<std::vector<SubsysReco *> > _chains;
+  std::vector<int> _retcodes;
+
+  PHCompositeNode *_topNode;
+  unsigned int _nthreads;
+
+#ifndef __CINT__
+  std::vector<SeamStress::Seamstress*> *_seamstresses;
+  SeamStress::Pincushion<RawTowerPipeline> *_pins;
+#endif
+};
+
+#endif /* RawTowerPipeline_H__ */
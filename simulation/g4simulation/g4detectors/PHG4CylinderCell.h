@@ -7,6 +7,8 @@
 #include <cmath>
 #include <map>
 
+class PHG4CylinderCellContainer;
+
 class PHG4CylinderCell : public PHObject
 {
  public:
@@ -86,6 +88,9 @@ class PHG4CylinderCell : public PHObject
   virtual void set_module_index(const int i) {return;}
   virtual void set_chip_index(const int i) {return;}
   virtual void set_pixel_index(const int i) {return;}
+
+  //! cells which keep their contributions in the table of the container (PHG4CylinderCellv4)
+  virtual void set_contribution_table(PHG4CylinderCellContainer *container) {return;}
   
  protected:
 
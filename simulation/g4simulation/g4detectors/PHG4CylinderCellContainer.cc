@@ -1,14 +1,17 @@
 #include "PHG4CylinderCellContainer.h"
 #include "PHG4CylinderCellv1.h"
+#include "PHG4CylinderCellv4.h"
 #include "PHG4CylinderCellDefs.h"
 
+#include <algorithm>
 #include <cstdlib>
 
 using namespace std;
 
 ClassImp(PHG4CylinderCellContainer)
 
-PHG4CylinderCellContainer::PHG4CylinderCellContainer()
+PHG4CylinderCellContainer::PHG4CylinderCellContainer():
+  nstaged_cells(0)
 {
 }
 
@@ -20,6 +23,13 @@ PHG4CylinderCellContainer::Reset()
        delete cellmap.begin()->second;
        cellmap.erase(cellmap.begin());
      }
+   contrib_g4hits.clear();
+   contrib_edeps.clear();
+   contrib_showers.clear();
+   contrib_shower_edeps.clear();
+   staged_g4hits.clear();
+   staged_showers.clear();
+   nstaged_cells = 0;
   return;
 }
 
@@ -39,6 +49,11 @@ PHG4CylinderCellContainer::identify(ostream& os) const
      {
        os << "layer : " << *siter << endl;
      }
+   if (!contrib_g4hits.empty() || !contrib_showers.empty())
+     {
+       os << "Contribution table: " << contrib_g4hits.size() << " g4hit and "
+	  << contrib_showers.size() << " shower entries" << endl;
+     }
   return;
 }
 
@@ -103,12 +118,17 @@ PHG4CylinderCellContainer::getCylinderCells(const unsigned int detid) const
   ConstRange retpair;
   retpair.first = cellmap.lower_bound(keylow);
   retpair.second = cellmap.upper_bound(keyup);
+  link_cells(retpair);
   return retpair;
 }
 
 PHG4CylinderCellContainer::ConstRange 
 PHG4CylinderCellContainer::getCylinderCells( void ) const
-{ return std::make_pair( cellmap.begin(), cellmap.end() ); }
+{
+  ConstRange retpair = std::make_pair( cellmap.begin(), cellmap.end() );
+  link_cells(retpair);
+  return retpair;
+}
 
 
 PHG4CylinderCellContainer::Iterator 
@@ -133,6 +153,7 @@ PHG4CylinderCellContainer::findCylinderCell(PHG4CylinderCellDefs::keytype key)
 
   if(it != cellmap.end())
     {
+      it->second->set_contribution_table(this);
       return it->second;
     }
 
@@ -150,3 +171,126 @@ PHG4CylinderCellContainer::getTotalEdep() const
     }
   return totalenergy;
 }
+
+void
+PHG4CylinderCellContainer::link_cells(ConstRange range) const
+{
+  // the table is only read through the pointer, the cells are not part of the const state
+  PHG4CylinderCellContainer *self = const_cast<PHG4CylinderCellContainer *>(this);
+  for (ConstIterator iter = range.first; iter != range.second; ++iter)
+    {
+      iter->second->set_contribution_table(self);
+    }
+  return;
+}
+
+PHG4CylinderCell*
+PHG4CylinderCellContainer::NewPackedCell()
+{
+  PHG4CylinderCellv4 *cell = new PHG4CylinderCellv4();
+  cell->set_staged(this, nstaged_cells);
+  nstaged_cells++;
+  return cell;
+}
+
+void
+PHG4CylinderCellContainer::StageEdep(const int staged_index, const PHG4HitDefs::keytype g4hitid, const float edep)
+{
+  StagedEdep contrib;
+  contrib.cell = staged_index;
+  contrib.key = g4hitid;
+  contrib.edep = edep;
+  staged_g4hits.push_back(contrib);
+}
+
+void
+PHG4CylinderCellContainer::StageShowerEdep(const int staged_index, const int g4showerid, const float edep)
+{
+  StagedEdep contrib;
+  contrib.cell = staged_index;
+  contrib.key = g4showerid;
+  contrib.edep = edep;
+  staged_showers.push_back(contrib);
+}
+
+void
+PHG4CylinderCellContainer::PackContributions()
+{
+  if (nstaged_cells == 0)
+    {
+      return;
+    }
+  // staged cells which were added to the container, the contributions of
+  // cells which were deleted instead are dropped
+  vector<PHG4CylinderCellv4 *> staged_cells(nstaged_cells, NULL);
+  for (Iterator iter = cellmap.begin(); iter != cellmap.end(); ++iter)
+    {
+      PHG4CylinderCellv4 *cell = dynamic_cast<PHG4CylinderCellv4 *>(iter->second);
+      if (cell && cell->get_staged_index() >= 0)
+	{
+	  staged_cells[cell->get_staged_index()] = cell;
+	}
+    }
+  // first entry and number of entries in the table for every staged cell
+  vector<unsigned int> g4hit_first(nstaged_cells, contrib_g4hits.size());
+  vector<unsigned int> g4hit_n(nstaged_cells, 0);
+  vector<unsigned int> shower_first(nstaged_cells, contrib_showers.size());
+  vector<unsigned int> shower_n(nstaged_cells, 0);
+
+  sort(staged_g4hits.begin(), staged_g4hits.end());
+  for (vector<StagedEdep>::const_iterator iter = staged_g4hits.begin(); iter != staged_g4hits.end(); ++iter)
+    {
+      if (!staged_cells[iter->cell])
+	{
+	  continue;
+	}
+      if (g4hit_n[iter->cell] > 0 && contrib_g4hits.back() == iter->key)
+	{
+	  contrib_edeps.back() += iter->edep;
+	  continue;
+	}
+      if (g4hit_n[iter->cell] == 0)
+	{
+	  g4hit_first[iter->cell] = contrib_g4hits.size();
+	}
+      contrib_g4hits.push_back(iter->key);
+      contrib_edeps.push_back(iter->edep);
+      g4hit_n[iter->cell]++;
+    }
+
+  sort(staged_showers.begin(), staged_showers.end());
+  for (vector<StagedEdep>::const_iterator iter = staged_showers.begin(); iter != staged_showers.end(); ++iter)
+    {
+      if (!staged_cells[iter->cell])
+	{
+	  continue;
+	}
+      if (shower_n[iter->cell] > 0 && contrib_showers.back() == (int) iter->key)
+	{
+	  contrib_shower_edeps.back() += iter->edep;
+	  continue;
+	}
+      if (shower_n[iter->cell] == 0)
+	{
+	  shower_first[iter->cell] = contrib_showers.size();
+	}
+      contrib_showers.push_back(iter->key);
+      contrib_shower_edeps.push_back(iter->edep);
+      shower_n[iter->cell]++;
+    }
+
+  for (int i = 0; i < nstaged_cells; i++)
+    {
+      if (staged_cells[i])
+	{
+	  staged_cells[i]->set_g4hit_range(g4hit_first[i], g4hit_n[i]);
+	  staged_cells[i]->set_shower_range(shower_first[i], shower_n[i]);
+	  staged_cells[i]->set_staged(this, -1);
+	}
+    }
+
+  staged_g4hits.clear();
+  staged_showers.clear();
+  nstaged_cells = 0;
+  return;
+}
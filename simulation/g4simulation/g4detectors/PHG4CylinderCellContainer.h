@@ -7,6 +7,7 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 class PHG4CylinderCellContainer: public PHObject
 {
@@ -76,11 +77,58 @@ class PHG4CylinderCellContainer: public PHObject
 
   double getTotalEdep() const;
 
+  //! new PHG4CylinderCellv4 whose g4hit and shower contributions go to the
+  //! contribution table of this container. Its add_edep()/add_shower_edep()
+  //! are staged until PackContributions() is called after the cells are added
+  PHG4CylinderCell* NewPackedCell();
+  void StageEdep(const int staged_index, const PHG4HitDefs::keytype g4hitid, const float edep);
+  void StageShowerEdep(const int staged_index, const int g4showerid, const float edep);
+  //! sorts the staged contributions once, merges them per cell and g4hit
+  //! (or shower) and appends them to the table, the packed cells get their ranges
+  void PackContributions();
+
+  //! contribution table
+  unsigned int get_n_contributions() const
+  { return contrib_g4hits.size(); }
+  PHG4HitDefs::keytype get_contribution_g4hit(const unsigned int i) const
+  { return contrib_g4hits[i]; }
+  float get_contribution_edep(const unsigned int i) const
+  { return contrib_edeps[i]; }
+  unsigned int get_n_shower_contributions() const
+  { return contrib_showers.size(); }
+  int get_contribution_shower(const unsigned int i) const
+  { return contrib_showers[i]; }
+  float get_contribution_shower_edep(const unsigned int i) const
+  { return contrib_shower_edeps[i]; }
+
  protected:
+  //! cells read from file do not know the table of this container yet
+  void link_cells(ConstRange range) const;
+
   Map cellmap;
   std::set<int> layers; // layers is not reset since layers must not change event by event
 
-  ClassDef(PHG4CylinderCellContainer,1)
+  // contributions of the packed cells, entries of a cell are contiguous and sorted by key
+  std::vector<PHG4HitDefs::keytype> contrib_g4hits;
+  std::vector<float> contrib_edeps;
+  std::vector<int> contrib_showers;
+  std::vector<float> contrib_shower_edeps;
+
+#ifndef __CINT__
+  struct StagedEdep
+  {
+    int cell;
+    PHG4HitDefs::keytype key;
+    float edep;
+    bool operator<(const StagedEdep &rhs) const
+    { return (cell != rhs.cell) ? cell < rhs.cell : key < rhs.key; }
+  };
+  std::vector<StagedEdep> staged_g4hits; //!
+  std::vector<StagedEdep> staged_showers; //!
+  int nstaged_cells; //!
+#endif
+
+  ClassDef(PHG4CylinderCellContainer,2)
 };
 
 #endif
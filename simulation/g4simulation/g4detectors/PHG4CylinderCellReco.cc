@@ -3,7 +3,6 @@
 #include "PHG4CylinderGeom.h"
 #include "PHG4CylinderCellGeomContainer.h"
 #include "PHG4CylinderCellGeom.h"
-#include "PHG4CylinderCellv1.h"
 #include "PHG4CylinderCellContainer.h"
 #include "PHG4CylinderCellDefs.h"
 
@@ -474,7 +473,7 @@ PHG4CylinderCellReco::process_event(PHCompositeNode *topNode)
 		      if(verbosity > 1)
 			cout << "    did not find a previous entry for key = " << key << " add a new one" << endl;
 
-		      cellptmap[key] = new PHG4CylinderCellv1();
+		      cellptmap[key] = cells->NewPackedCell();
 		      it = cellptmap.find(key);
                       it->second->set_layer(*layer);
                       it->second->set_phibin(iphibin);
@@ -706,7 +705,7 @@ PHG4CylinderCellReco::process_event(PHCompositeNode *topNode)
 		      if(verbosity > 1)
 			cout << "    did not find a previous entry for key = " << key << " create a new one" << endl;
 
-		      cellptmap[key] = new PHG4CylinderCellv1();
+		      cellptmap[key] = cells->NewPackedCell();
 		      it = cellptmap.find(key);
 		      it->second->set_layer(*layer);
                       it->second->set_phibin(iphibin);
@@ -764,6 +763,8 @@ PHG4CylinderCellReco::process_event(PHCompositeNode *topNode)
       if(verbosity > 1)
 	cout << " reset it to " << cellptmap.size() << endl;
     }
+  // one sort of the g4hit contributions of all cells of this event
+  cells->PackContributions();
   if (chkenergyconservation)
     {
       CheckEnergy(topNode);
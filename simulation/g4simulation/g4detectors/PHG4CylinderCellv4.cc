@@ -0,0 +1,142 @@
+#include "PHG4CylinderCellv4.h"
+#include "PHG4CylinderCellContainer.h"
+#include "PHG4CylinderCellDefs.h"
+
+#include <phool/phool.h>
+
+using namespace std;
+
+ClassImp(PHG4CylinderCellv4)
+
+PHG4CylinderCellv4::PHG4CylinderCellv4():
+  layer(0xFFFFFFFF),
+  cellid(0xFFFFFFFF),
+  binz(-1),
+  binphi(-1),
+  edep(0),
+  light_yield(0),
+  first_g4hit(0),
+  n_g4hits(0),
+  first_shower(0),
+  n_showers(0),
+  table(NULL),
+  staged_index(-1),
+  views_filled(false),
+  g4hit_view(),
+  shower_view()
+{}
+
+void
+PHG4CylinderCellv4::add_edep(const PHG4HitDefs::keytype g4hitid, const float e)
+{
+  if (!table || staged_index < 0)
+    {
+      cout << PHWHERE << " cell " << cellid
+	   << " was not made by PHG4CylinderCellContainer::NewPackedCell() or is packed already, "
+	   << "g4hit " << g4hitid << " is not added" << endl;
+      return;
+    }
+  edep += e;
+  table->StageEdep(staged_index, g4hitid, e);
+}
+
+void
+PHG4CylinderCellv4::add_edep(const PHG4HitDefs::keytype g4hitid, const float e, const float ly)
+{
+  add_edep(g4hitid, e);
+  light_yield += ly;
+}
+
+void
+PHG4CylinderCellv4::add_shower_edep(const int g4showerid, const float e)
+{
+  if (!table || staged_index < 0)
+    {
+      cout << PHWHERE << " cell " << cellid
+	   << " was not made by PHG4CylinderCellContainer::NewPackedCell() or is packed already, "
+	   << "shower " << g4showerid << " is not added" << endl;
+      return;
+    }
+  table->StageShowerEdep(staged_index, g4showerid, e);
+}
+
+PHG4CylinderCell::EdepConstRange
+PHG4CylinderCellv4::get_g4hits()
+{
+  if (!views_filled && table)
+    {
+      for (unsigned int i = first_g4hit; i < first_g4hit + n_g4hits; i++)
+	{
+	  g4hit_view.insert(g4hit_view.end(), make_pair(table->get_contribution_g4hit(i), table->get_contribution_edep(i)));
+	}
+      for (unsigned int i = first_shower; i < first_shower + n_showers; i++)
+	{
+	  shower_view.insert(shower_view.end(), make_pair(table->get_contribution_shower(i), table->get_contribution_shower_edep(i)));
+	}
+      views_filled = true;
+    }
+  return make_pair(g4hit_view.begin(), g4hit_view.end());
+}
+
+PHG4CylinderCell::ShowerEdepConstRange
+PHG4CylinderCellv4::get_g4showers()
+{
+  get_g4hits();
+  return make_pair(shower_view.begin(), shower_view.end());
+}
+
+void
+PHG4CylinderCellv4::set_contribution_table(PHG4CylinderCellContainer *container)
+{
+  if (table != container)
+    {
+      table = container;
+      clear_views();
+    }
+}
+
+void
+PHG4CylinderCellv4::set_staged(PHG4CylinderCellContainer *container, const int index)
+{
+  set_contribution_table(container);
+  staged_index = index;
+}
+
+void
+PHG4CylinderCellv4::set_g4hit_range(const unsigned int first, const unsigned int n)
+{
+  first_g4hit = first;
+  n_g4hits = n;
+  clear_views();
+}
+
+void
+PHG4CylinderCellv4::set_shower_range(const unsigned int first, const unsigned int n)
+{
+  first_shower = first;
+  n_showers = n;
+  clear_views();
+}
+
+void
+PHG4CylinderCellv4::clear_views()
+{
+  g4hit_view.clear();
+  shower_view.clear();
+  views_filled = false;
+}
+
+void
+PHG4CylinderCellv4::identify(std::ostream& os) const
+{
+  os << "PHG4CylinderCellv4: #" << cellid << " ";
+  os << "(layer,binz,binphi,e) = (";
+  os << layer << ",";
+  os << binz << ",";
+  os << binphi << ",";
+  os << get_edep();
+  os << ")";
+  os << ", g4hits " << first_g4hit << "+" << n_g4hits;
+  os << ", showers " << first_shower << "+" << n_showers;
+  os << endl;
+}
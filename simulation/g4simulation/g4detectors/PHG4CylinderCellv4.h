@@ -0,0 +1,91 @@
+#ifndef PHG4CYLINDERCELLV4_H
+#define PHG4CYLINDERCELLV4_H
+
+#include "PHG4CylinderCell.h"
+#include <g4main/PHG4HitDefs.h>
+
+#include <cmath>
+#include <map>
+#include <iostream>
+
+class PHG4CylinderCellContainer;
+
+// Cell without its own g4hit and shower maps. The contributions are
+// kept in the contribution table of the PHG4CylinderCellContainer, the
+// cell only stores the range of its entries in this table. Cells are
+// made with PHG4CylinderCellContainer::NewPackedCell(), add_edep() and
+// add_shower_edep() are staged in the container until
+// PHG4CylinderCellContainer::PackContributions() is called.
+// get_g4hits() and get_g4showers() fill a transient map from the table
+// at the first call, so the evaluators can iterate them as before.
+
+class PHG4CylinderCellv4 : public PHG4CylinderCell
+{
+ public:
+
+  PHG4CylinderCellv4();
+  virtual ~PHG4CylinderCellv4(){}
+
+  void identify(std::ostream& os = std::cout) const;
+
+  EdepConstRange get_g4hits();
+  void add_edep(const PHG4HitDefs::keytype g4hitid, const float edep);
+  void add_edep(const PHG4HitDefs::keytype g4hitid, const float edep, const float light_yield);
+
+  ShowerEdepConstRange get_g4showers();
+  void add_shower_edep(const int g4showerid, const float edep);
+
+  void set_cell_id(const PHG4CylinderCellDefs::keytype id) {cellid = id;}
+  void set_layer(const unsigned int i) {layer = i;}
+  double get_edep() const {return edep;}
+  unsigned int get_layer() const {return layer;}
+  PHG4CylinderCellDefs::keytype get_cell_id() const {return cellid;}
+  int get_binz() const {return binz;}
+  int get_binphi() const {return binphi;}
+  int get_bineta() const {return get_binz();}
+  float  get_light_yield() const  {    return light_yield;  }
+
+  void set_zbin(const int i) {binz = i;}
+  void set_etabin(const int i) {set_zbin(i);}
+  void set_phibin(const int i) {binphi = i;}
+  void  set_light_yield(float lightYield)  {    light_yield = lightYield;  }
+
+  void set_contribution_table(PHG4CylinderCellContainer *container);
+
+  //! used by the container while the contributions of the event are staged and packed
+  void set_staged(PHG4CylinderCellContainer *container, const int index);
+  int get_staged_index() const {return staged_index;}
+  void set_g4hit_range(const unsigned int first, const unsigned int n);
+  void set_shower_range(const unsigned int first, const unsigned int n);
+  unsigned int get_first_g4hit() const {return first_g4hit;}
+  unsigned int get_n_g4hits() const {return n_g4hits;}
+  unsigned int get_first_shower() const {return first_shower;}
+  unsigned int get_n_showers() const {return n_showers;}
+
+ protected:
+
+  void clear_views();
+
+  unsigned int layer;
+  PHG4CylinderCellDefs::keytype cellid;
+  int binz;
+  int binphi;
+  float edep;
+  float light_yield;
+  unsigned int first_g4hit;
+  unsigned int n_g4hits;
+  unsigned int first_shower;
+  unsigned int n_showers;
+
+#ifndef __CINT__
+  PHG4CylinderCellContainer *table; //!
+  int staged_index; //! index in the staging of the container, -1 once packed
+  bool views_filled; //!
+  EdepMap g4hit_view; //!
+  ShowerEdepMap shower_view; //!
+#endif
+
+  ClassDef(PHG4CylinderCellv4,1)
+};
+
+#endif
@@ -0,0 +1,5 @@
+#ifdef __CINT__
+
+#pragma link C++ class PHG4CylinderCellv4+;
+
+#endif /* __CINT__ */
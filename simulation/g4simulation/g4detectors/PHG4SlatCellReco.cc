@@ -3,7 +3,6 @@
 #include "PHG4CylinderGeom.h"
 #include "PHG4CylinderCellGeomContainer.h"
 #include "PHG4CylinderCellGeom.h"
-#include "PHG4CylinderCellv1.h"
 #include "PHG4CylinderCellContainer.h"
 #include "PHG4CylinderCellDefs.h"
 
@@ -340,7 +339,7 @@ PHG4SlatCellReco::process_event(PHCompositeNode *topNode)
 		      intetabin = bins_fraction.back().get<1>();
 		      if (!cellptarray[slatbin][intetabin])
 			{
-			  cellptarray[slatbin][intetabin] = new PHG4CylinderCellv1();
+			  cellptarray[slatbin][intetabin] = cells->NewPackedCell();
 			  cellptarray[slatbin][intetabin]->set_layer(*layer);
 			  cellptarray[slatbin][intetabin]->set_phibin(slatbin);
 			  cellptarray[slatbin][intetabin]->set_etabin(intetabin);
@@ -353,7 +352,7 @@ PHG4SlatCellReco::process_event(PHCompositeNode *topNode)
 		{
 		  if (!cellptarray[slatbin][intetabin])
 		    {
-		      cellptarray[slatbin][intetabin] = new PHG4CylinderCellv1();
+		      cellptarray[slatbin][intetabin] = cells->NewPackedCell();
 		      cellptarray[slatbin][intetabin]->set_layer(*layer);
 		      cellptarray[slatbin][intetabin]->set_phibin(slatbin);
 		      cellptarray[slatbin][intetabin]->set_etabin(intetabin);
@@ -393,6 +392,8 @@ PHG4SlatCellReco::process_event(PHCompositeNode *topNode)
 
 
     }
+  // one sort of the g4hit contributions of all cells of this event
+  cells->PackContributions();
   if (chkenergyconservation)
     {
       CheckEnergy(topNode);
@@ -12,7 +12,8 @@
 #include <fun4all/SubsysReco.h>
 #include <phool/PHCompositeNode.h>
 
-#include <TNtuple.h>
+#include "EvalNtupleWriter.h"
+
 #include <TFile.h>
 
 #include <set>
@@ -75,6 +76,9 @@ class CaloEvaluator : public SubsysReco {
   void set_do_gshower_eval(bool b) {_do_gshower_eval = b;}
   void set_do_tower_eval(bool b) {_do_tower_eval = b;}
   void set_do_cluster_eval(bool b) {_do_cluster_eval = b;}
+
+  /// output format of the ntuples, see EvalNtupleWriter
+  void set_ntuple_layout(EvalNtupleWriter::Layout layout) {_ntuple_layout = layout;}
   
  private:
 
@@ -99,10 +103,11 @@ class CaloEvaluator : public SubsysReco {
   bool _do_tower_eval;
   bool _do_cluster_eval;
   
-  TNtuple *_ntp_gpoint;
-  TNtuple *_ntp_gshower;
-  TNtuple *_ntp_tower;
-  TNtuple *_ntp_cluster;
+  EvalNtupleWriter::Layout _ntuple_layout;
+  EvalNtupleWriter *_ntp_gpoint;
+  EvalNtupleWriter *_ntp_gshower;
+  EvalNtupleWriter *_ntp_tower;
+  EvalNtupleWriter *_ntp_cluster;
 
   // evaluator output file
   std::string _filename;
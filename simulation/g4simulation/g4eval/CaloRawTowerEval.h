@@ -3,6 +3,7 @@
 #define __CALORAWTOWEREVAL_H__
 
 #include "CaloTruthEval.h"
+#include "EvalAssocTable.h"
 
 #include <phool/PHCompositeNode.h>
 #include <g4cemc/RawTowerContainer.h>
@@ -18,6 +19,7 @@
 #include <string>
 #include <set>
 #include <map>
+#include <vector>
 
 class CaloRawTowerEval {
 
@@ -91,6 +93,10 @@ public:
   /// what towers did this primary truth particle contribute energy to?
   std::set<RawTower*> all_towers_from(PHG4Particle* primary);
 
+  /// what towers did these primary truth particles contribute energy to?
+  /// (entry i belongs to primaries[i])
+  std::vector<std::set<RawTower*> > all_towers_from(const std::vector<PHG4Particle*>& primaries);
+
   /// which tower did the primary truth particle contribute the most energy to?
   RawTower* best_tower_from(PHG4Particle* primary);
 
@@ -109,6 +115,9 @@ private:
 
   void get_node_pointers(PHCompositeNode *topNode);
 
+  /// associates all towers of the event with their primary showers in one pass
+  void fill_assoc_tables();
+
   std::string _caloname;
   CaloTruthEval _trutheval;  
   RawTowerContainer* _towers;
@@ -135,6 +144,9 @@ private:
   std::map<std::pair<RawTower*,PHG4Particle*>,float> _cache_get_energy_contribution_primary_particle;
   
   std::map<RawTower*,std::set<PHG4Hit*> >            _cache_all_truth_hits;
+
+  /// reverse table by primary shower id, filled on the first forwardtrace of an event
+  EvalAssocTable<int,RawTower*>                      _assoc_towers_from_primary_shower;
 };
 
 #endif // __SVTXHITEVAL_H__
@@ -0,0 +1,123 @@
+#ifndef __EVALASSOCTABLE_H__
+#define __EVALASSOCTABLE_H__
+
+//===============================================
+/// \file EvalAssocTable.h
+/// \brief Flat one-to-many lookup table for the eval stacks
+//===============================================
+
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
+/// \class EvalAssocTable
+///
+/// \brief Flat one-to-many lookup table for the eval stacks
+///
+/// The evals fill (key,value) pairs for a whole event with add() and
+/// call build() once. The values end up contiguous per key in a single
+/// arena vector, an open addressing hash over the integer keys points
+/// into it. clear() keeps the allocated memory for the next event.
+///
+template <class K, class V>
+class EvalAssocTable {
+
+ public:
+
+  typedef std::pair<const V*, const V*> Range;
+
+  EvalAssocTable() : _built(false), _mask(0) {}
+  virtual ~EvalAssocTable() {}
+
+  void clear() {
+    _pairs.clear();
+    _keys.clear();
+    _offsets.clear();
+    _arena.clear();
+    _slots.clear();
+    _mask = 0;
+    _built = false;
+  }
+
+  bool is_built() const {return _built;}
+
+  void add(const K &key, const V &value) {_pairs.push_back(std::make_pair(key,value));}
+
+  /// sort, remove duplicates and build the index
+  void build() {
+
+    std::sort(_pairs.begin(),_pairs.end());
+    _pairs.erase(std::unique(_pairs.begin(),_pairs.end()),_pairs.end());
+
+    for (unsigned int i = 0; i < _pairs.size(); ++i) {
+      if (_keys.empty() || !(_keys.back() == _pairs[i].first)) {
+	_keys.push_back(_pairs[i].first);
+	_offsets.push_back(_arena.size());
+      }
+      _arena.push_back(_pairs[i].second);
+    }
+    _offsets.push_back(_arena.size());
+    _pairs.clear();
+
+    // power of two with at most 50% load
+    unsigned int nslots = 16;
+    while (nslots < 2*_keys.size()) nslots *= 2;
+    _mask = nslots - 1;
+    _slots.assign(nslots,-1);
+    for (unsigned int i = 0; i < _keys.size(); ++i) {
+      unsigned int slot = hash(_keys[i]);
+      while (_slots[slot] >= 0) slot = (slot + 1) & _mask;
+      _slots[slot] = i;
+    }
+
+    _built = true;
+  }
+
+  /// values stored for key, empty range if there are none
+  Range get(const K &key) const {
+    if (_slots.empty()) return Range((const V*) 0,(const V*) 0);
+    unsigned int slot = hash(key);
+    while (_slots[slot] >= 0) {
+      int ikey = _slots[slot];
+      if (_keys[ikey] == key) {
+	return Range(&_arena[0] + _offsets[ikey],&_arena[0] + _offsets[ikey+1]);
+      }
+      slot = (slot + 1) & _mask;
+    }
+    return Range((const V*) 0,(const V*) 0);
+  }
+
+  /// add the values stored for key to the set
+  void get(const K &key, std::set<V> &values) const {
+    Range range = get(key);
+    values.insert(range.first,range.second);
+  }
+
+  /// bulk lookup, ranges[i] belongs to keys[i]
+  void get(const std::vector<K> &keys, std::vector<Range> &ranges) const {
+    ranges.resize(keys.size());
+    for (unsigned int i = 0; i < keys.size(); ++i) ranges[i] = get(keys[i]);
+  }
+
+  unsigned int size() const {return _arena.size();}
+  unsigned int nkeys() const {return _keys.size();}
+
+ private:
+
+  unsigned int hash(const K &key) const {
+    // fibonacci hashing of the integer key
+    unsigned long long h = (unsigned long long) key * 0x9E3779B97F4A7C15ULL;
+    return (unsigned int) (h >> 32) & _mask;
+  }
+
+  bool _built;
+  std::vector<std::pair<K,V> > _pairs;
+  std::vector<K> _keys;
+  std::vector<unsigned int> _offsets;
+  std::vector<V> _arena;
+  std::vector<int> _slots;
+  unsigned int _mask;
+};
+
+#endif // __EVALASSOCTABLE_H__
@@ -0,0 +1,91 @@
+#ifndef __EVALNTUPLEWRITER_H__
+#define __EVALNTUPLEWRITER_H__
+
+//===============================================
+/// \file EvalNtupleWriter.h
+/// \brief Buffered, typed output of the evaluator ntuples
+//===============================================
+
+#include <phool/PHTimer.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+class TNtuple;
+class TTree;
+
+/// \class EvalNtupleWriter
+///
+/// \brief Buffered, typed output of the evaluator ntuples
+///
+/// The evaluators fill rows the same way they fill a TNtuple, the
+/// rows of an event are kept in column buffers and written by
+/// FlushEvent(). The varlist follows the TNtuple syntax, a column
+/// can be declared as int with a /I suffix ("event/I:x:y:z").
+/// Non-finite values in int columns are written as INT_MIN.
+///
+/// Layouts:
+///  NTUPLE - a TNtuple, identical to the old output (default)
+///  ROWS   - a TTree with one typed branch per column, one entry per row
+///  EVENTS - a TTree with one entry per event, every column is an array
+///           of nrows entries so each branch is written as one block
+///
+class EvalNtupleWriter {
+
+ public:
+
+  enum Layout {NTUPLE = 0, ROWS = 1, EVENTS = 2};
+
+  /// the tree is created in the current directory
+  EvalNtupleWriter(const std::string &name,
+		   const std::string &title,
+		   const std::string &varlist,
+		   const Layout layout = NTUPLE);
+  virtual ~EvalNtupleWriter() {}
+
+  unsigned int get_ncolumns() const {return _names.size();}
+  /// column index, -1 if there is no such column
+  int get_column(const std::string &name) const;
+  Layout get_layout() const {return _layout;}
+
+  /// buffer one row, one value per column in varlist order
+  void Fill(const float *row);
+
+  /// write the rows buffered since the last call
+  void FlushEvent();
+
+  /// flush and write the tree to the current directory
+  int Write();
+
+  /// rows, events, fill time and bytes written
+  void PrintReport(std::ostream &os = std::cout) const;
+
+ private:
+
+  std::string _name;
+  Layout _layout;
+
+  TNtuple *_ntuple;
+  TTree *_tree;
+
+  std::vector<std::string> _names;
+  std::vector<bool> _isint;
+  // column -> index into _fcols or _icols
+  std::vector<unsigned int> _slot;
+
+  // rows of the current event, one buffer per column
+  std::vector<std::vector<float> > _fcols;
+  std::vector<std::vector<int> > _icols;
+  int _nrows;
+
+  // branch buffers of the ROWS layout, the NTUPLE row
+  std::vector<float> _frow;
+  std::vector<int> _irow;
+
+  unsigned long long _ntotrows;
+  unsigned long long _nevents;
+  PHTimer _timer;
+};
+
+#endif // __EVALNTUPLEWRITER_H__
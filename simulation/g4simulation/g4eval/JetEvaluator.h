@@ -12,7 +12,8 @@
 #include <fun4all/SubsysReco.h>
 #include <phool/PHCompositeNode.h>
 
-#include <TNtuple.h>
+#include "EvalNtupleWriter.h"
+
 #include <TFile.h>
 
 #include <string>
@@ -40,6 +41,9 @@ class JetEvaluator : public SubsysReco {
   int End(PHCompositeNode *topNode);
 
   void set_strict(bool b) {_strict = b;}
+
+  /// output format of the ntuples, see EvalNtupleWriter
+  void set_ntuple_layout(EvalNtupleWriter::Layout layout) {_ntuple_layout = layout;}
   
  private:
 
@@ -59,8 +63,9 @@ class JetEvaluator : public SubsysReco {
   bool _do_recojet_eval;
   bool _do_truthjet_eval;
   
-  TNtuple *_ntp_recojet;
-  TNtuple *_ntp_truthjet;
+  EvalNtupleWriter::Layout _ntuple_layout;
+  EvalNtupleWriter *_ntp_recojet;
+  EvalNtupleWriter *_ntp_truthjet;
 
   // evaluator output file
   std::string _filename;
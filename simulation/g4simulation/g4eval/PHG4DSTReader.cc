@@ -23,6 +23,7 @@
 
 #include <phool/getClass.h>
 
+#include <TFile.h>
 #include <TTree.h>
 #include <TMath.h>
 
@@ -37,11 +38,98 @@
 
 using namespace std;
 
+namespace
+{
+  //! fields of the columnar mode, the index is the field id of a column
+  struct field_def
+  {
+    const char * name;
+    char type;
+  };
+
+  enum
+  {
+    hit_x0, hit_y0, hit_z0, hit_x1, hit_y1, hit_z1, hit_t0, hit_t1, //
+    hit_edep, hit_eion, hit_light_yield, hit_trkid, hit_layer, hit_hit_id
+  };
+  const field_def hit_fields[] =
+    {
+      { "x0", 'F' },
+      { "y0", 'F' },
+      { "z0", 'F' },
+      { "x1", 'F' },
+      { "y1", 'F' },
+      { "z1", 'F' },
+      { "t0", 'F' },
+      { "t1", 'F' },
+      { "edep", 'F' },
+      { "eion", 'F' },
+      { "light_yield", 'F' },
+      { "trkid", 'I' },
+      { "layer", 'i' },
+      { "hit_id", 'l' } };
+
+  enum
+  {
+    tower_id, tower_bineta, tower_binphi, tower_energy
+  };
+  const field_def tower_fields[] =
+    {
+      { "id", 'i' },
+      { "bineta", 'I' },
+      { "binphi", 'I' },
+      { "energy", 'F' } };
+
+  enum
+  {
+    jet_id, jet_px, jet_py, jet_pz, jet_e, jet_ncomp
+  };
+  const field_def jet_fields[] =
+    {
+      { "id", 'i' },
+      { "px", 'F' },
+      { "py", 'F' },
+      { "pz", 'F' },
+      { "e", 'F' },
+      { "ncomp", 'i' } };
+
+  enum
+  {
+    part_track_id, part_vtx_id, part_parent_id, part_primary_id, part_pid, //
+    part_px, part_py, part_pz, part_e
+  };
+  const field_def part_fields[] =
+    {
+      { "track_id", 'I' },
+      { "vtx_id", 'I' },
+      { "parent_id", 'I' },
+      { "primary_id", 'I' },
+      { "pid", 'I' },
+      { "px", 'F' },
+      { "py", 'F' },
+      { "pz", 'F' },
+      { "e", 'F' } };
+
+  enum
+  {
+    vtx_id, vtx_x, vtx_y, vtx_z, vtx_t
+  };
+  const field_def vtx_fields[] =
+    {
+      { "id", 'I' },
+      { "x", 'F' },
+      { "y", 'F' },
+      { "z", 'F' },
+      { "t", 'F' } };
+}
+
 PHG4DSTReader::PHG4DSTReader(const string &filename) :
     SubsysReco("PHG4DSTReader"), nblocks(0), _event(0), //
     _out_file_name(filename), /*_file(NULL), */_T(NULL), //
     _save_particle(true), _load_all_particle(false), _load_active_particle(
-        true), _save_vertex(true), _tower_zero_sup(.0)
+        true), _save_vertex(true), _tower_zero_sup(.0), //
+    _columnar(false), _compression_algorithm(-1), _compression_level(-1), //
+    _timer("PHG4DSTReader")
 {
   // TODO Auto-generated constructor stub
 
@@ -200,6 +288,12 @@ PHG4DSTReader::build_tree()
   // open TFile
   PHTFileServer::get().open(_out_file_name, "RECREATE");
 
+  // the branches take the compression of the file when they are created
+  if (gFile && _compression_algorithm >= 0)
+    gFile->SetCompressionAlgorithm(_compression_algorithm);
+  if (gFile && _compression_level >= 0)
+    gFile->SetCompressionLevel(_compression_level);
+
   _T = new TTree("T", "PHG4DSTReader");
 
   nblocks = 0;
@@ -213,7 +307,23 @@ PHG4DSTReader::build_tree()
       const string name_cnt_desc = name_cnt + "/I";
       _T->Branch(name_cnt.c_str(), &(rec._cnt), name_cnt_desc.c_str(),
           BUFFER_SIZE);
-      _T->Branch(rec._name.c_str(), &(rec._arr_ptr), BUFFER_SIZE, 99);
+
+      if (_columnar)
+        {
+          build_columns(rec);
+
+          // the addresses are set per event before the fill
+          for (columns_t::iterator col = rec._columns.begin();
+              col != rec._columns.end(); ++col)
+            {
+              const string leaf = col->_branch + "[" + name_cnt + "]/"
+                  + col->_type;
+              _T->Branch(col->_branch.c_str(), col->address(), leaf.c_str(),
+                  BUFFER_SIZE);
+            }
+        }
+      else
+        _T->Branch(rec._name.c_str(), &(rec._arr_ptr), BUFFER_SIZE, 99);
 
       nblocks++;
     }
@@ -233,6 +343,8 @@ PHG4DSTReader::process_event(PHCompositeNode* topNode)
 //    cout << "PHG4DSTReader::process_event - " << _event << endl;
   _event++;
 
+  _timer.restart();
+
   //clean ups
   _particle_set.clear();
   _vertex_set.clear();
@@ -256,6 +368,9 @@ PHG4DSTReader::process_event(PHCompositeNode* topNode)
       assert(rec._arr.get() == rec._arr_ptr);
       assert(rec._arr.get());
       rec._arr->Clear();
+      for (columns_t::iterator col = rec._columns.begin();
+          col != rec._columns.end(); ++col)
+        col->clear();
 
       if (rec._type == record::typ_hit)
         {
@@ -291,11 +406,16 @@ PHG4DSTReader::process_event(PHCompositeNode* topNode)
 //
                   assert(hit);
 
-                  new ((*(rec._arr.get()))[rec._cnt]) hit_type(*hit);
+                  if (_columnar)
+                    fill_columns(rec, hit);
+                  else
+                    {
+                      new ((*(rec._arr.get()))[rec._cnt]) hit_type(*hit);
 
-                  hit_type * new_hit =
-                      dynamic_cast<hit_type *>(rec._arr.get()->At(rec._cnt));
-                  assert(new_hit);
+                      hit_type * new_hit =
+                          dynamic_cast<hit_type *>(rec._arr.get()->At(rec._cnt));
+                      assert(new_hit);
+                    }
 
 //                  for (int i = 0; i < 2; i++)
 //                    {
@@ -353,12 +473,9 @@ PHG4DSTReader::process_event(PHCompositeNode* topNode)
                 {
                   RawTower * hit_raw = hit_iter->second;
 
-                  RawTower_type * hit = dynamic_cast<RawTower_type *>(hit_raw);
-//                  RawTower * hit = hit_iter->second;
-
-                  assert(hit);
+                  assert(hit_raw);
 
-                  if (hit->get_energy() < _tower_zero_sup)
+                  if (hit_raw->get_energy() < _tower_zero_sup)
                     {
 
                       if (Verbosity() >= 2)
@@ -367,11 +484,23 @@ PHG4DSTReader::process_event(PHCompositeNode* topNode)
                             << rec._name << " @ ("
 //                            << hit->get_thetaMin()
 //                            << ", " << hit->get_phiMin()
-                            << "), Energy = " << hit->get_energy() << endl;
+                            << "), Energy = " << hit_raw->get_energy() << endl;
 
                       continue;
                     }
 
+                  if (_columnar)
+                    {
+                      fill_columns(rec, hit_raw);
+                      rec._cnt++;
+                      continue;
+                    }
+
+                  RawTower_type * hit = dynamic_cast<RawTower_type *>(hit_raw);
+//                  RawTower * hit = hit_iter->second;
+
+                  assert(hit);
+
                   new ((*(rec._arr.get()))[rec._cnt]) RawTower_type();
 
                   if (Verbosity() >= 2)
@@ -447,6 +576,13 @@ PHG4DSTReader::process_event(PHCompositeNode* topNode)
                         << hit_raw->get_phi() << "), pT = " << hit_raw->get_pt()
                         << " - with raw type " << hit_raw->ClassName() << endl;
 
+                  if (_columnar)
+                    {
+                      fill_columns(rec, hit_raw);
+                      rec._cnt++;
+                      continue;
+                    }
+
                   PHPyJet_type * hit = dynamic_cast<PHPyJet_type *>(hit_raw);
 
                   assert(hit);
@@ -559,6 +695,13 @@ PHG4DSTReader::process_event(PHCompositeNode* topNode)
                   continue;
                 }
 
+              if (_columnar)
+                {
+                  fill_columns(rec, v);
+                  rec._cnt++;
+                  continue;
+                }
+
               new ((*(rec._arr.get()))[rec._cnt]) vertex_type();
 
               if (Verbosity() >= 2)
@@ -583,7 +726,18 @@ PHG4DSTReader::process_event(PHCompositeNode* topNode)
     } //  for (records_t::iterator it = _records.begin(); it != _records.end(); ++it)
 
   if (_T)
-    _T->Fill();
+    {
+      // the column buffers may have moved while filling this event
+      for (records_t::iterator it = _records.begin(); it != _records.end();
+          ++it)
+        for (columns_t::iterator col = it->_columns.begin();
+            col != it->_columns.end(); ++col)
+          _T->SetBranchAddress(col->_branch.c_str(), col->address());
+
+      _T->Fill();
+    }
+
+  _timer.stop();
 
   return 0;
 } //  for (records_t::iterator it = _records.begin(); it != _records.end(); ++it)
@@ -594,6 +748,15 @@ PHG4DSTReader::add_particle(PHG4DSTReader::record & rec, PHG4Particle * part)
 
   assert(part);
 
+  _vertex_set.insert(part->get_vtx_id());
+
+  if (_columnar)
+    {
+      fill_columns(rec, part);
+      rec._cnt++;
+      return;
+    }
+
 //              if (Verbosity() >= 2)
 //                cout << "PHG4DSTReader::process_event - Particle type is "
 //                    << p_raw->GetName() << " - " << p_raw->ClassName()
@@ -619,11 +782,272 @@ PHG4DSTReader::add_particle(PHG4DSTReader::record & rec, PHG4Particle * part)
   new_part->set_pz(part->get_pz());
   new_part->set_e(part->get_e());
 
-  _vertex_set.insert(part->get_vtx_id());
-
   rec._cnt++;
 }
 
+void
+PHG4DSTReader::column::clear()
+{
+  _f.clear();
+  _i.clear();
+  _u.clear();
+  _l.clear();
+}
+
+void *
+PHG4DSTReader::column::address()
+{
+  // ROOT needs a valid address also for events without entries
+  switch (_type)
+    {
+  case 'F':
+    if (_f.empty())
+      _f.reserve(1);
+    return _f.data();
+  case 'I':
+    if (_i.empty())
+      _i.reserve(1);
+    return _i.data();
+  case 'i':
+    if (_u.empty())
+      _u.reserve(1);
+    return _u.data();
+  default:
+    if (_l.empty())
+      _l.reserve(1);
+    return _l.data();
+    }
+}
+
+void
+PHG4DSTReader::build_columns(PHG4DSTReader::record & rec)
+{
+  const field_def * fields = NULL;
+  unsigned int nfields = 0;
+  switch (rec._type)
+    {
+  case record::typ_hit:
+    fields = hit_fields;
+    nfields = sizeof(hit_fields) / sizeof(field_def);
+    break;
+  case record::typ_tower:
+    fields = tower_fields;
+    nfields = sizeof(tower_fields) / sizeof(field_def);
+    break;
+  case record::typ_jets:
+    fields = jet_fields;
+    nfields = sizeof(jet_fields) / sizeof(field_def);
+    break;
+  case record::typ_part:
+    fields = part_fields;
+    nfields = sizeof(part_fields) / sizeof(field_def);
+    break;
+  case record::typ_vertex:
+    fields = vtx_fields;
+    nfields = sizeof(vtx_fields) / sizeof(field_def);
+    break;
+    }
+
+  map<string, set<string> >::const_iterator selection = _selected_fields.find(
+      rec._name);
+
+  rec._columns.clear();
+  for (unsigned int i = 0; i < nfields; ++i)
+    {
+      if (selection != _selected_fields.end()
+          && selection->second.find(fields[i].name) == selection->second.end())
+        continue;
+
+      column col;
+      col._branch = rec._name + "_" + fields[i].name;
+      col._field = i;
+      col._type = fields[i].type;
+      rec._columns.push_back(col);
+    }
+
+  if (selection != _selected_fields.end())
+    for (set<string>::const_iterator it = selection->second.begin();
+        it != selection->second.end(); ++it)
+      {
+        bool found = false;
+        for (unsigned int i = 0; i < nfields; ++i)
+          if (*it == fields[i].name)
+            found = true;
+        if (!found)
+          cout << "PHG4DSTReader::build_columns - Error - " << rec._name
+              << " has no field " << *it << endl;
+      }
+
+  cout << "PHG4DSTReader::build_columns - " << rec._name << ": "
+      << rec._columns.size() << " of " << nfields << " fields" << endl;
+}
+
+void
+PHG4DSTReader::fill_columns(PHG4DSTReader::record & rec, const PHG4Hit * hit)
+{
+  for (columns_t::iterator col = rec._columns.begin();
+      col != rec._columns.end(); ++col)
+    switch (col->_field)
+      {
+    case hit_x0:
+      col->_f.push_back(hit->get_x(0));
+      break;
+    case hit_y0:
+      col->_f.push_back(hit->get_y(0));
+      break;
+    case hit_z0:
+      col->_f.push_back(hit->get_z(0));
+      break;
+    case hit_x1:
+      col->_f.push_back(hit->get_x(1));
+      break;
+    case hit_y1:
+      col->_f.push_back(hit->get_y(1));
+      break;
+    case hit_z1:
+      col->_f.push_back(hit->get_z(1));
+      break;
+    case hit_t0:
+      col->_f.push_back(hit->get_t(0));
+      break;
+    case hit_t1:
+      col->_f.push_back(hit->get_t(1));
+      break;
+    case hit_edep:
+      col->_f.push_back(hit->get_edep());
+      break;
+    case hit_eion:
+      col->_f.push_back(hit->get_eion());
+      break;
+    case hit_light_yield:
+      col->_f.push_back(hit->get_light_yield());
+      break;
+    case hit_trkid:
+      col->_i.push_back(hit->get_trkid());
+      break;
+    case hit_layer:
+      col->_u.push_back(hit->get_layer());
+      break;
+    case hit_hit_id:
+      col->_l.push_back(hit->get_hit_id());
+      break;
+      }
+}
+
+void
+PHG4DSTReader::fill_columns(PHG4DSTReader::record & rec, const RawTower * tower)
+{
+  for (columns_t::iterator col = rec._columns.begin();
+      col != rec._columns.end(); ++col)
+    switch (col->_field)
+      {
+    case tower_id:
+      col->_u.push_back(tower->get_id());
+      break;
+    case tower_bineta:
+      col->_i.push_back(tower->get_bineta());
+      break;
+    case tower_binphi:
+      col->_i.push_back(tower->get_binphi());
+      break;
+    case tower_energy:
+      col->_f.push_back(tower->get_energy());
+      break;
+      }
+}
+
+void
+PHG4DSTReader::fill_columns(PHG4DSTReader::record & rec, const Jet * jet)
+{
+  for (columns_t::iterator col = rec._columns.begin();
+      col != rec._columns.end(); ++col)
+    switch (col->_field)
+      {
+    case jet_id:
+      col->_u.push_back(jet->get_id());
+      break;
+    case jet_px:
+      col->_f.push_back(jet->get_px());
+      break;
+    case jet_py:
+      col->_f.push_back(jet->get_py());
+      break;
+    case jet_pz:
+      col->_f.push_back(jet->get_pz());
+      break;
+    case jet_e:
+      col->_f.push_back(jet->get_e());
+      break;
+    case jet_ncomp:
+      col->_u.push_back(jet->size_comp());
+      break;
+      }
+}
+
+void
+PHG4DSTReader::fill_columns(PHG4DSTReader::record & rec,
+    const PHG4Particle * part)
+{
+  for (columns_t::iterator col = rec._columns.begin();
+      col != rec._columns.end(); ++col)
+    switch (col->_field)
+      {
+    case part_track_id:
+      col->_i.push_back(part->get_track_id());
+      break;
+    case part_vtx_id:
+      col->_i.push_back(part->get_vtx_id());
+      break;
+    case part_parent_id:
+      col->_i.push_back(part->get_parent_id());
+      break;
+    case part_primary_id:
+      col->_i.push_back(part->get_primary_id());
+      break;
+    case part_pid:
+      col->_i.push_back(part->get_pid());
+      break;
+    case part_px:
+      col->_f.push_back(part->get_px());
+      break;
+    case part_py:
+      col->_f.push_back(part->get_py());
+      break;
+    case part_pz:
+      col->_f.push_back(part->get_pz());
+      break;
+    case part_e:
+      col->_f.push_back(part->get_e());
+      break;
+      }
+}
+
+void
+PHG4DSTReader::fill_columns(PHG4DSTReader::record & rec,
+    const PHG4VtxPoint * vtx)
+{
+  for (columns_t::iterator col = rec._columns.begin();
+      col != rec._columns.end(); ++col)
+    switch (col->_field)
+      {
+    case vtx_id:
+      col->_i.push_back(vtx->get_id());
+      break;
+    case vtx_x:
+      col->_f.push_back(vtx->get_x());
+      break;
+    case vtx_y:
+      col->_f.push_back(vtx->get_y());
+      break;
+    case vtx_z:
+      col->_f.push_back(vtx->get_z());
+      break;
+    case vtx_t:
+      col->_f.push_back(vtx->get_t());
+      break;
+      }
+}
+
 int
 PHG4DSTReader::End(PHCompositeNode * /*topNode*/)
 {
@@ -633,6 +1057,21 @@ PHG4DSTReader::End(PHCompositeNode * /*topNode*/)
     {
       PHTFileServer::get().cd(_out_file_name);
       _T->Write();
+
+      cout << "PHG4DSTReader::End - " << (_columnar ? "columnar" : "TClonesArray")
+          << " output: " << _T->GetEntries() << " events, "
+          << _T->GetTotBytes() << " bytes, " << _T->GetZipBytes()
+          << " bytes compressed";
+      if (_timer.get_ncycle() > 0)
+        {
+          cout << ", " << _timer.get_time_per_cycle() << " ms/event";
+          if (_timer.get_accumulated_time() > 0)
+            cout << " ("
+                << _T->GetZipBytes() / (_timer.get_accumulated_time() * 1e-3)
+                << " bytes/s)";
+        }
+      cout << endl;
+
       _T->ResetBranchAddresses();
     }
 
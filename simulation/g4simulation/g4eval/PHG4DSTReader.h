@@ -14,8 +14,11 @@
 #include <HepMC/GenEvent.h>
 #include <HepMC/SimpleVector.h>
 #include <fun4all/SubsysReco.h>
+#include <phool/PHTimer.h>
 #include <string>
 #include <iostream>
+#include <map>
+#include <set>
 #include <vector>
 #include <TClonesArray.h>
 #include <g4main/PHG4HitEval.h>
@@ -35,6 +38,12 @@ class TTree;
 
 /*!
  * \brief PHG4DSTReader save information from DST to an evaluator, which could include hit. particle, vertex, towers and jet (to be activated)
+ *
+ * By default every object is copied into a TClonesArray branch. With set_columnar(true)
+ * every field is written as its own typed branch instead, an array of n_<node> values per
+ * event filled directly from the containers (e.g. G4HIT_CEMC_edep[n_G4HIT_CEMC]/F).
+ * SelectField() restricts the columns of a node. The bytes written and the time spent
+ * are printed at End() for comparing the two modes.
  */
 class PHG4DSTReader : public SubsysReco
 {
@@ -122,6 +131,30 @@ public:
     _tower_zero_sup = b;
   }
 
+  //! write one typed branch per field instead of TClonesArray objects
+  void
+  set_columnar(bool b)
+  {
+    _columnar = b;
+  }
+
+  //! in the columnar mode only write these fields of a node, e.g. ("G4HIT_CEMC", "edep").
+  //! the node name is the branch name (G4HIT_*, TOWER_*, the jet node, PHG4Particle, PHG4VtxPoint),
+  //! all fields are written for nodes without a selection
+  void
+  SelectField(const std::string &node, const std::string &field)
+  {
+    _selected_fields[node].insert(field);
+  }
+
+  //! compression algorithm (ROOT::ECompressionAlgorithm) and level of the output file, -1 keeps the ROOT default
+  void
+  set_compression(int algorithm, int level)
+  {
+    _compression_algorithm = algorithm;
+    _compression_level = level;
+  }
+
 protected:
 
   std::vector<std::string> _node_postfix;
@@ -134,12 +167,33 @@ protected:
 
   typedef boost::shared_ptr<TClonesArray> arr_ptr;
 
+  //! one field of a record in the columnar mode, _type is the ROOT leaf type (F, I, i or l)
+  struct column
+  {
+    std::string _branch;
+    int _field;
+    char _type;
+    std::vector<float> _f;
+    std::vector<int> _i;
+    std::vector<unsigned int> _u;
+    std::vector<ULong64_t> _l;
+
+    void
+    clear();
+
+    //! address of the values, valid until the next push_back
+    void *
+    address();
+  };
+  typedef std::vector<column> columns_t;
+
   struct record
   {
     unsigned int _cnt;
     std::string _name;
     arr_ptr _arr;
     TClonesArray * _arr_ptr;
+    columns_t _columns;
 
     enum enu_type
     {
@@ -184,12 +238,37 @@ protected:
   //! zero suppression for all calorimeters
   double _tower_zero_sup;
 
+  //! flat typed columns instead of TClonesArray
+  bool _columnar;
+  std::map<std::string, std::set<std::string> > _selected_fields;
+  int _compression_algorithm;
+  int _compression_level;
+
+  //! time spent filling the tree, for the bytes per second at End()
+  PHTimer _timer;
+
 #ifndef __CINT__
 
   //! add a particle and associated vertex if _save_vertex
   void
   add_particle(record & rec, PHG4Particle * part);
 
+  //! columnar mode, append the fields of one object to the columns of rec
+  void
+  fill_columns(record & rec, const PHG4Hit * hit);
+  void
+  fill_columns(record & rec, const RawTower * tower);
+  void
+  fill_columns(record & rec, const Jet * jet);
+  void
+  fill_columns(record & rec, const PHG4Particle * part);
+  void
+  fill_columns(record & rec, const PHG4VtxPoint * vtx);
+
+  //! columns of a record type, restricted by SelectField()
+  void
+  build_columns(record & rec);
+
 #endif
 
   void
@@ -0,0 +1,83 @@
+#ifndef __PHG4DSTCOMPRESSREADBACK__
+#define __PHG4DSTCOMPRESSREADBACK__
+
+#include "PHG4DstPackDefs.h"
+
+#include <fun4all/SubsysReco.h>
+#include <fun4all/Fun4AllReturnCodes.h>
+
+#include <map>
+#include <set>
+#include <string>
+
+class PHObject;
+class PHG4HitContainer;
+class PHG4CylinderCellContainer;
+class RawTowerContainer;
+class VariableArray;
+class VariableArrayPacker;
+
+/// read back module for DSTs written with PHG4DstCompressReco::EncodeKept().
+/// The G4HIT_*, G4CELL_* and TOWER_* payloads are found in InitRun and the
+/// containers on the node tree are rebuilt at the start of every event, so
+/// modules running after it read them as usual:
+///
+///   se->registerSubsystem(new PHG4DstCompressReadBack());
+///
+/// With set_lazy(true) a container is only rebuilt the first time it is
+/// asked for through GetHits(), GetCells() or GetTowers(), nodes other
+/// modules take from the node tree then have to be listed with
+/// UnpackAtEvent(nodename)
+class PHG4DstCompressReadBack : public SubsysReco {
+
+public:
+
+  PHG4DstCompressReadBack(const std::string &name = "PHG4DstCompressReadBack");
+  virtual ~PHG4DstCompressReadBack();
+
+  //! run initialization, finds the payloads and their containers
+  int InitRun(PHCompositeNode *topNode);
+
+  //! event processing, only rebuilds the nodes not read lazily
+  int process_event(PHCompositeNode *topNode);
+
+  //! end of process, prints the decoding cost if verbose
+  int End(PHCompositeNode *topNode);
+
+  void Print(const std::string &what = "ALL") const;
+
+  //! the rebuilt container, NULL if the node was not encoded or its payload is bad
+  PHG4HitContainer *GetHits(const std::string &nodename);
+  PHG4CylinderCellContainer *GetCells(const std::string &nodename);
+  RawTowerContainer *GetTowers(const std::string &nodename);
+
+  //! rebuild this node in process_event
+  void UnpackAtEvent(const std::string &nodename) {_eager_names.insert(nodename);}
+
+  //! true rebuilds the nodes only when asked for, except the UnpackAtEvent() ones
+  void set_lazy(const bool b) {_lazy = b;}
+
+private:
+
+  struct EncodedContainer {
+    PHG4DstPackDefs::ContainerType type;
+    VariableArrayPacker *packer;
+    PHObject *container;
+    VariableArray *vararray;
+    bool decoded; // in this event
+  };
+
+  void SearchPayloadNodes(PHCompositeNode *top, PHCompositeNode *topNode);
+
+  //! rebuilds the container from its payload once per event
+  PHObject *Decode(const std::string &nodename, const PHG4DstPackDefs::ContainerType type);
+
+  bool _lazy;
+  std::set<std::string> _eager_names;
+  std::map<std::string, EncodedContainer> _encoded;
+
+  unsigned long long _npayloads;
+  unsigned long long _ndecoded;
+};
+
+#endif
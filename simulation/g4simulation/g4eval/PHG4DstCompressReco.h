@@ -1,6 +1,8 @@
 #ifndef __PHG4DSTCOMPRESSRECO__
 #define __PHG4DSTCOMPRESSRECO__
 
+#include "PHG4DstPackDefs.h"
+
 #include <fun4all/SubsysReco.h>
 #include <fun4all/Fun4AllReturnCodes.h>
 
@@ -9,15 +11,29 @@
 #include <g4detectors/PHG4CylinderCellContainer.h>
 #include <g4cemc/RawTowerContainer.h>
 
+#include <vararray/VariableArrayPacker.h>
+
+#include <map>
 #include <set>
 #include <string>
 
+class PHObject;
+class VariableArray;
+
+/// drops the g4hits and g4cells of the added containers, the truth not
+/// associated to the remaining g4hits and the cell entries of the added
+/// towers. With EncodeKept(true) the G4HIT_*, G4CELL_* and TOWER_* nodes
+/// which survive this are re-encoded into compact VariableArray payloads
+/// (sorted keys as differences, half float tower energies and times, all
+/// other values full floats) and emptied, PHG4DstCompressReadBack rebuilds
+/// them when reading the DST. G4CELL_* nodes are only encoded in events in which all
+/// their cells are PHG4CylinderCellv1 or v4, otherwise they are kept as is
 class PHG4DstCompressReco : public SubsysReco {
   
 public:
 
   PHG4DstCompressReco(const std::string &name = "PHG4DstCompressReco");
-  virtual ~PHG4DstCompressReco(){}
+  virtual ~PHG4DstCompressReco();
   
   //! module initialization
   int Init(PHCompositeNode *topNode){return 0;}
@@ -28,16 +44,50 @@ public:
   //! event processing
   int process_event(PHCompositeNode *topNode);
   
-  //! end of process
-  int End(PHCompositeNode *topNode) {return Fun4AllReturnCodes::EVENT_OK;}
+  //! end of process, prints the encoding report if verbose
+  int End(PHCompositeNode *topNode);
+
+  void Print(const std::string &what = "ALL") const;
   
   void AddHitContainer(const std::string name) {_compress_g4hit_names.insert(name);}
   void AddCellContainer(const std::string name) {_compress_g4cell_names.insert(name);}
   void AddTowerContainer(const std::string name) {_compress_tower_names.insert(name);}
 
+  //! re-encode the kept G4HIT_*, G4CELL_* and TOWER_* nodes of the DST
+  void EncodeKept(const bool b = true) {_encode = b;}
+
+  //! store the g4hit positions of all encoded nodes as fixed point with this
+  //! precision (cm), the range is +-32767 times this, values outside are
+  //! clamped and counted. 0 (default) keeps full floats: any precision with
+  //! a range covering the detector is coarser than the silicon pixels, so
+  //! set fixed point positions of calorimeter nodes with SetEncoding()
+  void SetPositionPrecision(const float precision) {_position_precision = precision;}
+
+  //! change the storage of one field of an encoded node,
+  //! e.g. SetEncoding("G4HIT_SVTX", "z0", VariableArrayPacker::FIXED16, 0.001)
+  void SetEncoding(const std::string &nodename, const std::string &field,
+		   const VariableArrayPacker::Encoding enc, const float precision = 0);
+
 private:
 
+  struct EncodedContainer {
+    PHG4DstPackDefs::ContainerType type;
+    VariableArrayPacker *packer;
+    PHObject *container;
+    VariableArray *vararray;
+  };
+
+  struct EncodingOverride {
+    std::string field;
+    VariableArrayPacker::Encoding encoding;
+    float precision;
+  };
+
   void SearchG4HitNodes(PHCompositeNode *topNode);
+  void SearchEncodedNodes(PHCompositeNode *topNode);
+  void AddEncodedContainer(const std::string &name, const PHG4DstPackDefs::ContainerType type,
+			   PHObject *container);
+  void EncodeNodes();
   
   PHG4TruthInfoContainer* _truth_info;
   std::set<std::string> _compress_g4hit_names;
@@ -49,6 +99,11 @@ private:
   std::set<PHG4HitContainer*> _keep_g4hits;
 
   std::set<RawTowerContainer*> _towers;
+
+  bool _encode;
+  float _position_precision;
+  std::multimap<std::string, EncodingOverride> _encoding_overrides;
+  std::map<std::string, EncodedContainer> _encoded;
 };
 
 #endif
@@ -0,0 +1,91 @@
+#ifndef __PHG4DSTPACKDEFS_H__
+#define __PHG4DSTPACKDEFS_H__
+
+#include <vararray/VariableArrayPacker.h>
+
+class PHG4HitContainer;
+class PHG4CylinderCellContainer;
+class RawTowerContainer;
+class SvtxHitMap;
+class SvtxClusterMap;
+
+// field layout of the packed G4HIT_*, G4CELL_*, TOWER_*, SvtxHitMap and
+// SvtxClusterMap payloads used by PHG4DstPackReco, PHG4DstUnpackReco,
+// PHG4DstCompressReco and PHG4DstCompressReadBack. The field order
+// is the contract between writer and reader, the encodings are stored
+// with the payload and can be changed per field at write time
+namespace PHG4DstPackDefs {
+
+  enum ContainerType {G4HIT = 0, TOWER = 1, SVTXHIT = 2, SVTXCLUSTER = 3, G4CELL = 4};
+
+  enum G4HitField {
+    g4hit_key_lo = 0, g4hit_key_hi, g4hit_trkid, g4hit_showerid,
+    g4hit_x0, g4hit_y0, g4hit_z0, g4hit_t0,
+    g4hit_x1, g4hit_y1, g4hit_z1, g4hit_t1,
+    g4hit_edep,
+    g4hit_nprop, g4hit_prop_id, g4hit_prop_val
+  };
+
+  enum TowerField {
+    tower_key = 0, tower_energy, tower_time,
+    tower_ncell, tower_cell_key, tower_cell_e,
+    tower_nshower, tower_shower_id, tower_shower_e
+  };
+
+  enum G4CellField {
+    g4cell_key = 0, g4cell_layer, g4cell_binz, g4cell_binphi, g4cell_light,
+    g4cell_nhit, g4cell_hit_key_lo, g4cell_hit_key_hi, g4cell_hit_e,
+    g4cell_nshower, g4cell_shower_id, g4cell_shower_e
+  };
+
+  enum SvtxHitField {
+    svtxhit_id = 0, svtxhit_layer, svtxhit_adc, svtxhit_e, svtxhit_cellid
+  };
+
+  enum SvtxClusterField {
+    svtxcluster_id = 0, svtxcluster_layer,
+    svtxcluster_x, svtxcluster_y, svtxcluster_z,
+    svtxcluster_e, svtxcluster_adc,
+    svtxcluster_size, // 6 entries per cluster, packed upper triangle
+    svtxcluster_err,  // 6 entries per cluster, packed upper triangle
+    svtxcluster_nhits, svtxcluster_hitid
+  };
+
+  /// add the fields of the given container type with their default encoding
+  void BuildSchema(const ContainerType type, VariableArrayPacker &packer);
+
+  /// switch to the compact storage: keys, ids and counts as differences to
+  /// the previous entry (the containers are sorted by key, so these are
+  /// mostly one short), positions as fixed point with the given precision
+  /// if it is above 0
+  void SetCompactEncoding(const ContainerType type, VariableArrayPacker &packer,
+			  const float position_precision);
+
+  /// VariableArray id of the payload
+  unsigned int VarArrayId(const ContainerType type);
+
+  /// name of the node holding the packed payload of a container node
+  std::string PackedNodeName(const std::string &nodename);
+
+  void Pack(const PHG4HitContainer *hits, VariableArrayPacker &packer);
+  void Pack(const RawTowerContainer *towers, VariableArrayPacker &packer);
+  void Pack(const PHG4CylinderCellContainer *cells, VariableArrayPacker &packer);
+  /// only PHG4CylinderCellv1 and v4 carry nothing beyond the G4CELL fields,
+  /// the ladder, sensor and stave bins of the other versions would be lost
+  bool Packable(const PHG4CylinderCellContainer *cells);
+  void Pack(const SvtxHitMap *hits, VariableArrayPacker &packer);
+  void Pack(const SvtxClusterMap *clusters, VariableArrayPacker &packer);
+
+  /// fill the (empty) container from the unpacked columns
+  void Unpack(const VariableArrayPacker &packer, PHG4HitContainer *hits);
+  void Unpack(const VariableArrayPacker &packer, RawTowerContainer *towers);
+  /// cells come back as PHG4CylinderCellv1 with layer, bins, light yield
+  /// and their g4hit and shower contributions
+  void Unpack(const VariableArrayPacker &packer, PHG4CylinderCellContainer *cells);
+  /// the hits and clusters keep their stored ids, returns -1 if one is
+  /// already taken in the container
+  int Unpack(const VariableArrayPacker &packer, SvtxHitMap *hits);
+  int Unpack(const VariableArrayPacker &packer, SvtxClusterMap *clusters);
+}
+
+#endif // __PHG4DSTPACKDEFS_H__
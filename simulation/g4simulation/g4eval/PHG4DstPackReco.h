@@ -0,0 +1,69 @@
+#ifndef __PHG4DSTPACKRECO__
+#define __PHG4DSTPACKRECO__
+
+#include "PHG4DstPackDefs.h"
+
+#include <fun4all/SubsysReco.h>
+#include <fun4all/Fun4AllReturnCodes.h>
+
+#include <vararray/VariableArrayPacker.h>
+
+#include <map>
+#include <string>
+
+class PHObject;
+class VariableArray;
+
+/// lossy storage mode for the DST: re-encodes the selected G4HIT_*, G4CELL_*, TOWER_*,
+/// SvtxHitMap and SvtxClusterMap nodes into VariableArray payloads with
+/// half, fixed point or full float fields and empties the original containers.
+/// Has to run after all modules that use these containers.
+/// PHG4DstUnpackReco restores them when reading the DST back.
+class PHG4DstPackReco : public SubsysReco {
+  
+public:
+
+  PHG4DstPackReco(const std::string &name = "PHG4DstPackReco");
+  virtual ~PHG4DstPackReco();
+  
+  //! run initialization
+  int InitRun(PHCompositeNode *topNode);
+  
+  //! event processing
+  int process_event(PHCompositeNode *topNode);
+  
+  //! end of process, prints the compression report if verbose
+  int End(PHCompositeNode *topNode);
+
+  void Print(const std::string &what = "ALL") const;
+  
+  void AddHitContainer(const std::string name) {AddContainer(name, PHG4DstPackDefs::G4HIT);}
+  void AddCellContainer(const std::string name) {AddContainer(name, PHG4DstPackDefs::G4CELL);}
+  void AddTowerContainer(const std::string name) {AddContainer(name, PHG4DstPackDefs::TOWER);}
+  void AddSvtxHitMap(const std::string name = "SvtxHitMap") {AddContainer(name, PHG4DstPackDefs::SVTXHIT);}
+  void AddSvtxClusterMap(const std::string name = "SvtxClusterMap") {AddContainer(name, PHG4DstPackDefs::SVTXCLUSTER);}
+
+  //! change the storage of one field of a container added before,
+  //! e.g. SetEncoding("G4HIT_SVTX", "z0", VariableArrayPacker::FIXED16, 0.01)
+  bool SetEncoding(const std::string &nodename, const std::string &field,
+		   const VariableArrayPacker::Encoding enc, const float precision = 0);
+
+  //! do not empty the original containers, for validation of the payloads
+  void KeepOriginal(const bool b) {_keep_original = b;}
+
+private:
+
+  struct PackedContainer {
+    PHG4DstPackDefs::ContainerType type;
+    VariableArrayPacker *packer;
+    PHObject *container;
+    VariableArray *vararray;
+  };
+
+  void AddContainer(const std::string &name, const PHG4DstPackDefs::ContainerType type);
+
+  bool _keep_original;
+  std::map<std::string, PackedContainer> _packed;
+};
+
+#endif
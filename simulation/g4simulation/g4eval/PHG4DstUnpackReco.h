@@ -0,0 +1,57 @@
+#ifndef __PHG4DSTUNPACKRECO__
+#define __PHG4DSTUNPACKRECO__
+
+#include "PHG4DstPackDefs.h"
+
+#include <fun4all/SubsysReco.h>
+#include <fun4all/Fun4AllReturnCodes.h>
+
+#include <map>
+#include <string>
+
+class PHObject;
+class VariableArray;
+class VariableArrayPacker;
+
+/// read back module for DSTs written with PHG4DstPackReco, refills the
+/// G4HIT_*, G4CELL_*, TOWER_*, SvtxHitMap and SvtxClusterMap containers from their
+/// VariableArray payloads at the start of the event
+class PHG4DstUnpackReco : public SubsysReco {
+  
+public:
+
+  PHG4DstUnpackReco(const std::string &name = "PHG4DstUnpackReco");
+  virtual ~PHG4DstUnpackReco();
+  
+  //! run initialization
+  int InitRun(PHCompositeNode *topNode);
+  
+  //! event processing
+  int process_event(PHCompositeNode *topNode);
+  
+  //! end of process, prints the decoding cost if verbose
+  int End(PHCompositeNode *topNode);
+
+  void Print(const std::string &what = "ALL") const;
+  
+  void AddHitContainer(const std::string name) {AddContainer(name, PHG4DstPackDefs::G4HIT);}
+  void AddCellContainer(const std::string name) {AddContainer(name, PHG4DstPackDefs::G4CELL);}
+  void AddTowerContainer(const std::string name) {AddContainer(name, PHG4DstPackDefs::TOWER);}
+  void AddSvtxHitMap(const std::string name = "SvtxHitMap") {AddContainer(name, PHG4DstPackDefs::SVTXHIT);}
+  void AddSvtxClusterMap(const std::string name = "SvtxClusterMap") {AddContainer(name, PHG4DstPackDefs::SVTXCLUSTER);}
+
+private:
+
+  struct PackedContainer {
+    PHG4DstPackDefs::ContainerType type;
+    VariableArrayPacker *packer;
+    PHObject *container;
+    VariableArray *vararray;
+  };
+
+  void AddContainer(const std::string &name, const PHG4DstPackDefs::ContainerType type);
+
+  std::map<std::string, PackedContainer> _packed;
+};
+
+#endif
@@ -4,17 +4,20 @@
 
 #include "SvtxHitEval.h"
 #include "SvtxTruthEval.h"
+#include "EvalAssocTable.h"
 
 #include <phool/PHCompositeNode.h>
 #include <g4hough/SvtxClusterMap.h>
 #include <g4hough/SvtxCluster.h>
 #include <g4hough/SvtxHitMap.h>
 #include <g4main/PHG4Hit.h>
+#include <g4main/PHG4HitDefs.h>
 #include <g4main/PHG4TruthInfoContainer.h>
 #include <g4main/PHG4Particle.h>
 
 #include <set>
 #include <map>
+#include <vector>
 
 class SvtxClusterEval {
 
@@ -53,6 +56,9 @@ public:
   std::set<SvtxCluster*> all_clusters_from(PHG4Particle* truthparticle);  
   std::set<SvtxCluster*> all_clusters_from(PHG4Hit* truthhit);
   SvtxCluster*           best_cluster_from(PHG4Hit* truthhit);
+
+  // bulk forwardtrace, entry i belongs to truthparticles[i]
+  std::vector<std::set<SvtxCluster*> > all_clusters_from(const std::vector<PHG4Particle*>& truthparticles);
   
   // overlap calculations
   float get_energy_contribution (SvtxCluster* svtxcluster, PHG4Particle* truthparticle);
@@ -64,6 +70,9 @@ private:
 
   void get_node_pointers(PHCompositeNode* topNode);
   bool has_node_pointers();
+
+  // associates all clusters of the event in one pass
+  void fill_assoc_tables();
   
   SvtxHitEval _hiteval;
   SvtxClusterMap* _clustermap;
@@ -84,6 +93,10 @@ private:
   std::map<PHG4Hit*,SvtxCluster* >                      _cache_best_cluster_from_g4hit;
   std::map<std::pair<SvtxCluster*,PHG4Particle*>,float> _cache_get_energy_contribution_g4particle;
   std::map<std::pair<SvtxCluster*,PHG4Hit*>,float>      _cache_get_energy_contribution_g4hit;
+
+  // reverse tables, filled on the first forwardtrace of an event
+  EvalAssocTable<int,SvtxCluster*>                      _assoc_clusters_from_particle; // by track id
+  EvalAssocTable<PHG4HitDefs::keytype,SvtxCluster*>     _assoc_clusters_from_g4hit;    // by g4hit id
 };
 
 #endif // __SVTXCLUSTEREVAL_H__
@@ -14,10 +14,21 @@
 #include <fun4all/Fun4AllReturnCodes.h>
 #include <phool/PHCompositeNode.h>
 
-#include <TNtuple.h>
+#include "EvalNtupleWriter.h"
+
+#include <phool/PHTimer.h>
+
 #include <TFile.h>
 
 #include <string>
+#include <vector>
+
+#ifndef __CINT__
+namespace SeamStress {
+  class Seamstress;
+  template <class TClass> class Pincushion;
+}
+#endif
 
 /// \class SvtxEvaluator
 ///
@@ -33,7 +44,7 @@ public:
  
   SvtxEvaluator(const std::string &name = "SVTXEVALUATOR",
                 const std::string &filename = "g4eval.root");
-  virtual ~SvtxEvaluator() {}
+  virtual ~SvtxEvaluator();
 		
   int Init(PHCompositeNode *topNode);
   int InitRun(PHCompositeNode *topNode);
@@ -51,9 +62,19 @@ public:
   void do_track_eval(bool b) {_do_track_eval = b;}
 
   void scan_for_embedded(bool b) {_scan_for_embedded = b;}
+
+  /// output format of the ntuples, see EvalNtupleWriter
+  void set_ntuple_layout(EvalNtupleWriter::Layout layout) {_ntuple_layout = layout;}
+
+  /// number of threads filling the stages (vertex+gpoint, g4hit, hit,
+  /// cluster, gtrack, track) of an event concurrently, every stage
+  /// has its own eval stack and ntuples
+  void set_nthreads(unsigned int nthreads) {_nthreads = (nthreads > 0) ? nthreads : 1;}
   
  private:
 
+  enum Stage {VERTEX = 0, G4HIT = 1, HIT = 2, CLUSTER = 3, GTRACK = 4, TRACK = 5, NSTAGES = 6};
+
   unsigned int _ievent;
 
   // eval stack
@@ -75,20 +96,41 @@ public:
 
   bool _scan_for_embedded;
   
-  TNtuple *_ntp_vertex;
-  TNtuple *_ntp_gpoint;
-  TNtuple *_ntp_g4hit;
-  TNtuple *_ntp_hit;
-  TNtuple *_ntp_cluster;
-  TNtuple *_ntp_gtrack;
-  TNtuple *_ntp_track;
+  EvalNtupleWriter::Layout _ntuple_layout;
+  EvalNtupleWriter *_ntp_vertex;
+  EvalNtupleWriter *_ntp_gpoint;
+  EvalNtupleWriter *_ntp_g4hit;
+  EvalNtupleWriter *_ntp_hit;
+  EvalNtupleWriter *_ntp_cluster;
+  EvalNtupleWriter *_ntp_gtrack;
+  EvalNtupleWriter *_ntp_track;
 
   // evaluator output file
   std::string _filename;
   TFile *_tfile;
 
+  // stages of the ntuple filling
+  unsigned int _nthreads;
+  std::vector<unsigned int> _active_stages;
+  std::vector<SvtxEvalStack*> _stage_evalstacks;
+  std::vector<PHTimer> _stage_timers;
+  PHCompositeNode *_topnode;
+
+#ifndef __CINT__
+  std::vector<SeamStress::Seamstress*> *_seamstresses;
+  SeamStress::Pincushion<SvtxEvaluator> *_pins;
+#endif
+
   // output subroutines
   void fillOutputNtuples(PHCompositeNode* topNode); ///< dump the evaluator information into ntuple for external analysis
+  void fillStagesThread(void *arg);                 ///< worker thread w fills the stages w, w + _nthreads, ...
+  void fillStage(PHCompositeNode* topNode, unsigned int stage, SvtxEvalStack* evalstack);
+  void fillVertexNtuples(PHCompositeNode* topNode, SvtxEvalStack* evalstack);
+  void fillG4hitNtuple(PHCompositeNode* topNode, SvtxEvalStack* evalstack);
+  void fillHitNtuple(PHCompositeNode* topNode, SvtxEvalStack* evalstack);
+  void fillClusterNtuple(PHCompositeNode* topNode, SvtxEvalStack* evalstack);
+  void fillGtrackNtuple(PHCompositeNode* topNode, SvtxEvalStack* evalstack);
+  void fillTrackNtuple(PHCompositeNode* topNode, SvtxEvalStack* evalstack);
   void printInputInfo(PHCompositeNode* topNode);    ///< print out the input object information (debugging upstream components)
   void printOutputInfo(PHCompositeNode* topNode);   ///< print out the ancestry information for detailed diagnosis
 };
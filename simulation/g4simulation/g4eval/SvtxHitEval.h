@@ -3,6 +3,7 @@
 #define __SVTXHITEVAL_H__
 
 #include "SvtxTruthEval.h"
+#include "EvalAssocTable.h"
 
 #include <phool/PHCompositeNode.h>
 #include <g4hough/SvtxHitMap.h>
@@ -11,11 +12,13 @@
 #include <g4detectors/PHG4CylinderCell.h>
 #include <g4main/PHG4HitContainer.h>
 #include <g4main/PHG4Hit.h>
+#include <g4main/PHG4HitDefs.h>
 #include <g4main/PHG4TruthInfoContainer.h>
 #include <g4main/PHG4Particle.h>
 
 #include <set>
 #include <map>
+#include <vector>
 
 class SvtxHitEval {
 
@@ -55,6 +58,9 @@ public:
   std::set<SvtxHit*> all_hits_from(PHG4Particle* truthparticle);
   std::set<SvtxHit*> all_hits_from(PHG4Hit* truthhit);
   SvtxHit*           best_hit_from(PHG4Hit* truthhit);
+
+  // bulk forwardtrace, entry i belongs to truthparticles[i]
+  std::vector<std::set<SvtxHit*> > all_hits_from(const std::vector<PHG4Particle*>& truthparticles);
   
   // overlap calculations
   float get_energy_contribution (SvtxHit* svtxhit, PHG4Particle* truthparticle);
@@ -67,6 +73,9 @@ private:
   void get_node_pointers(PHCompositeNode *topNode);
   bool has_node_pointers();
 
+  // associates all hits of the event in one pass
+  void fill_assoc_tables();
+
   SvtxTruthEval _trutheval;
   SvtxHitMap* _hitmap;
   PHG4CylinderCellContainer* _g4cells_svtx;
@@ -91,6 +100,10 @@ private:
   std::map<PHG4Hit*,SvtxHit*>                       _cache_best_hit_from_g4hit;
   std::map<std::pair<SvtxHit*,PHG4Particle*>,float> _cache_get_energy_contribution_g4particle;
   std::map<std::pair<SvtxHit*,PHG4Hit*>,float>      _cache_get_energy_contribution_g4hit;
+
+  // reverse tables, filled on the first forwardtrace of an event
+  EvalAssocTable<int,SvtxHit*>                      _assoc_hits_from_particle; // by track id
+  EvalAssocTable<PHG4HitDefs::keytype,SvtxHit*>     _assoc_hits_from_g4hit;    // by g4hit id
 };
 
 #endif // __SVTXHITEVAL_H__
@@ -5,6 +5,7 @@
 #include "SvtxClusterEval.h"
 #include "SvtxHitEval.h"
 #include "SvtxTruthEval.h"
+#include "EvalAssocTable.h"
 
 #include <phool/PHCompositeNode.h>
 #include <g4hough/SvtxTrackMap.h>
@@ -15,6 +16,7 @@
 
 #include <set>
 #include <map>
+#include <vector>
 
 class SvtxTrackEval {
 
@@ -55,6 +57,9 @@ public:
   std::set<SvtxTrack*> all_tracks_from(PHG4Hit* truthhit);
   std::set<SvtxTrack*> all_tracks_from(SvtxCluster* cluster);
   SvtxTrack*           best_track_from(SvtxCluster* cluster);
+
+  // bulk forwardtrace, entry i belongs to truthparticles[i]
+  std::vector<std::set<SvtxTrack*> > all_tracks_from(const std::vector<PHG4Particle*>& truthparticles);
   
   // overlap calculations
   unsigned int get_nclusters_contribution(SvtxTrack* svtxtrack, PHG4Particle* truthparticle);  
@@ -66,6 +71,9 @@ private:
 
   void get_node_pointers(PHCompositeNode* topNode);
   bool has_node_pointers();
+
+  // associates all tracks of the event in one pass
+  void fill_assoc_tables();
   
   SvtxClusterEval _clustereval;
   SvtxTrackMap* _trackmap;
@@ -86,6 +94,11 @@ private:
   std::map<SvtxCluster*,SvtxTrack*>                           _cache_best_track_from_cluster;
   std::map<std::pair<SvtxTrack*,PHG4Particle*>, unsigned int> _cache_get_nclusters_contribution;
   std::map<std::pair<SvtxTrack*,PHG4Particle*>, unsigned int> _cache_get_nclusters_contribution_by_layer;
+
+  // reverse tables, filled on the first forwardtrace of an event
+  EvalAssocTable<int,SvtxTrack*>                              _assoc_tracks_from_particle; // by track id of the cluster particles
+  EvalAssocTable<int,SvtxTrack*>                              _assoc_tracks_from_g4hit;    // by track id of the cluster g4hits
+  EvalAssocTable<unsigned int,SvtxTrack*>                     _assoc_tracks_from_cluster;  // by cluster id
 };
 
 #endif // __SVTXTRACKEVAL_H__
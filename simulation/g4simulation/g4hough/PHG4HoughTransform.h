@@ -108,6 +108,17 @@ public:
   /// get early curvature cut between hits, lower values are more open
   double get_cos_angle_cut() const {return _cos_angle_cut;}
 
+  /// seed the final track finding with the cellular automaton on the
+  /// layered hit graph instead of the Hough zooming
+  void set_use_ca_seeding(bool b) {_use_ca_seeding = b;}
+  bool get_use_ca_seeding() const {return _use_ca_seeding;}
+
+  /// number of phi sectors the cellular automaton is split into
+  void set_ca_nsectors(unsigned int n) {_ca_nsectors = n;}
+
+  /// worker threads of the cellular automaton seeding, 1 runs serially
+  void set_nthreads(unsigned int n) {_nthreads = n;}
+
   void set_min_pT(float pt) {_min_pt = pt;}
   
   /// set the z0 search window
@@ -288,6 +299,10 @@ private:
   double _chi2_cut_full;            ///< fit quality chisq/dof for kalman track fitting
   double _ca_chi2_cut;              ///< initial combination cut?
   double _cos_angle_cut;            ///< curvature restriction on cluster combos
+
+  bool _use_ca_seeding;             ///< cellular automaton instead of Hough seeds
+  unsigned int _ca_nsectors;        ///< phi sectors of the cellular automaton
+  unsigned int _nthreads;           ///< worker threads of the ca seeding
   
   float _bin_scale;
   float _z_bin_scale;
@@ -322,6 +337,7 @@ private:
   SvtxTrackMap* _g4tracks;
   SvtxVertexMap* _g4vertexes;
 
+  PHTimeServer::timer _timer;         ///< final track finding time
 #endif // __CINT__
 };
 
@@ -4,11 +4,6 @@
 #include <fun4all/SubsysReco.h>
 #include <phool/PHTimeServer.h>
 
-// rootcint barfs with this header so we need to hide it
-#ifndef __CINT__
-#include <gsl/gsl_rng.h>
-#endif
-
 #include <map>
 
 class SvtxHitMap;
@@ -55,10 +50,6 @@ public:
 
   PHTimeServer::timer _timer;   ///< Timer
 
-#ifndef __CINT__
-  gsl_rng *RandomGenerator;
-#endif
-
 };
 
 #endif
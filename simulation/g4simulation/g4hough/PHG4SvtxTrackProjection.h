@@ -20,6 +20,8 @@
 
 // forward declarations
 class PHCompositeNode;
+class RawTower;
+class RawTowerGeomContainer;
 
 /// \class PHG4SvtxTrackProjection
 ///
@@ -43,6 +45,11 @@ class PHG4SvtxTrackProjection : public SubsysReco
   
  private:
 
+  //! tower bin of the projection, binary search in the cached bin bounds
+  //! when the bins are ordered, the geometry container otherwise or in gaps
+  int find_etabin(const int ilayer, const double eta) const;
+  int find_phibin(const int ilayer, const double phi) const;
+
   PHG4HoughTransform _hough;
   int _num_cal_layers;
   std::vector<SvtxTrack::CAL_LAYER> _cal_types;
@@ -50,6 +57,35 @@ class PHG4SvtxTrackProjection : public SubsysReco
   std::vector<float> _cal_radii;
   double _magfield;
   double _mag_extent;
+
+#ifndef __CINT__
+  // tower geometry of each layer, cached per run
+  std::vector<RawTowerGeomContainer*> _cal_geos;
+  std::vector<bool> _cal_ordered_bins;
+  std::vector<std::vector<double> > _cal_eta_lo;
+  std::vector<std::vector<double> > _cal_eta_hi;
+  std::vector<std::vector<double> > _cal_phi_lo;
+  std::vector<std::vector<double> > _cal_phi_hi;
+
+  //! cluster position for the nearest cluster search
+  struct ClusterPoint {
+    double eta;
+    double phi;
+    double e;
+    unsigned int id;
+    bool operator<(const ClusterPoint &other) const {return eta < other.eta;}
+  };
+
+  // per event work arrays, reused between events
+  std::vector<SvtxTrack*> _tracks;
+  std::vector<double> _proj_eta;
+  std::vector<double> _proj_phi;
+  std::vector<char> _proj_ok;
+  //! towers of one layer indexed by ieta * nphibins + iphi
+  std::vector<RawTower*> _tower_grid;
+  //! clusters of one layer sorted by eta
+  std::vector<ClusterPoint> _cluster_points;
+#endif
 };
 
 #endif // __PHG4SVTXTRACKPROJECTION_H__
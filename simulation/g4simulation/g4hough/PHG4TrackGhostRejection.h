@@ -14,12 +14,19 @@
 
 // standard includes
 #include <vector>
-#include <map>
+#include <utility>
 
 // forward declarations
 class PHCompositeNode;
 class SvtxTrackMap;
 
+#ifndef __CINT__
+namespace SeamStress {
+  class Seamstress;
+  template <class TClass> class Pincushion;
+}
+#endif
+
 class PHG4TrackCandidate
 {
   
@@ -39,9 +46,14 @@ class PHG4TrackCandidate
 ///
 /// This module runs after the pattern recognition to remove
 /// track candidates with a user defined overlap. The steps are:
-/// (1) Sort the hits on each track by index
-/// (2) Fill a multi-map between a track and all of the overlapping tracks
-/// (3) Keep only the best track from the set of overlapping tracks
+/// (1) Sort the (hit, track) pairs of all tracks by hit, an inverted index
+/// (2) Count the shared hits of the track pairs found in the same hit,
+///     tracks which do not share a hit are never compared
+/// (3) Join the tracks with more than the allowed shared hits in groups
+///     (union-find), the groups do not depend on each other
+/// (4) In every group drop each track which loses against one of its
+///     overlapping tracks (fewer hits, or worse chisq/dof for equal hits),
+///     the groups are run on set_nthreads(n) threads
 ///
 class PHG4TrackGhostRejection : public SubsysReco
 {
@@ -49,7 +61,7 @@ class PHG4TrackGhostRejection : public SubsysReco
  public:
  
   PHG4TrackGhostRejection(const int nlayers, const std::string &name = "PHG4TrackGhostRejection");
-  virtual ~PHG4TrackGhostRejection() {}
+  virtual ~PHG4TrackGhostRejection();
 		
   int Init(PHCompositeNode *topNode);
   int InitRun(PHCompositeNode *topNode);
@@ -62,8 +74,21 @@ class PHG4TrackGhostRejection : public SubsysReco
   void set_layer_enabled(const int layer, const bool enabled) {_layer_enabled[layer] = enabled;}
   bool get_layer_enabled(const int layer) const {return _layer_enabled[layer];}
 
+  //! number of threads resolving the overlap groups, default 1 runs them in order
+  void set_nthreads(const unsigned int nthreads) {_nthreads = (nthreads > 0) ? nthreads : 1;}
+  unsigned int get_nthreads() const {return _nthreads;}
+
  private:
 
+  //! union-find root of candidate i, with path halving
+  unsigned int find_group(unsigned int i);
+
+  //! flags the losers of the overlapping pairs in group g
+  void resolve_group(const unsigned int g);
+
+  //! worker thread w resolves groups w, w + _nthreads, ...
+  void resolve_groups_thread(void *arg);
+
   SvtxTrackMap *_g4tracks;
   std::vector< PHG4TrackCandidate > _candidates;
 
@@ -71,7 +96,21 @@ class PHG4TrackGhostRejection : public SubsysReco
   unsigned int _max_shared_hits;
   std::vector<bool> _layer_enabled;
 
-  std::multimap< unsigned int, unsigned int > _overlapping;
+  //! (hit id, candidate index), sorted by hit id
+  std::vector< std::pair<unsigned int, unsigned int> > _hit_index;
+  //! candidate pairs (i << 32 | j, i < j) sharing a hit, once per shared hit
+  std::vector< unsigned long long > _shared_pairs;
+  //! union-find parents of the candidates
+  std::vector< unsigned int > _group_parent;
+  //! overlapping pairs ordered by group, group g is [_group_begin[g], _group_begin[g+1])
+  std::vector< std::pair<unsigned int, std::pair<unsigned int, unsigned int> > > _overlapping;
+  std::vector< unsigned int > _group_begin;
+
+  unsigned int _nthreads;
+#ifndef __CINT__
+  std::vector<SeamStress::Seamstress*> *_seamstresses;
+  SeamStress::Pincushion<PHG4TrackGhostRejection> *_pins;
+#endif
 
 };
 
@@ -51,6 +51,9 @@ public:
 	 */
 	enum OutPutMode {MakeNewNode, OverwriteOriginalNode, DebugMode};
 
+	//! material effects in the propagation: TGeo navigation, precomputed map, or both to compare them
+	enum MaterialMode {TGeoMaterial, MaterialMap, ValidateMaterialMap};
+
 	enum DetectorType {MIE, MAPS_TPC, MAPS_IT_TPC, LADDER_MAPS_TPC, LADDER_MAPS_IT_TPC, LADDER_MAPS_LADDER_IT_TPC, MAPS_LADDER_IT_TPC};
 
 	//! Default constructor
@@ -208,6 +211,32 @@ public:
 		_cut_min_pT = cutMinPT;
 	}
 
+	MaterialMode get_material_mode() const {
+		return _material_mode;
+	}
+
+	/*!
+	 * MaterialMap fits with the (r,z) material map built from the geometry at InitRun.
+	 * ValidateMaterialMap fits every track with the map and with TGeo, keeps the TGeo
+	 * result and prints the differences and the fit times at End.
+	 */
+	void set_material_mode(MaterialMode materialMode) {
+		_material_mode = materialMode;
+	}
+
+	//! material map extent in cm, default r < 90, |z| < 110
+	void set_material_map_range(double r_max, double z_max) {
+		_material_map_r_max = r_max;
+		_material_map_z_max = z_max;
+	}
+
+	//! material map cell size in cm and number of rays in phi, default 0.01 x 5, 72 rays
+	void set_material_map_binning(double dr, double dz, unsigned int nphi) {
+		_material_map_dr = dr;
+		_material_map_dz = dz;
+		_material_map_nphi = nphi;
+	}
+
 private:
 
 	//! Event counter
@@ -220,11 +249,30 @@ private:
 	int CreateNodes(PHCompositeNode *);
 
 	/*
-	 * fit track with SvtxTrack as input seed.
+	 * Make the track to fit with SvtxTrack as input seed, not fitted yet.
 	 * \param intrack Input SvtxTrack
 	 * \param invertex Input Vertex, if fit track as a primary vertex
 	 */
-	PHGenFit::Track* ReFitTrack(PHCompositeNode *, const SvtxTrack* intrack, const SvtxVertex* invertex = NULL);
+	PHGenFit::Track* MakeGenFitTrack(PHCompositeNode *, const SvtxTrack* intrack, const SvtxVertex* invertex = NULL);
+
+	/*
+	 * Fit the tracks and time every fit.
+	 * Tracks failing the fit are deleted and set to NULL, the order is kept.
+	 */
+	void FitTracks(std::vector<PHGenFit::Track*>& tracks);
+
+	//! fit track, false if the fit failed
+	bool FitTrack(PHGenFit::Track* track, double& fit_time);
+
+	/*
+	 * Fit map_tracks with the material map and tracks with TGeo, compare them at the beam line.
+	 * map_tracks are deleted, tracks are left as after FitTracks.
+	 */
+	void FitTracksValidateMaterialMap(std::vector<PHGenFit::Track*>& map_tracks,
+			std::vector<PHGenFit::Track*>& tracks);
+
+	//! state at the POCA to the beam line, false if the extrapolation failed
+	bool GetBeamLineState(const PHGenFit::Track* track, TVector3& pos, TVector3& mom) const;
 
 	//! Make SvtxTrack from PHGenFit::Track and SvtxTrack
 	SvtxTrack* MakeSvtxTrack(const SvtxTrack* svtxtrack, const PHGenFit::Track* genfit_track, const SvtxVertex * vertex = NULL);
@@ -338,6 +386,33 @@ private:
 
 	bool _do_evt_display;
 
+	//! fit time in ms of every track of the last FitTracks call
+	std::vector<double> _fit_times;
+
+	//! fit timing summary
+	unsigned long _n_fits;
+	unsigned long _n_failed_fits;
+	double _fit_time_sum;
+	double _fit_time_max;
+
+	MaterialMode _material_mode;
+	double _material_map_r_max;
+	double _material_map_z_max;
+	double _material_map_dr;
+	double _material_map_dz;
+	unsigned int _material_map_nphi;
+
+	//! material map validation summary, fit times in ms, position in cm
+	unsigned long _n_validated;
+	unsigned long _n_validation_mismatch;
+	double _validation_time_map;
+	double _validation_time_tgeo;
+	double _validation_dp_sum;
+	double _validation_dp_max;
+	double _validation_dpos_sum;
+	double _validation_dpos_max;
+	double _validation_dchi2ndf_sum;
+
 };
 
 #endif //* __PHG4TrackKalmanFitter_H__ *//
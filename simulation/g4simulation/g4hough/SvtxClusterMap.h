@@ -32,6 +32,9 @@ public:
   virtual const SvtxCluster* get(unsigned int idkey) const {return NULL;}
   virtual       SvtxCluster* get(unsigned int idkey) {return NULL;}
   virtual       SvtxCluster* insert(const SvtxCluster *cluster) {return NULL;}
+  virtual       SvtxCluster* insert_new() {return NULL;}
+  //! copy of cluster which keeps the given id (e.g. when read back), NULL if the id is taken
+  virtual       SvtxCluster* insert_with_id(const SvtxCluster *cluster, unsigned int idkey) {return NULL;}
   virtual       size_t       erase(unsigned int idkey) {return 0;}
 
   virtual ConstIter begin()                   const {return ClusterMap().end();}
@@ -30,6 +30,8 @@ public:
   const SvtxCluster* get(unsigned int idkey) const;
         SvtxCluster* get(unsigned int idkey); 
         SvtxCluster* insert(const SvtxCluster* cluster);
+        SvtxCluster* insert_new();
+        SvtxCluster* insert_with_id(const SvtxCluster *cluster, unsigned int idkey);
         size_t       erase(unsigned int idkey) {
 	  delete _map[idkey]; return _map.erase(idkey);
 	}
@@ -0,0 +1,76 @@
+#ifndef __SVTXCLUSTERMAP_V2_H__
+#define __SVTXCLUSTERMAP_V2_H__
+
+#include "SvtxClusterMap.h"
+#include "SvtxCluster.h"
+#include "SvtxCluster_v1.h"
+
+#ifndef __CINT__
+#include "SvtxPooledStorage.h"
+#endif
+
+#include <phool/PHObject.h>
+#include <map>
+#include <iostream>
+
+/// \class SvtxClusterMap_v2
+///
+/// Same content and iteration as SvtxClusterMap_v1, but the clusters made with
+/// insert_new() (or copied by insert() from a SvtxCluster_v1) live in an
+/// object pool which is recycled by Reset() instead of being deleted,
+/// and get() is a lookup in a vector indexed by the cluster id.
+/// The pool and the index are in SvtxPooledStorage, shared with the
+/// other v2 containers.
+///
+class SvtxClusterMap_v2 : public SvtxClusterMap {
+
+public:
+
+  SvtxClusterMap_v2();
+  SvtxClusterMap_v2(const SvtxClusterMap_v2& clustermap);
+  SvtxClusterMap_v2& operator=(const SvtxClusterMap_v2& clustermap);
+  virtual ~SvtxClusterMap_v2();
+
+  void identify(std::ostream& os = std::cout) const;
+  void Reset();
+  int  isValid() const {return 1;}
+  SvtxClusterMap* Clone() const {return new SvtxClusterMap_v2(*this);}
+
+  bool   empty()                   const {return _map.empty();}
+  size_t  size()                   const {return _map.size();}
+  size_t count(unsigned int idkey) const {return (get(idkey)) ? 1 : 0;}
+  void   clear()                         {Reset();}
+
+  const SvtxCluster* get(unsigned int idkey) const;
+        SvtxCluster* get(unsigned int idkey);
+        SvtxCluster* insert(const SvtxCluster *cluster);
+        SvtxCluster* insert_new();
+        SvtxCluster* insert_with_id(const SvtxCluster *cluster, unsigned int idkey);
+        size_t       erase(unsigned int idkey);
+
+  ConstIter begin()                   const {return _map.begin();}
+  ConstIter  find(unsigned int idkey) const {return _map.find(idkey);}
+  ConstIter   end()                   const {return _map.end();}
+
+  Iter begin()                   {return _map.begin();}
+  Iter  find(unsigned int idkey) {return _map.find(idkey);}
+  Iter   end()                   {return _map.end();}
+
+  // allocation counters
+  size_t        get_pool_capacity() const;
+  unsigned long get_n_pool_requested() const;
+  unsigned long get_n_pool_reused() const;
+  unsigned long get_n_heap_allocated() const;
+
+private:
+
+  ClusterMap _map;
+
+#ifndef __CINT__
+  SvtxPooledStorage<SvtxCluster,SvtxCluster_v1> _storage; //!
+#endif
+
+  ClassDef(SvtxClusterMap_v2, 1);
+};
+
+#endif
@@ -32,6 +32,9 @@ public:
   virtual const SvtxHit* get(unsigned int idkey) const {return NULL;}
   virtual       SvtxHit* get(unsigned int idkey) {return NULL;}
   virtual       SvtxHit* insert(const SvtxHit *hit) {return NULL;}
+  virtual       SvtxHit* insert_new() {return NULL;}
+  //! copy of hit which keeps the given id (e.g. when read back), NULL if the id is taken
+  virtual       SvtxHit* insert_with_id(const SvtxHit *hit, unsigned int idkey) {return NULL;}
   virtual       size_t   erase(unsigned int idkey) {return 0;}
 
   virtual ConstIter begin()                   const {return HitMap().end();}
@@ -30,6 +30,8 @@ public:
   const SvtxHit* get(unsigned int idkey) const;
         SvtxHit* get(unsigned int idkey); 
         SvtxHit* insert(const SvtxHit *hit);
+        SvtxHit* insert_new();
+        SvtxHit* insert_with_id(const SvtxHit *hit, unsigned int idkey);
         size_t   erase(unsigned int idkey) {
 	  delete _map[idkey]; return _map.erase(idkey);
 	}
@@ -0,0 +1,76 @@
+#ifndef __SVTXHITMAP_V2_H__
+#define __SVTXHITMAP_V2_H__
+
+#include "SvtxHitMap.h"
+#include "SvtxHit.h"
+#include "SvtxHit_v1.h"
+
+#ifndef __CINT__
+#include "SvtxPooledStorage.h"
+#endif
+
+#include <phool/PHObject.h>
+#include <map>
+#include <iostream>
+
+/// \class SvtxHitMap_v2
+///
+/// Same content and iteration as SvtxHitMap_v1, but the hits made with
+/// insert_new() (or copied by insert() from a SvtxHit_v1) live in an
+/// object pool which is recycled by Reset() instead of being deleted,
+/// and get() is a lookup in a vector indexed by the hit id.
+/// The pool and the index are in SvtxPooledStorage, shared with the
+/// other v2 containers.
+///
+class SvtxHitMap_v2 : public SvtxHitMap {
+
+public:
+
+  SvtxHitMap_v2();
+  SvtxHitMap_v2(const SvtxHitMap_v2& hitmap);
+  SvtxHitMap_v2& operator=(const SvtxHitMap_v2& hitmap);
+  virtual ~SvtxHitMap_v2();
+
+  void identify(std::ostream& os = std::cout) const;
+  void Reset();
+  int  isValid() const {return 1;}
+  SvtxHitMap* Clone() const {return new SvtxHitMap_v2(*this);}
+
+  bool   empty()                   const {return _map.empty();}
+  size_t  size()                   const {return _map.size();}
+  size_t count(unsigned int idkey) const {return (get(idkey)) ? 1 : 0;}
+  void   clear()                         {Reset();}
+
+  const SvtxHit* get(unsigned int idkey) const;
+        SvtxHit* get(unsigned int idkey);
+        SvtxHit* insert(const SvtxHit *hit);
+        SvtxHit* insert_new();
+        SvtxHit* insert_with_id(const SvtxHit *hit, unsigned int idkey);
+        size_t   erase(unsigned int idkey);
+
+  ConstIter begin()                   const {return _map.begin();}
+  ConstIter  find(unsigned int idkey) const {return _map.find(idkey);}
+  ConstIter   end()                   const {return _map.end();}
+
+  Iter begin()                   {return _map.begin();}
+  Iter  find(unsigned int idkey) {return _map.find(idkey);}
+  Iter   end()                   {return _map.end();}
+
+  // allocation counters
+  size_t        get_pool_capacity() const;
+  unsigned long get_n_pool_requested() const;
+  unsigned long get_n_pool_reused() const;
+  unsigned long get_n_heap_allocated() const;
+
+private:
+
+  HitMap _map;
+
+#ifndef __CINT__
+  SvtxPooledStorage<SvtxHit,SvtxHit_v1> _storage; //!
+#endif
+
+  ClassDef(SvtxHitMap_v2, 1);
+};
+
+#endif
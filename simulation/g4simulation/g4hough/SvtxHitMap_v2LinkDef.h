@@ -0,0 +1,5 @@
+#ifdef __CINT__
+
+#pragma link C++ class SvtxHitMap_v2+;
+
+#endif /* __CINT__ */
@@ -0,0 +1,107 @@
+#ifndef __SVTXOBJECTPOOL_H__
+#define __SVTXOBJECTPOOL_H__
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+/// \class SvtxObjectPool
+///
+/// Slab allocator for the objects owned by the Svtx containers. The
+/// objects are constructed in slabs of doubling size which are kept for
+/// the whole job, clear() hands all of them out again in the next event
+/// without any delete or new. An object which was used before is Reset()
+/// when it is handed out again.
+///
+template <class T>
+class SvtxObjectPool {
+
+public:
+
+  SvtxObjectPool(size_t first_slab_size = 1024)
+    : _slabs(),
+      _slab_sizes(),
+      _first_slab_size(first_slab_size > 0 ? first_slab_size : 1),
+      _slab(0),
+      _pos(0),
+      _used(0),
+      _high_water(0),
+      _capacity(0),
+      _nrequested(0),
+      _nreused(0) {
+  }
+
+  ~SvtxObjectPool() {
+    for (unsigned int i = 0; i < _slabs.size(); ++i) delete [] _slabs[i];
+  }
+
+  T* get() {
+    while (_slab < _slabs.size() && _pos >= _slab_sizes[_slab]) {
+      ++_slab;
+      _pos = 0;
+    }
+    if (_slab == _slabs.size()) {
+      size_t n = (_slabs.empty()) ? _first_slab_size : 2 * _slab_sizes.back();
+      _slabs.push_back(new T[n]);
+      _slab_sizes.push_back(n);
+      _capacity += n;
+      _pos = 0;
+    }
+
+    T* obj = &_slabs[_slab][_pos];
+    ++_pos;
+    if (_used < _high_water) {
+      obj->Reset();
+      ++_nreused;
+    }
+    ++_used;
+    if (_used > _high_water) _high_water = _used;
+    ++_nrequested;
+
+    return obj;
+  }
+
+  /// all objects are available again, nothing is deleted
+  void clear() {
+    _slab = 0;
+    _pos = 0;
+    _used = 0;
+  }
+
+  /// obj is the address of the complete object, e.g. from dynamic_cast<const void*>
+  bool owns(const void* obj) const {
+    std::less<const void*> less;
+    for (unsigned int i = 0; i < _slabs.size(); ++i) {
+      const void* first = _slabs[i];
+      const void* last = _slabs[i] + _slab_sizes[i];
+      if (!less(obj,first) && less(obj,last)) return true;
+    }
+    return false;
+  }
+
+  size_t        size()            const {return _used;}
+  size_t        capacity()        const {return _capacity;}
+  size_t        get_n_slabs()     const {return _slabs.size();}
+  unsigned long get_n_requested() const {return _nrequested;}
+  unsigned long get_n_reused()    const {return _nreused;}
+
+private:
+
+  SvtxObjectPool(const SvtxObjectPool&);
+  SvtxObjectPool& operator=(const SvtxObjectPool&);
+
+  std::vector<T*> _slabs;
+  std::vector<size_t> _slab_sizes;
+  size_t _first_slab_size;
+
+  size_t _slab;       //< slab of the next object
+  size_t _pos;        //< position of the next object in its slab
+  size_t _used;       //< objects handed out since clear()
+  size_t _high_water; //< objects which were used at least once
+  size_t _capacity;
+
+  unsigned long _nrequested;
+  unsigned long _nreused;
+};
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef __SVTXPOOLEDSTORAGE_H__
+#define __SVTXPOOLEDSTORAGE_H__
+
+#include "SvtxObjectPool.h"
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+/// \class SvtxPooledStorage
+///
+/// Container logic shared by SvtxHitMap_v2, SvtxClusterMap_v2 and
+/// SvtxTrackMap_v2. The id map stays a member of the containers since it
+/// is what goes to the DST, this class holds the transient part: the pool
+/// of TV1 objects, the index by id used by get() and the allocation
+/// counters. All methods work on the map of the owning container.
+///
+template <class T, class TV1>
+class SvtxPooledStorage {
+
+public:
+
+  typedef std::map<unsigned int, T*> Map;
+
+  SvtxPooledStorage()
+    : _index(),
+      _nindexed(0),
+      _pool(),
+      _nheap(0) {
+  }
+
+  /// clones the objects of other into map
+  void copy(Map &map, const Map &other) {
+    for (typename Map::const_iterator iter = other.begin();
+	 iter != other.end();
+	 ++iter) {
+      const T *obj = iter->second;
+      map.insert(map.end(),std::make_pair(obj->get_id(),obj->Clone()));
+      ++_nheap;
+    }
+  }
+
+  void reset(Map &map) {
+    // objects read from a file or cloned are on the heap, the others go back to the pool
+    bool pooled = (_pool.size() > 0);
+    for (typename Map::iterator iter = map.begin();
+	 iter != map.end();
+	 ++iter) {
+      T *obj = iter->second;
+      if (!pooled || !_pool.owns(dynamic_cast<void*>(obj))) delete obj;
+    }
+    map.clear();
+    _index.clear();
+    _nindexed = 0;
+    _pool.clear();
+  }
+
+  T* get(const Map &map, unsigned int id) const {
+    if (_nindexed == map.size()) {
+      if (id >= _index.size()) return NULL;
+      return _index[id];
+    }
+    typename Map::const_iterator iter = map.find(id);
+    if (iter == map.end()) return NULL;
+    return iter->second;
+  }
+
+  /// copy of obj with the next free id
+  T* insert(Map &map, const T *obj) {
+    return add(map,copy_of(obj),next_id(map));
+  }
+
+  /// copy of obj which keeps id, NULL if the id is taken
+  T* insert_with_id(Map &map, const T *obj, unsigned int id) {
+    if (map.find(id) != map.end()) return NULL;
+    return add(map,copy_of(obj),id);
+  }
+
+  T* insert_new(Map &map) {
+    return add(map,_pool.get(),next_id(map));
+  }
+
+  size_t erase(Map &map, unsigned int idkey) {
+    typename Map::iterator iter = map.find(idkey);
+    if (iter == map.end()) return 0;
+
+    T *obj = iter->second;
+    if (idkey < _index.size() && _index[idkey] == obj) {
+      _index[idkey] = NULL;
+      --_nindexed;
+    }
+    // pooled objects are recycled at the next Reset()
+    if (!_pool.owns(dynamic_cast<void*>(obj))) delete obj;
+    map.erase(iter);
+    return 1;
+  }
+
+  // allocation counters
+  size_t        get_pool_capacity()    const {return _pool.capacity();}
+  size_t        get_n_pool_slabs()     const {return _pool.get_n_slabs();}
+  unsigned long get_n_pool_requested() const {return _pool.get_n_requested();}
+  unsigned long get_n_pool_reused()    const {return _pool.get_n_reused();}
+  unsigned long get_n_heap_allocated() const {return _nheap;}
+
+private:
+
+  SvtxPooledStorage(const SvtxPooledStorage&);
+  SvtxPooledStorage& operator=(const SvtxPooledStorage&);
+
+  static unsigned int next_id(const Map &map) {
+    return (map.empty()) ? 0 : map.rbegin()->first + 1;
+  }
+
+  /// TV1 objects are copied into the pool, other versions cloned on the heap
+  T* copy_of(const T *obj) {
+    const TV1 *obj_v1 = dynamic_cast<const TV1*>(obj);
+    if (obj_v1) {
+      TV1 *copy = _pool.get();
+      *copy = *obj_v1;
+      return copy;
+    }
+    ++_nheap;
+    return obj->Clone();
+  }
+
+  T* add(Map &map, T *obj, unsigned int id) {
+    // objects of a container read from file are not in the index yet
+    if (_nindexed != map.size()) rebuild_index(map);
+
+    obj->set_id(id);
+    map.insert(map.end(),std::make_pair(id,obj));
+
+    if (id >= _index.size()) _index.resize(id + 1,NULL);
+    _index[id] = obj;
+    ++_nindexed;
+
+    return obj;
+  }
+
+  void rebuild_index(const Map &map) {
+    _index.clear();
+    if (!map.empty()) _index.resize(map.rbegin()->first + 1,NULL);
+    for (typename Map::const_iterator iter = map.begin();
+	 iter != map.end();
+	 ++iter) {
+      _index[iter->first] = iter->second;
+    }
+    _nindexed = map.size();
+  }
+
+  std::vector<T*> _index;  //< objects by id
+  size_t _nindexed;        //< objects of the map in _index
+  SvtxObjectPool<TV1> _pool;
+  unsigned long _nheap;    //< objects cloned on the heap
+};
+
+#endif
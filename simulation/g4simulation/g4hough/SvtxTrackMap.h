@@ -32,6 +32,7 @@ public:
   virtual const SvtxTrack* get(unsigned int idkey) const {return NULL;}
   virtual       SvtxTrack* get(unsigned int idkey) {return NULL;}
   virtual       SvtxTrack* insert(const SvtxTrack *cluster) {return NULL;}
+  virtual       SvtxTrack* insert_new() {return NULL;}
   virtual       size_t     erase(unsigned int idkey) {return 0;}
 
   virtual ConstIter begin()                   const {return TrackMap().end();}
@@ -29,6 +29,7 @@ public:
   const SvtxTrack* get(unsigned int idkey) const;
         SvtxTrack* get(unsigned int idkey); 
         SvtxTrack* insert(const SvtxTrack* track);
+        SvtxTrack* insert_new();
         size_t     erase(unsigned int idkey) {
 	  delete _map[idkey]; return _map.erase(idkey);
 	}
@@ -0,0 +1,75 @@
+#ifndef __SVTXTRACKMAP_V2_H__
+#define __SVTXTRACKMAP_V2_H__
+
+#include "SvtxTrackMap.h"
+#include "SvtxTrack.h"
+#include "SvtxTrack_v1.h"
+
+#ifndef __CINT__
+#include "SvtxPooledStorage.h"
+#endif
+
+#include <phool/PHObject.h>
+#include <map>
+#include <iostream>
+
+/// \class SvtxTrackMap_v2
+///
+/// Same content and iteration as SvtxTrackMap_v1, but the tracks made with
+/// insert_new() (or copied by insert() from a SvtxTrack_v1) live in an
+/// object pool which is recycled by Reset() instead of being deleted,
+/// and get() is a lookup in a vector indexed by the track id.
+/// The pool and the index are in SvtxPooledStorage, shared with the
+/// other v2 containers.
+///
+class SvtxTrackMap_v2 : public SvtxTrackMap {
+
+public:
+
+  SvtxTrackMap_v2();
+  SvtxTrackMap_v2(const SvtxTrackMap_v2& trackmap);
+  SvtxTrackMap_v2& operator=(const SvtxTrackMap_v2& trackmap);
+  virtual ~SvtxTrackMap_v2();
+
+  void identify(std::ostream& os = std::cout) const;
+  void Reset();
+  int  isValid() const {return 1;}
+  SvtxTrackMap* Clone() const {return new SvtxTrackMap_v2(*this);}
+
+  bool   empty()                   const {return _map.empty();}
+  size_t  size()                   const {return _map.size();}
+  size_t count(unsigned int idkey) const {return (get(idkey)) ? 1 : 0;}
+  void   clear()                         {Reset();}
+
+  const SvtxTrack* get(unsigned int idkey) const;
+        SvtxTrack* get(unsigned int idkey);
+        SvtxTrack* insert(const SvtxTrack *track);
+        SvtxTrack* insert_new();
+        size_t     erase(unsigned int idkey);
+
+  ConstIter begin()                   const {return _map.begin();}
+  ConstIter  find(unsigned int idkey) const {return _map.find(idkey);}
+  ConstIter   end()                   const {return _map.end();}
+
+  Iter begin()                   {return _map.begin();}
+  Iter  find(unsigned int idkey) {return _map.find(idkey);}
+  Iter   end()                   {return _map.end();}
+
+  // allocation counters
+  size_t        get_pool_capacity() const;
+  unsigned long get_n_pool_requested() const;
+  unsigned long get_n_pool_reused() const;
+  unsigned long get_n_heap_allocated() const;
+
+private:
+
+  TrackMap _map;
+
+#ifndef __CINT__
+  SvtxPooledStorage<SvtxTrack,SvtxTrack_v1> _storage; //!
+#endif
+
+  ClassDef(SvtxTrackMap_v2, 1);
+};
+
+#endif
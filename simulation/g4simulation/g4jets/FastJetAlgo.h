@@ -6,23 +6,40 @@
 #include "Jet.h"
 #include "JetAlgo.h"
 
+namespace fastjet {
+  class JetDefinition;
+}
+
 class FastJetAlgo : public JetAlgo {
   
 public:
 
   FastJetAlgo(Jet::ALGO algo, float par, float verbosity = 0);
-  virtual ~FastJetAlgo() {}
+  virtual ~FastJetAlgo();
 
   void      identify(std::ostream& os = std::cout);
   Jet::ALGO get_algo() {return _algo;}
   float     get_par() {return _par;}
   
   std::vector<Jet*> get_jets(std::vector<Jet*> particles);
+#ifndef __CINT__
+  std::vector<Jet*> get_jets(const std::vector<fastjet::PseudoJet>& pseudojets,
+			     const std::vector<Jet*>& particles,
+			     const std::vector<fastjet::PseudoJet>* ghosts,
+			     double ghost_area);
+#endif
   
 private:
+  FastJetAlgo(const FastJetAlgo&);
+  FastJetAlgo& operator=(const FastJetAlgo&);
+
   int _verbosity;
   Jet::ALGO _algo;
   float _par;
+#ifndef __CINT__
+  /// made once for all events, NULL for an algorithm fastjet does not run
+  fastjet::JetDefinition* _jetdef;
+#endif
   
 };
 
@@ -25,7 +25,7 @@ public:
     FHCAL_TOWER=11, FHCAL_CLUSTER=12,
   };
 
-  enum PROPERTY {prop_JetCharge = 1,prop_BFrac = 2};
+  enum PROPERTY {prop_JetCharge = 1,prop_BFrac = 2,prop_area = 3};
 
   Jet();
   virtual ~Jet() {}
@@ -4,6 +4,11 @@
 #include <phool/PHCompositeNode.h>
 #include "Jet.h"
 #include <cmath>
+#include <vector>
+
+namespace fastjet {
+  class PseudoJet;
+}
 
 class JetAlgo {
   
@@ -22,6 +27,18 @@ public:
     return std::vector<Jet*>();
   }
 
+#ifndef __CINT__
+  /// cluster pseudojets built once per event by JetReco, the user index
+  /// of a pseudojet is its particle index; with ghosts the jet areas are
+  /// filled from these ghosts of area ghost_area each
+  virtual std::vector<Jet*> get_jets(const std::vector<fastjet::PseudoJet>& pseudojets,
+				     const std::vector<Jet*>& particles,
+				     const std::vector<fastjet::PseudoJet>* ghosts,
+				     double ghost_area) {
+    return get_jets(particles);
+  }
+#endif
+
 protected:
   JetAlgo() {}
   
@@ -18,6 +18,15 @@
 // standard includes
 #include <vector>
 
+#ifndef __CINT__
+#include <fastjet/PseudoJet.hh>
+
+namespace SeamStress {
+  class Seamstress;
+  template <class TClass> class Pincushion;
+}
+#endif
+
 // forward declarations
 class PHCompositeNode;
 
@@ -50,17 +59,52 @@ class JetReco : public SubsysReco
 
   void set_algo_node(std::string algonode) {_algonode = algonode;}
   void set_input_node(std::string inputnode) {_inputnode = inputnode;}
+
+  /// number of threads running the algorithms (e.g. several radii) of
+  /// an event on the same input, default 1 runs them in order
+  void set_nthreads(unsigned int nthreads) {_nthreads = (nthreads > 0) ? nthreads : 1;}
+
+  /// fill the jet areas (Jet::prop_area) from ghosts up to |y| < ghost_maxrap,
+  /// the ghosts are made once at InitRun and shared by all algorithms and events
+  void set_jet_area(bool do_area, double ghost_maxrap = 2.0, double ghost_area = 0.01) {
+    _do_area = do_area;
+    _ghost_maxrap = ghost_maxrap;
+    _ghost_area = ghost_area;
+  }
   
  private:
 
   int CreateNodes(PHCompositeNode *topNode);
-  void FillJetNode(PHCompositeNode *topNode,int ialgo,std::vector<Jet*> jets);
+  void FillJetNode(PHCompositeNode *topNode,int ialgo,const std::vector<Jet*>& jets);
+
+  /// worker thread w runs algos w, w + _nthreads, ...
+  void RunAlgosThread(void *arg);
   
   std::vector<JetInput*>   _inputs;
   std::vector<JetAlgo*>    _algos;
   std::string _algonode;
   std::string _inputnode;
   std::vector<std::string> _outputs; 
+
+  unsigned int _nthreads;
+
+  bool _do_area;
+  double _ghost_maxrap;
+  double _ghost_area;
+
+  /// input particles of the event, owned, and their pseudojets
+  std::vector<Jet*> _particles;
+  /// jets of every algo of the event, ownership goes to the jet maps
+  std::vector<std::vector<Jet*> > _algo_jets;
+
+#ifndef __CINT__
+  std::vector<fastjet::PseudoJet> _pseudojets;
+  std::vector<fastjet::PseudoJet> _ghosts;
+  double _actual_ghost_area;
+
+  std::vector<SeamStress::Seamstress*> *_seamstresses;
+  SeamStress::Pincushion<JetReco> *_pins;
+#endif
 };
 
 #endif // __JETRECO_H__
@@ -8,6 +8,7 @@
 #include <phool/getClass.h>
 
 #include <phool/phool.h>
+#include <phool/PHRandomService.h>
 
 #include <TSystem.h>
 
@@ -72,6 +73,9 @@ PHG4HeadReco::process_event(PHCompositeNode *topNode)
 	}
     }
   evtheader->set_EvtSequence(evtseq);
+  // the modules after us draw their random numbers for this event number
+  PHRandomService *rndmsvc = PHRandomService::instance();
+  rndmsvc->SetEvent(rndmsvc->GetRun(), evtseq);
   if (verbosity > 0)
     {
       evtheader->identify();
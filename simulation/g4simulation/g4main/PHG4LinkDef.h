@@ -17,6 +17,7 @@
 #pragma link C++ class PHG4Reco-!;
 #pragma link C++ class PHG4SimpleEventGenerator-!;
 #pragma link C++ class PHG4PileupGenerator-!;
+#pragma link C++ class PHG4PileupHitMixer-!;
 #pragma link C++ class PHG4Subsystem-!;
 #pragma link C++ class PHG4TruthSubsystem-!;
 //#pragma link C++ class PHG4UIsession-!;
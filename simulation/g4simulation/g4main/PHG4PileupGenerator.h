@@ -6,6 +6,8 @@
 class SubsysReco;
 class PHCompositeNode;
 
+// pile-up primaries for Geant4 in every crossing of the time window,
+// see PHG4PileupHitMixer to overlay pre-simulated minimum-bias hits instead
 class PHG4PileupGenerator : public PHG4ParticleGeneratorBase {
 
 public:
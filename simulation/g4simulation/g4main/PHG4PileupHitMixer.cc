@@ -0,0 +1,236 @@
+#include "PHG4PileupHitMixer.h"
+
+#include "PHG4HitContainer.h"
+#include "PHG4Hit.h"
+#include "PHG4Hitv1.h"
+#include "PHG4HitDefs.h"
+
+#include <fun4all/Fun4AllReturnCodes.h>
+
+#include <phool/getClass.h>
+#include <phool/phooldefs.h>
+#include <phool/PHCompositeNode.h>
+#include <phool/PHNodeIOManager.h>
+#include <phool/PHNodeIterator.h>
+#include <phool/PHNodeReset.h>
+#include <phool/PHRandomService.h>
+
+#include <TBranch.h>
+
+#include <iostream>
+#include <map>
+
+using namespace std;
+
+PHG4PileupHitMixer::PHG4PileupHitMixer(const string &name)
+    : SubsysReco(name),
+      _library_file(),
+      _hit_nodes(),
+      _min_integration_time(-1000.0),
+      _max_integration_time(+1000.0),
+      _collision_rate(100.0),
+      _time_between_crossings(106.0),
+      _ave_coll_per_crossing(1.0), // recalculated
+      _min_crossing(0),            // recalculated
+      _max_crossing(0),            // recalculated
+      _block_size(100),
+      _block_reuse(10),
+      _library(NULL),
+      _library_top(NULL),
+      _library_entries(0),
+      _signal_hits(),
+      _block_hits(),
+      _block_offsets(),
+      _block_used(0),
+      _nevents(0),
+      _ncollisions(0),
+      _nhits(0),
+      _nblocks(0) {}
+
+PHG4PileupHitMixer::~PHG4PileupHitMixer() {
+  ClearBlock();
+  delete _library;
+  delete _library_top;
+}
+
+int PHG4PileupHitMixer::InitRun(PHCompositeNode *topNode) {
+
+  _ave_coll_per_crossing = _collision_rate * _time_between_crossings * 1000.0 * 1e-9;
+
+  _min_crossing = _min_integration_time / _time_between_crossings;
+  _max_crossing = _max_integration_time / _time_between_crossings;
+
+  if (!_library) {
+    _library = new PHNodeIOManager(_library_file, PHReadOnly);
+    if (!_library->isFunctional()) {
+      cout << PHWHERE << " could not open pile-up library " << _library_file << endl;
+      return Fun4AllReturnCodes::ABORTRUN;
+    }
+
+    // the library events are read into their own node tree
+    _library_top = new PHCompositeNode("PILEUPLIBRARY");
+    if (!_library->read(_library_top,0)) {
+      cout << PHWHERE << " could not read pile-up library " << _library_file << endl;
+      return Fun4AllReturnCodes::ABORTRUN;
+    }
+
+    // only read the G4HIT branches to mix
+    map<string,TBranch*> *branches = _library->GetBranchMap();
+    string delimeters = phooldefs::branchpathdelim + "/";
+    bool all_hit_nodes = _hit_nodes.empty();
+    _library->selectObjectToRead("*",false);
+    for (map<string,TBranch*>::const_iterator iter = branches->begin();
+	 iter != branches->end();
+	 ++iter) {
+      string nodename = iter->first.substr(iter->first.find_last_of(delimeters) + 1);
+      if (all_hit_nodes && nodename.compare(0,6,"G4HIT_") == 0) _hit_nodes.push_back(nodename);
+      _library_entries = iter->second->GetEntries();
+    }
+    for (unsigned int i = 0; i < _hit_nodes.size(); ++i) {
+      string pattern = "*" + _hit_nodes[i] + "*";
+      _library->selectObjectToRead(pattern.c_str(),true);
+    }
+
+    if (_library_entries == 0) {
+      cout << PHWHERE << " pile-up library " << _library_file << " is empty" << endl;
+      return Fun4AllReturnCodes::ABORTRUN;
+    }
+  }
+
+  _signal_hits.clear();
+  for (unsigned int i = 0; i < _hit_nodes.size(); ++i) {
+    PHG4HitContainer *hits = findNode::getClass<PHG4HitContainer>(topNode,_hit_nodes[i]);
+    if (!hits && verbosity > 0) {
+      cout << Name() << ": no " << _hit_nodes[i] << " in the signal event, not mixed" << endl;
+    }
+    _signal_hits.push_back(hits);
+  }
+
+  if (verbosity > 0) {
+    cout << "===================== PHG4PileupHitMixer::InitRun() ======================" << endl;
+    cout << " library " << _library_file << ", " << _library_entries << " events" << endl;
+    cout << " crossings " << _min_crossing << " to " << _max_crossing
+	 << ", " << _ave_coll_per_crossing << " collisions per crossing" << endl;
+    cout << " blocks of " << _block_size << " events, reused for " << _block_reuse << " events" << endl;
+    for (unsigned int i = 0; i < _hit_nodes.size(); ++i) cout << " mixing " << _hit_nodes[i] << endl;
+    cout << "===========================================================================" << endl;
+  }
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+int PHG4PileupHitMixer::process_event(PHCompositeNode *topNode) {
+
+  if (_block_offsets.empty() || _block_used >= _block_reuse) {
+    if (FetchBlock() != 0) return Fun4AllReturnCodes::ABORTRUN;
+  }
+  ++_block_used;
+  ++_nevents;
+
+  unsigned int nblock = _block_offsets.size() - 1;
+
+  // stream 0 for the collisions, the block reads use stream 1
+  PHPhiloxRandom rnd = PHRandomService::instance()->GetStream(Name(), 0);
+
+  for (int icrossing = _min_crossing; icrossing <= _max_crossing; ++icrossing) {
+
+    double crossing_time = _time_between_crossings * icrossing;
+
+    // the signal is one of the collisions of its crossing
+    int ncollisions = rnd.Poisson(_ave_coll_per_crossing);
+    if (icrossing == 0) --ncollisions;
+
+    for (int icollision = 0; icollision < ncollisions; ++icollision) {
+
+      unsigned int ievent = UniformInt(rnd,nblock);
+      for (unsigned int ihit = _block_offsets[ievent]; ihit < _block_offsets[ievent+1]; ++ihit) {
+	const LibraryHit &libhit = _block_hits[ihit];
+	PHG4HitContainer *hits = _signal_hits[libhit.node];
+	if (!hits) continue;
+
+	PHG4Hit *hit = new PHG4Hitv1(*libhit.hit);
+	hit->set_t(0,hit->get_t(0) + crossing_time);
+	hit->set_t(1,hit->get_t(1) + crossing_time);
+	// the pile-up particles are not in the truth container of this event
+	hit->set_trkid(0);
+	hits->AddHit(libhit.detid,hit);
+	++_nhits;
+      }
+      ++_ncollisions;
+    }
+  }
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+int PHG4PileupHitMixer::End(PHCompositeNode *topNode) {
+
+  if (verbosity > 0 && _nevents > 0) {
+    cout << Name() << ": " << _nevents << " events, "
+	 << (double) _ncollisions / _nevents << " pile-up collisions and "
+	 << (double) _nhits / _nevents << " hits per event from "
+	 << _nblocks << " library blocks" << endl;
+  }
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+int PHG4PileupHitMixer::FetchBlock() {
+
+  ClearBlock();
+
+  // random start, then consecutive events which the tree reads fastest
+  unsigned int nread = (_block_size < _library_entries) ? _block_size : _library_entries;
+  unsigned int first = 0;
+  if (_library_entries > nread) {
+    PHPhiloxRandom rnd = PHRandomService::instance()->GetStream(Name(), 1);
+    first = UniformInt(rnd,_library_entries - nread + 1);
+  }
+
+  PHNodeReset reset;
+  PHNodeIterator iter(_library_top);
+
+  _block_offsets.push_back(0);
+  for (unsigned int ievent = first; ievent < first + nread; ++ievent) {
+    iter.forEach(reset);
+    if (!_library->read(_library_top,ievent)) {
+      cout << PHWHERE << " could not read event " << ievent << " of " << _library_file << endl;
+      return -1;
+    }
+
+    for (unsigned int inode = 0; inode < _hit_nodes.size(); ++inode) {
+      PHG4HitContainer *libhits = findNode::getClass<PHG4HitContainer>(_library_top,_hit_nodes[inode]);
+      if (!libhits) continue;
+
+      PHG4HitContainer::ConstRange range = libhits->getHits();
+      for (PHG4HitContainer::ConstIterator hititer = range.first; hititer != range.second; ++hititer) {
+	LibraryHit libhit;
+	libhit.node = inode;
+	libhit.detid = hititer->first >> PHG4HitDefs::hit_idbits;
+	libhit.hit = new PHG4Hitv1(*hititer->second);
+	_block_hits.push_back(libhit);
+      }
+    }
+    _block_offsets.push_back(_block_hits.size());
+  }
+
+  _block_used = 0;
+  ++_nblocks;
+  if (verbosity > 1) {
+    cout << Name() << ": read library events " << first << " to " << first + nread - 1
+	 << ", " << _block_hits.size() << " hits" << endl;
+  }
+
+  return 0;
+}
+
+unsigned int PHG4PileupHitMixer::UniformInt(PHPhiloxRandom &rnd, const unsigned int n) {
+  unsigned int i = rnd.Uniform() * n;
+  return (i < n) ? i : n - 1;
+}
+
+void PHG4PileupHitMixer::ClearBlock() {
+  for (unsigned int i = 0; i < _block_hits.size(); ++i) delete _block_hits[i].hit;
+  _block_hits.clear();
+  _block_offsets.clear();
+}
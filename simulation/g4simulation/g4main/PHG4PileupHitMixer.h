@@ -0,0 +1,105 @@
+#ifndef PHG4PileupHitMixer_H__
+#define PHG4PileupHitMixer_H__
+
+#include <fun4all/SubsysReco.h>
+
+#include <string>
+#include <vector>
+
+class PHCompositeNode;
+class PHNodeIOManager;
+class PHG4Hit;
+class PHG4HitContainer;
+class PHPhiloxRandom;
+
+/// \class PHG4PileupHitMixer
+///
+/// Pile-up from a library DST of pre-simulated minimum-bias events
+/// instead of sending pile-up primaries through Geant4 (PHG4PileupGenerator).
+/// Register it after PHG4Reco: for every crossing in the time window a
+/// Poisson number of library events is drawn and their G4HITs are added
+/// to the G4HIT_* containers of the signal event, shifted in time by the
+/// crossing. The library is read in blocks of consecutive events from a
+/// random position; the events of a block are kept in memory and sampled
+/// for several signal events before the next block is read.
+/// The random numbers come from PHRandomService (module name Name()).
+///
+class PHG4PileupHitMixer : public SubsysReco {
+
+public:
+
+  PHG4PileupHitMixer(const std::string &name="PHG4PileupHitMixer");
+  virtual ~PHG4PileupHitMixer();
+
+  int InitRun(PHCompositeNode *topNode);
+  int process_event(PHCompositeNode *topNode);
+  int End(PHCompositeNode *topNode);
+
+  /// DST of minimum-bias events simulated with the same detector setup
+  void set_library_file(const std::string &filename) {_library_file = filename;}
+
+  /// G4HIT node to mix, e.g. "G4HIT_SVTX", all G4HIT_* nodes of the library if none is given
+  void add_hit_node(const std::string &nodename) {_hit_nodes.push_back(nodename);}
+
+  /// past times are negative, future times are positive
+  void set_time_window(double past_nsec,double future_nsec) {
+    _min_integration_time = past_nsec;
+    _max_integration_time = future_nsec;
+  }
+  void set_collision_rate(double kHz) {_collision_rate = kHz;}
+  void set_time_between_crossings(double nsec) {_time_between_crossings = nsec;}
+
+  /// library events read in one go, and signal events mixed with them before the next read
+  void set_prefetch(unsigned int block_size, unsigned int reuse_events) {
+    _block_size = (block_size > 0) ? block_size : 1;
+    _block_reuse = (reuse_events > 0) ? reuse_events : 1;
+  }
+
+private:
+
+  /// read the next block of library events into memory
+  int FetchBlock();
+  void ClearBlock();
+
+  /// uniform in [0,n)
+  static unsigned int UniformInt(PHPhiloxRandom &rnd, const unsigned int n);
+
+  std::string _library_file;
+  std::vector<std::string> _hit_nodes;
+
+  double _min_integration_time;
+  double _max_integration_time;
+  double _collision_rate;
+  double _time_between_crossings;
+
+  double   _ave_coll_per_crossing;
+  int      _min_crossing;
+  int      _max_crossing;
+
+  unsigned int _block_size;
+  unsigned int _block_reuse;
+
+  PHNodeIOManager *_library;
+  PHCompositeNode *_library_top;
+  unsigned int _library_entries;
+
+  /// signal containers, index as _hit_nodes
+  std::vector<PHG4HitContainer*> _signal_hits;
+
+  /// hits of the block, event i has hits _block_offsets[i] to _block_offsets[i+1]
+  struct LibraryHit {
+    unsigned int node;
+    unsigned int detid;
+    PHG4Hit *hit;
+  };
+  std::vector<LibraryHit> _block_hits;
+  std::vector<unsigned int> _block_offsets;
+  unsigned int _block_used;
+
+  unsigned long _nevents;
+  unsigned long _ncollisions;
+  unsigned long _nhits;
+  unsigned long _nblocks;
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "PHG4TruthEventAction.h"
+#include "PHG4TruthPruner.h"
 #include "PHG4Particlev2.h"
 
 #include "PHG4UserPrimaryParticleInformation.h"
@@ -29,11 +30,23 @@
 using namespace std;
 
 //___________________________________________________
-PHG4TruthEventAction::PHG4TruthEventAction( void ):
+PHG4TruthEventAction::PHG4TruthEventAction( PHG4TruthPruner* pruner ):
   truthInfoList_( 0 ),
   prev_existing_lower_key( 0 ),
-  prev_existing_upper_key( 0 )
-{}
+  prev_existing_upper_key( 0 ),
+  pruner_( pruner ),
+  own_pruner_( false )
+{
+  if ( !pruner_ ) {
+    pruner_ = new PHG4TruthPruner();
+    own_pruner_ = true;
+  }
+}
+
+//___________________________________________________
+PHG4TruthEventAction::~PHG4TruthEventAction( void ) {
+  if ( own_pruner_ ) delete pruner_;
+}
 
 //___________________________________________________
 void PHG4TruthEventAction::BeginOfEventAction(const G4Event* evt) {
@@ -60,107 +73,9 @@ void PHG4TruthEventAction::EndOfEventAction(const G4Event* evt) {
     return;
   }
 
-  // construct a list of track ids to preserve in the the output that includes any
-  // track designated in the writeList_ during processing or its ancestry chain
-  
-  std::set<G4int> savelist;
-  std::set<int> savevtxlist;
-   
-  for (std::set<G4int>::const_iterator write_iter = writeList_.begin();
-       write_iter != writeList_.end();
-       ++write_iter) {
-
-    std::vector<G4int> wrttracks;
-    std::vector<int> wrtvtx;
-    
-    // usertrackid
-    G4int mytrkid = *write_iter;
-    PHG4Particle *particle = truthInfoList_->GetParticle(mytrkid);
-
-    // if track is already in save list, nothing needs to be done
-    if (savelist.find(mytrkid) != savelist.end()) {
-      continue;
-    } else {
-      wrttracks.push_back(mytrkid);
-      wrtvtx.push_back(particle->get_vtx_id());
-    }
-
-    // now crawl up the truth info and add parents until we hit
-    // a track which is already being saved
-    G4int parentid = particle->get_parent_id();
-    while (savelist.find(parentid) == savelist.end() && parentid != 0) {
-      particle = truthInfoList_->GetParticle(parentid);
-      wrttracks.push_back(parentid);
-      wrtvtx.push_back(particle->get_vtx_id());
-      parentid = particle->get_parent_id();
-    }
-    
-    // now fill the new tracks into the save list
-    // while emptying the write lists
-    while (wrttracks.begin() != wrttracks.end()) {
-      savelist.insert(wrttracks.back());
-      wrttracks.pop_back();
-    }
-
-    while (wrtvtx.begin() != wrtvtx.end()) {
-      savevtxlist.insert(wrtvtx.back());
-      wrtvtx.pop_back();
-    }
-  }
-  
-  // the save lists are filled now, except primary track which never
-  // made it into any active volume and their vertex
-  
-  // loop over particles in truth list and remove them if they are not
-  // in the save list and are not primary particles (parent_id == 0)
-  
-  int removed[4] = {0};
-  PHG4TruthInfoContainer::Range truth_range = truthInfoList_->GetParticleRange();
-  PHG4TruthInfoContainer::Iterator truthiter = truth_range.first;
-  while (truthiter != truth_range.second) {
-    
-    removed[0]++;
-    int trackid = truthiter->first;
-    if (savelist.find(trackid) == savelist.end()) {
-      // track not in save list
-
-      // check if particle below offset 
-      // primary particles had parentid = 0
-      // for embedding: particles from initial sim do not have their keep flag set, we want to keep particles with trkid <= trackidoffset
-      // tracks from a previous geant pass will not be recorded as leaving
-      // hit in the sim, so we exclude this range from the removal
-      // for regular sims, that range is zero to zero
-      if (((trackid < prev_existing_lower_key)||(trackid > prev_existing_upper_key)) && ((truthiter->second)->get_parent_id() != 0)) {
-	truthInfoList_->delete_particle(truthiter++);
-	removed[1]++;
-      } else {
-	// save vertex id for primary particle which leaves no hit
-	// in active area
-	savevtxlist.insert((truthiter->second)->get_vtx_id());
-	++truthiter;
-      }
-      
-    } else {     
-      // track was in save list, move on
-      ++truthiter;
-    }
-  }
-  
-  PHG4TruthInfoContainer::VtxRange vtxrange = truthInfoList_->GetVtxRange();
-  PHG4TruthInfoContainer::VtxIterator vtxiter = vtxrange.first;
-  while (vtxiter != vtxrange.second)
-    {
-      removed[2]++;
-      if (savevtxlist.find(vtxiter->first) == savevtxlist.end())
-        {
-          truthInfoList_->delete_vtx(vtxiter++);
-          removed[3]++;
-        }
-      else
-        {
-          ++vtxiter;
-        }
-    }
+  // keep the tracks designated in the writeList_ during processing, their
+  // ancestry chain and the primaries, remove the rest
+  pruner_->Prune(truthInfoList_, writeList_, hitmap_, prev_existing_lower_key, prev_existing_upper_key);
 
   // loop over all input particles and fish out the ones which have the embed flag set
   // and store their geant track ids in truthinfo container
@@ -252,8 +167,7 @@ void PHG4TruthEventAction::PruneShowers() {
      	 jter != shower->end_g4particle_id();
      	 ++jter) {
       int g4particle_id = *jter;
-      PHG4Particle* particle = truthInfoList_->GetParticle(g4particle_id);
-      if (!particle) {
+      if (!pruner_->is_kept(g4particle_id)) {
 	remove_ids.insert(g4particle_id);
 	continue;
       }
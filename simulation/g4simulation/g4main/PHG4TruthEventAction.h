@@ -11,6 +11,7 @@
 
 class PHG4HitContainer;
 class PHG4TruthInfoContainer;
+class PHG4TruthPruner;
 class PHCompositeNode;
 
 class PHG4TruthEventAction: public PHG4EventAction
@@ -18,11 +19,11 @@ class PHG4TruthEventAction: public PHG4EventAction
 
 public:
 
-  //! constructor
-  PHG4TruthEventAction( void );
+  //! constructor, the pruner is owned by the caller, a default one is made if none is given
+  PHG4TruthEventAction( PHG4TruthPruner* pruner = NULL );
 
   //! destuctor
-  virtual ~PHG4TruthEventAction( void ) {}
+  virtual ~PHG4TruthEventAction( void );
 
   void BeginOfEventAction(const G4Event*);
 
@@ -52,6 +53,10 @@ public:
   int prev_existing_upper_key;
 
   std::map<int,PHG4HitContainer*> hitmap_;
+
+  //! decides which particles and vertices are kept
+  PHG4TruthPruner* pruner_;
+  bool own_pruner_;
 };
 
 
@@ -0,0 +1,260 @@
+#include "PHG4TruthPruner.h"
+
+#include "PHG4TruthInfoContainer.h"
+#include "PHG4Particle.h"
+#include "PHG4HitContainer.h"
+#include "PHG4Hit.h"
+#include "PHG4HitDefs.h"
+
+#include <phool/PHTimer.h>
+
+#include <iostream>
+
+using namespace std;
+
+//___________________________________________________
+PHG4TruthPruner::PHG4TruthPruner():
+  keep_primaries(true),
+  keep_hit_ancestors(true),
+  min_trackid(0),
+  max_trackid(-1),
+  verbosity(0),
+  timer(new PHTimer("PHG4TruthPruner")),
+  nevents(0),
+  nparticles_kept(0),
+  nparticles_dropped(0),
+  nvertices_kept(0),
+  nvertices_dropped(0)
+{}
+
+//___________________________________________________
+PHG4TruthPruner::~PHG4TruthPruner()
+{
+  delete timer;
+}
+
+//___________________________________________________
+void PHG4TruthPruner::SetEnergyThreshold(const std::string &hitnodename, const double edep)
+{
+  edep_thresholds[PHG4HitDefs::get_volume_id(hitnodename)] = edep;
+}
+
+//___________________________________________________
+void PHG4TruthPruner::Prune(PHG4TruthInfoContainer *truthinfo,
+			    const std::set<int> &writelist,
+			    const std::map<int,PHG4HitContainer*> &hitmap,
+			    const int prev_lower_key, const int prev_upper_key)
+{
+  timer->restart();
+
+  // parent array, indexed by track id
+  const PHG4TruthInfoContainer::Map &particles = truthinfo->GetMap();
+  unsigned int nparticles = particles.size();
+  unsigned int nvertices = truthinfo->GetVtxMap().size();
+  min_trackid = 0;
+  max_trackid = -1;
+  if (!particles.empty())
+    {
+      min_trackid = particles.begin()->first;
+      max_trackid = particles.rbegin()->first;
+    }
+  unsigned int ntracks = max_trackid - min_trackid + 1;
+  parent.assign(ntracks, 0);
+  keep.assign(ntracks, 0);
+  for (PHG4TruthInfoContainer::ConstIterator iter = particles.begin();
+       iter != particles.end();
+       ++iter)
+    {
+      int i = iter->first - min_trackid;
+      parent[i] = iter->second->get_parent_id();
+      if (keep_primaries && parent[i] == 0)
+	{
+	  keep[i] = 1;
+	}
+      // tracks from a previous geant pass (embedding) did not leave hits
+      // in this pass, for regular sims this range is zero to zero
+      if (iter->first >= prev_lower_key && iter->first <= prev_upper_key)
+	{
+	  keep[i] = 1;
+	}
+    }
+
+  // particles which left hits
+  if (keep_hit_ancestors)
+    {
+      if (!edep_thresholds.empty())
+	{
+	  apply_energy_thresholds(hitmap);
+	}
+      for (set<int>::const_iterator iter = writelist.begin();
+	   iter != writelist.end();
+	   ++iter)
+	{
+	  int i = index(*iter);
+	  if (i < 0)
+	    {
+	      continue;
+	    }
+	  if (edep_thresholds.empty() || has_unthresholded_hit[i] || passed_threshold[i])
+	    {
+	      keep[i] = 1;
+	    }
+	}
+    }
+
+  // daughters have smaller track ids than their parents, going up in track
+  // id every particle is visited after all its daughters
+  for (unsigned int i = 0; i < ntracks; i++)
+    {
+      if (!keep[i] || parent[i] == 0)
+	{
+	  continue;
+	}
+      int p = index(parent[i]);
+      if (p > (int) i)
+	{
+	  keep[p] = 1;
+	  continue;
+	}
+      // not in geant order, walk up the chain right away
+      while (p >= 0 && !keep[p])
+	{
+	  keep[p] = 1;
+	  p = (parent[p] == 0) ? -1 : index(parent[p]);
+	}
+    }
+
+  // remove the particles and flag the vertices of the ones kept
+  PHG4TruthInfoContainer::VtxRange vtxrange = truthinfo->GetVtxRange();
+  int min_vtxid = 0;
+  int max_vtxid = -1;
+  if (vtxrange.first != vtxrange.second)
+    {
+      min_vtxid = vtxrange.first->first;
+      max_vtxid = truthinfo->GetVtxMap().rbegin()->first;
+    }
+  keep_vtx.assign(max_vtxid - min_vtxid + 1, 0);
+
+  PHG4TruthInfoContainer::Range range = truthinfo->GetParticleRange();
+  PHG4TruthInfoContainer::Iterator iter = range.first;
+  while (iter != range.second)
+    {
+      if (!keep[iter->first - min_trackid])
+	{
+	  truthinfo->delete_particle(iter++);
+	  nparticles_dropped++;
+	  continue;
+	}
+      int vtxid = iter->second->get_vtx_id();
+      if (vtxid >= min_vtxid && vtxid <= max_vtxid)
+	{
+	  keep_vtx[vtxid - min_vtxid] = 1;
+	}
+      nparticles_kept++;
+      ++iter;
+    }
+
+  PHG4TruthInfoContainer::VtxIterator vtxiter = vtxrange.first;
+  while (vtxiter != vtxrange.second)
+    {
+      if (!keep_vtx[vtxiter->first - min_vtxid])
+	{
+	  truthinfo->delete_vtx(vtxiter++);
+	  nvertices_dropped++;
+	  continue;
+	}
+      nvertices_kept++;
+      ++vtxiter;
+    }
+
+  nevents++;
+  timer->stop();
+
+  if (verbosity > 1)
+    {
+      cout << "PHG4TruthPruner::Prune - " << particles.size() << " of " << nparticles
+	   << " particles and " << truthinfo->GetVtxMap().size() << " of " << nvertices
+	   << " vertices kept in " << timer->elapsed() << " ms" << endl;
+    }
+  return;
+}
+
+//___________________________________________________
+void PHG4TruthPruner::apply_energy_thresholds(const std::map<int,PHG4HitContainer*> &hitmap)
+{
+  unsigned int ntracks = parent.size();
+  has_unthresholded_hit.assign(ntracks, 0);
+  passed_threshold.assign(ntracks, 0);
+  edep_sum.assign(ntracks, 0.);
+
+  vector<int> touched;
+  for (map<int,PHG4HitContainer*>::const_iterator mapiter = hitmap.begin();
+       mapiter != hitmap.end();
+       ++mapiter)
+    {
+      map<int,double>::const_iterator threshold = edep_thresholds.find(mapiter->first);
+      PHG4HitContainer::ConstRange hitrange = mapiter->second->getHits();
+      for (PHG4HitContainer::ConstIterator hititer = hitrange.first;
+	   hititer != hitrange.second;
+	   ++hititer)
+	{
+	  int i = index(hititer->second->get_trkid());
+	  if (i < 0)
+	    {
+	      continue;
+	    }
+	  if (threshold == edep_thresholds.end())
+	    {
+	      has_unthresholded_hit[i] = 1;
+	      continue;
+	    }
+	  if (edep_sum[i] == 0.)
+	    {
+	      touched.push_back(i);
+	    }
+	  edep_sum[i] += hititer->second->get_edep();
+	}
+      // edep is summed per volume
+      for (vector<int>::const_iterator iter = touched.begin();
+	   iter != touched.end();
+	   ++iter)
+	{
+	  if (edep_sum[*iter] >= threshold->second)
+	    {
+	      passed_threshold[*iter] = 1;
+	    }
+	  edep_sum[*iter] = 0.;
+	}
+      touched.clear();
+    }
+  return;
+}
+
+//___________________________________________________
+bool PHG4TruthPruner::is_kept(const int trackid) const
+{
+  int i = index(trackid);
+  return (i >= 0 && keep[i]);
+}
+
+//___________________________________________________
+void PHG4TruthPruner::Print(const std::string &what) const
+{
+  cout << "PHG4TruthPruner: keep primaries: " << keep_primaries
+       << ", keep ancestors of hits: " << keep_hit_ancestors << endl;
+  for (map<int,double>::const_iterator iter = edep_thresholds.begin();
+       iter != edep_thresholds.end();
+       ++iter)
+    {
+      cout << "  edep threshold for g4hit container " << iter->first << ": " << iter->second << endl;
+    }
+  cout << "  " << nevents << " events, particles kept: " << nparticles_kept
+       << ", dropped: " << nparticles_dropped
+       << ", vertices kept: " << nvertices_kept
+       << ", dropped: " << nvertices_dropped << endl;
+  if (nevents > 0)
+    {
+      cout << "  time: " << timer->get_accumulated_time() / nevents << " ms per event" << endl;
+    }
+  return;
+}
@@ -0,0 +1,96 @@
+#ifndef PHG4TruthPruner_h
+#define PHG4TruthPruner_h
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+class PHG4HitContainer;
+class PHG4TruthInfoContainer;
+class PHTimer;
+
+//! decides which particles and vertices of the truth record are kept
+/*!
+  The parent of every particle is looked up once and stored in arrays
+  indexed by track id. Geant4 hands out the secondary track ids in
+  decreasing order when the track starts, so a parent always has a larger
+  id than its daughters and one pass in increasing track id order carries
+  the keep flag of every particle up to all its ancestors.
+  Keep policies:
+  - primaries: all primary particles (parent id 0) are kept (default on)
+  - ancestors of hits: particles flagged during tracking because they left
+    a hit, and their ancestors, are kept (default on)
+  - energy threshold per volume: a flagged particle whose hits are only in
+    volumes with a threshold is only kept if it deposited at least the
+    threshold in one of them. Its g4hits are not removed, their track id
+    then points to a particle which is not in the truth record
+  Particles of a previous geant pass (embedding) are never removed.
+*/
+class PHG4TruthPruner
+{
+
+ public:
+
+  PHG4TruthPruner();
+
+  virtual ~PHG4TruthPruner();
+
+  void KeepPrimaries(const bool b = true) {keep_primaries = b;}
+  void KeepAncestorsOfHits(const bool b = true) {keep_hit_ancestors = b;}
+
+  //! minimum edep of a particle in the g4hits of this node (e.g. G4HIT_CEMC)
+  void SetEnergyThreshold(const std::string &hitnodename, const double edep);
+
+  //! removes the particles and vertices which are not kept
+  /*!
+    writelist are the ids of the particles flagged during tracking,
+    ids between prev_lower_key and prev_upper_key existed before this geant pass
+  */
+  void Prune(PHG4TruthInfoContainer *truthinfo,
+	     const std::set<int> &writelist,
+	     const std::map<int,PHG4HitContainer*> &hitmap,
+	     const int prev_lower_key, const int prev_upper_key);
+
+  //! particle is in the truth record after the last Prune()
+  bool is_kept(const int trackid) const;
+
+  void Verbosity(const int i) {verbosity = i;}
+
+  void Print(const std::string &what = "ALL") const;
+
+ protected:
+
+  void apply_energy_thresholds(const std::map<int,PHG4HitContainer*> &hitmap);
+
+  int index(const int trackid) const
+  {return (trackid < min_trackid || trackid > max_trackid) ? -1 : trackid - min_trackid;}
+
+  bool keep_primaries;
+  bool keep_hit_ancestors;
+  //! g4hit container id -> edep threshold
+  std::map<int,double> edep_thresholds;
+
+  // arrays indexed by track id - min_trackid
+  int min_trackid;
+  int max_trackid;
+  std::vector<int> parent;
+  std::vector<char> keep;
+  std::vector<char> has_unthresholded_hit;
+  std::vector<char> passed_threshold;
+  std::vector<double> edep_sum;
+
+  // vertices are indexed by vertex id - min_vtxid
+  std::vector<char> keep_vtx;
+
+  int verbosity;
+  PHTimer *timer;
+  unsigned long long nevents;
+  unsigned long long nparticles_kept;
+  unsigned long long nparticles_dropped;
+  unsigned long long nvertices_kept;
+  unsigned long long nvertices_dropped;
+
+};
+
+#endif
@@ -2,7 +2,7 @@
 #include "PHG4TruthEventAction.h"
 #include "PHG4TruthSteppingAction.h"
 #include "PHG4TruthTrackingAction.h"
-
+#include "PHG4TruthPruner.h"
 
 #include "PHG4TruthInfoContainer.h"
 
@@ -29,9 +29,16 @@ PHG4TruthSubsystem::PHG4TruthSubsystem( const string &name ):
   eventAction_( NULL ),
   steppingAction_( NULL ),
   trackingAction_( NULL ),
+  pruner_( new PHG4TruthPruner() ),
   saveOnlyEmbeded_(false)
 {}
 
+//_______________________________________________________________________
+PHG4TruthSubsystem::~PHG4TruthSubsystem( void )
+{
+  delete pruner_;
+}
+
 //_______________________________________________________________________
 int PHG4TruthSubsystem::InitRun( PHCompositeNode* topNode )
 {
@@ -48,7 +55,8 @@ int PHG4TruthSubsystem::InitRun( PHCompositeNode* topNode )
     }
 
   // event action
-  eventAction_ = new PHG4TruthEventAction();
+  pruner_->Verbosity(Verbosity());
+  eventAction_ = new PHG4TruthEventAction(pruner_);
 
   // create stepping action
   //steppingAction_ = new PHG4TruthSteppingAction( eventAction_ );
@@ -150,6 +158,34 @@ PHG4TruthSubsystem::ResetEvent(PHCompositeNode *topNode)
   return 0;
 }
 
+int
+PHG4TruthSubsystem::End(PHCompositeNode *topNode)
+{
+  if (Verbosity() > 0)
+    {
+      pruner_->Print();
+    }
+  return 0;
+}
+
+void
+PHG4TruthSubsystem::KeepPrimaries(const bool b)
+{
+  pruner_->KeepPrimaries(b);
+}
+
+void
+PHG4TruthSubsystem::KeepAncestorsOfHits(const bool b)
+{
+  pruner_->KeepAncestorsOfHits(b);
+}
+
+void
+PHG4TruthSubsystem::SetKeepEnergyThreshold(const string &hitnodename, const double edep)
+{
+  pruner_->SetEnergyThreshold(hitnodename, edep);
+}
+
 //_______________________________________________________________________
 PHG4EventAction* PHG4TruthSubsystem::GetEventAction( void ) const
 { return eventAction_; }
@@ -7,6 +7,7 @@
 class PHG4TruthSteppingAction;
 class PHG4TruthTrackingAction;
 class PHG4TruthEventAction;
+class PHG4TruthPruner;
 
 class PHG4TruthSubsystem: public PHG4Subsystem
 {
@@ -17,8 +18,7 @@ class PHG4TruthSubsystem: public PHG4Subsystem
   PHG4TruthSubsystem( const std::string &name = "TRUTH" );
 
   //! destructor
-  virtual ~PHG4TruthSubsystem( void )
-  {}
+  virtual ~PHG4TruthSubsystem( void );
 
   //! init
   int InitRun(PHCompositeNode *);
@@ -32,6 +32,9 @@ class PHG4TruthSubsystem: public PHG4Subsystem
   //! Clean up after each event.
   int ResetEvent(PHCompositeNode *);
 
+  //! end of run, prints the pruning summary
+  int End(PHCompositeNode *);
+
   //! accessors (reimplemented)
   virtual PHG4EventAction* GetEventAction( void ) const;
   virtual PHG4SteppingAction* GetSteppingAction( void ) const;
@@ -40,11 +43,22 @@ class PHG4TruthSubsystem: public PHG4Subsystem
   //! only save the G4 truth information that is associated with the embedded particle
   void SetSaveOnlyEmbeded(bool b = true){saveOnlyEmbeded_ = b;};
 
+  //! keep all primary particles, also the ones which left no hit (default)
+  void KeepPrimaries(const bool b = true);
+
+  //! keep the particles which left hits and their ancestors (default)
+  void KeepAncestorsOfHits(const bool b = true);
+
+  //! particles whose g4hits are only in volumes with a threshold are kept
+  //! if they deposited at least edep in one of them, e.g. ("G4HIT_CEMC", 0.001)
+  void SetKeepEnergyThreshold(const std::string &hitnodename, const double edep);
+
   private:
 
   PHG4TruthEventAction* eventAction_;
   PHG4TruthSteppingAction* steppingAction_;
   PHG4TruthTrackingAction* trackingAction_;
+  PHG4TruthPruner* pruner_;
 
   //! only save the G4 truth information that is associated with the embedded particle
   bool saveOnlyEmbeded_;
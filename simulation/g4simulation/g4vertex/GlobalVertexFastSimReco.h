@@ -8,10 +8,6 @@
 //===========================================================
 
 #include <fun4all/SubsysReco.h>
-// rootcint barfs with this header so we need to hide it
-#ifndef __CINT__
-#include <gsl/gsl_rng.h>
-#endif
 
 class PHCompositeNode;
 
@@ -44,10 +40,6 @@ class GlobalVertexFastSimReco : public SubsysReco {
   float _y_smear;
   float _z_smear;
   float _t_smear;
-#ifndef __CINT__
-  gsl_rng *RandomGenerator;
-#endif
-
 };
 
 #endif // __GLOBALVERTEXFASTSIMRECO_H__
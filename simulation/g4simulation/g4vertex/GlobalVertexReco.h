@@ -13,6 +13,8 @@
 #include <phool/PHTimeServer.h>
 
 class PHCompositeNode;
+class SvtxVertex;
+class BbcVertex;
 
 /// \class GlobalVertexReco
 ///
@@ -34,13 +36,36 @@ class GlobalVertexReco : public SubsysReco {
   void set_y_defaults(float ydefault, float yerr) {_ydefault = ydefault; _yerr = yerr;}
   void set_t_defaults(float tdefault, float terr) {_tdefault = tdefault; _terr = terr;}
 
+  /// how SVTX vertexes are matched to BBC vertexes in z
+  enum MatchMetric {SIGMA, DISTANCE};
+
+  /// SIGMA: |dz| over the combined z error below cut (default 3),
+  /// DISTANCE: |dz| below cut in cm
+  void set_match_metric(MatchMetric metric, float cut) {_match_metric = metric; _match_cut = cut;}
+
  private:
 
   int CreateNodes(PHCompositeNode *topNode);
 
+  /// matching metric of a SVTX vertex to a BBC vertex, smaller is better
+  float match_metric(const SvtxVertex *svtx, const BbcVertex *bbc) const;
+
+  /// largest |dz| that can pass the cut for this SVTX vertex
+  float match_window(const SvtxVertex *svtx, float max_bbc_z_err) const;
+
   float _xdefault, _xerr;
   float _ydefault, _yerr;
   float _tdefault, _terr;
+
+  MatchMetric _match_metric;
+  float _match_cut;
+
+  unsigned long _nevents;
+  unsigned long _nsvtx;
+  unsigned long _nbbc;
+  unsigned long _nmatched;
+
+  PHTimeServer::timer _timer;
 };
 
 #endif // __GLOBALVERTEXRECO_H__